@@ -5,32 +5,33 @@
 //#include "Engine/StaticMeshActor.h"
 //#include "Galaga_USFXProjectile.h"
 #include "Galaga_USFXProjectile.h"
+#include "Galaga_USFXPawn.h"
+#include "BulletFieldSubsystem.h"
+#include "ProjectilePool.h"
+#include "EscudoComponent.h"
+#include "Engine/World.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 
 // Sets default values
 ABomba::ABomba()
 {
+	// La espoleta se cuenta en Tick
+	PrimaryActorTick.bCanEverTick = true;
 
-	static ConstructorHelpers::FObjectFinder<UStaticMesh> BallMesh(TEXT("StaticMesh'/Game/Content/Meshes/BulletLevel1.BulletLevel1'"));
 	Bombamalla = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("StaticMesh'/Game/Content/Meshes/BulletLevel1.BulletLevel1'"));
-	Bombamalla->BodyInstance.SetCollisionProfileName("Projectile");
 	RootComponent = Bombamalla;
-	Bombamalla->SetStaticMesh(BallMesh.Object);
-	Bombamalla->SetRelativeScale3D(FVector(2.5f, 2.5f, 2.5f));
 	Bombamalla->SetupAttachment(RootComponent);
 
 	//Bombamalla->SetCollisionProfileName(UCollisionProfile::Pawn_ProfileName);
 
 	ProjectileMovementComponent = CreateDefaultSubobject<UProjectileMovementComponent>(TEXT("ProjectileMovementComponent"));
 	ProjectileMovementComponent->UpdatedComponent = Bombamalla;
-	ProjectileMovementComponent->InitialSpeed = 3000.0f;
-	ProjectileMovementComponent->MaxSpeed = 3000.0f;
 	ProjectileMovementComponent->bRotationFollowsVelocity = true;
 	ProjectileMovementComponent->bShouldBounce = false;
 	ProjectileMovementComponent->bShouldBounce = true;
 	//ProjectileMovementComponent->Bounciness = 0.6f;  // Ajusta la cantidad de energa que se conserva despus de un rebote
-	Damage = 10;
-	InitialLifeSpan = 3.0f;
+	Espoleta = 0.0f;
+	Edad = 0.0f;
 
 }
 
@@ -38,7 +39,18 @@ ABomba::ABomba()
 void ABomba::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	// Los mismos parametros que las bombas del campo de balas
+	if (UProjectileArchetypeSubsystem* Arquetipos = GetWorld()->GetSubsystem<UProjectileArchetypeSubsystem>())
+	{
+		Arquetipo = Arquetipos->FindHandle(TEXT("Bomba"));
+		Arquetipos->Aplicar(Arquetipo, this);
+		if (Arquetipo.IsValid())
+		{
+			Damage = Arquetipos->Get(Arquetipo).Dano;
+			Espoleta = Arquetipos->Get(Arquetipo).Espoleta;
+		}
+	}
 }
 
 // Called every frame
@@ -46,6 +58,29 @@ void ABomba::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+	Edad += DeltaTime;
+	if (Espoleta > 0.0f && Edad >= Espoleta)
+	{
+		RadioExplosion();
+		Destruirse();
+	}
+}
+
+void ABomba::NotifyHit(UPrimitiveComponent* MyComp, AActor* Other, UPrimitiveComponent* OtherComp, bool bSelfMoved, FVector HitLocation, FVector HitNormal, FVector NormalImpulse, const FHitResult& Hit)
+{
+	// El escudo la absorbe entera, sin explosion que alcance a la nave
+	if (UEscudoComponent::AbsorberImpacto(OtherComp, Damage))
+	{
+		Destruirse();
+		return;
+	}
+
+	// Al chocar con el jugador explota ahi mismo; el dano lo pone la explosion
+	if (Cast<AGalaga_USFXPawn>(Other))
+	{
+		RadioExplosion();
+		Destruirse();
+	}
 }
 
 void ABomba::TipoBomba(int tipo)
@@ -54,6 +89,10 @@ void ABomba::TipoBomba(int tipo)
 
 void ABomba::RadioExplosion()
 {
+	if (UBulletFieldSubsystem* Campo = GetWorld()->GetSubsystem<UBulletFieldSubsystem>())
+	{
+		Campo->Detonar(Arquetipo, GetActorLocation(), EBulletOwner::Enemigo);
+	}
 }
 
 void ABomba::Movimiento()
@@ -64,6 +103,9 @@ void ABomba::Movimiento()
 
 void ABomba::Destruirse()
 {
+	// El pool reutiliza el actor, la espoleta empieza de nuevo en el proximo disparo
+	Edad = 0.0f;
+	UProjectilePoolSubsystem::ReleaseOrDestroy(this);
 }
 
 void ABomba::FireInDirection(FVector& ShootDirection)
@@ -4,6 +4,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "GameFramework/ProjectileMovementComponent.h"
+#include "ProjectileArchetype.h"
 #include "Bomba.generated.h"
 UCLASS()
 class GALAGA_USFX_API ABomba : public AActor
@@ -21,6 +22,11 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Damage")
 	float Damage;
 
+	// Arquetipo "Bomba": radio, espoleta y dano de la explosion
+	FProjectileArchetypeHandle Arquetipo;
+	float Espoleta;
+	float Edad;
+
 	
 public:	
 	// Sets default values for this actor's properties
@@ -33,9 +39,12 @@ protected:
 public:	
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
+	virtual void NotifyHit(class UPrimitiveComponent* MyComp, AActor* Other, UPrimitiveComponent* OtherComp, bool bSelfMoved,
+		FVector HitLocation, FVector HitNormal, FVector NormalImpulse, const FHitResult& Hit) override;
 	float velocidadBomba = 1000.0f;
 public:
 	void TipoBomba(int tipo);
+	// Pide la explosion al campo de balas, que la resuelve en lote con las demas del cuadro
 	void RadioExplosion();
 	void Movimiento();
 	void Destruirse();
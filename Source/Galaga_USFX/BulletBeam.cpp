@@ -0,0 +1,217 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BulletBeam.h"
+#include "Galaga_USFX.h"
+#include "BulletKernel.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+
+void FBulletBeams::SetNumTipos(int32 NumTipos)
+{
+	Ancho.SetNumZeroed(NumTipos);
+	Largo.SetNumZeroed(NumTipos);
+	DanoPorSegundo.SetNumZeroed(NumTipos);
+	Duracion.SetNumZeroed(NumTipos);
+	ExtensionMalla.Init(FVector(50.0f), NumTipos);
+}
+
+void FBulletBeams::SetTipo(int32 Tipo, float InAncho, float InLargo, float InDanoPorSegundo, float InDuracion, const FVector& InExtensionMalla)
+{
+	if (!Ancho.IsValidIndex(Tipo))
+	{
+		return;
+	}
+
+	Ancho[Tipo] = FMath::Max(InAncho, 1.0f);
+	Largo[Tipo] = FMath::Max(InLargo, 0.0f);
+	DanoPorSegundo[Tipo] = InDanoPorSegundo;
+	Duracion[Tipo] = InDuracion;
+	ExtensionMalla[Tipo] = InExtensionMalla.ComponentMax(FVector(1.0f));
+}
+
+void FBulletBeams::Lanzar(AActor* Fuente, const FVector& Offset, const FVector& Direccion, uint8 Tipo, uint8 Dueno)
+{
+	if (Fuente == nullptr || !Duracion.IsValidIndex(Tipo) || Duracion[Tipo] <= 0.0f)
+	{
+		return;
+	}
+
+	// Una nave tiene a lo sumo un rayo: volver a disparar lo renueva
+	for (FRayo& Rayo : Rayos)
+	{
+		if (Rayo.Fuente.Get() == Fuente)
+		{
+			Rayo.Offset = Offset;
+			Rayo.Direccion = Direccion.GetSafeNormal2D();
+			Rayo.Restante = Duracion[Tipo];
+			Rayo.Tipo = Tipo;
+			return;
+		}
+	}
+
+	FRayo& Rayo = Rayos.AddDefaulted_GetRef();
+	Rayo.Fuente = Fuente;
+	Rayo.Offset = Offset;
+	Rayo.Direccion = Direccion.GetSafeNormal2D();
+	Rayo.Origen = Fuente->GetActorLocation() + Offset;
+	Rayo.Restante = Duracion[Tipo];
+	Rayo.LargoActual = 0.0f;
+	Rayo.Tipo = Tipo;
+	Rayo.Dueno = Dueno;
+}
+
+void FBulletBeams::Cortar(const AActor* Fuente)
+{
+	Rayos.RemoveAllSwap([Fuente](const FRayo& Rayo) { return Rayo.Fuente.Get() == Fuente; });
+}
+
+int32 FBulletBeams::Trazar(const FSpatialGrid& Objetivos, const TArray<float>& Radios, const TArray<uint8>& Equipos, float DeltaTime, TArray<float>& OutDanoPorObjetivo)
+{
+	OutDanoPorObjetivo.Reset();
+	OutDanoPorObjetivo.SetNumZeroed(Objetivos.Num());
+
+	// Se termina el rayo cuando vence o cuando su nave ya no existe
+	Rayos.RemoveAllSwap([DeltaTime](FRayo& Rayo)
+	{
+		Rayo.Restante -= DeltaTime;
+		return Rayo.Restante <= 0.0f || !Rayo.Fuente.IsValid();
+	});
+
+	float RadioMaximo = 0.0f;
+	for (float Radio : Radios)
+	{
+		RadioMaximo = FMath::Max(RadioMaximo, Radio);
+	}
+
+	for (FRayo& Rayo : Rayos)
+	{
+		Rayo.Origen = Rayo.Fuente->GetActorLocation() + Rayo.Offset;
+
+		int32 Objetivo = INDEX_NONE;
+		Rayo.LargoActual = TrazarSegmento(Rayo.Origen, Rayo.Direccion, Largo[Rayo.Tipo], Ancho[Rayo.Tipo] * 0.5f, RadioMaximo,
+			Objetivos, Radios, Equipos, Rayo.Dueno, Candidatos, Objetivo);
+
+		// El dano es continuo: solo el objetivo que bloquea el rayo lo recibe
+		if (Objetivo != INDEX_NONE)
+		{
+			OutDanoPorObjetivo[Objetivo] += DanoPorSegundo[Rayo.Tipo] * DeltaTime;
+		}
+	}
+	return Rayos.Num();
+}
+
+float FBulletBeams::TrazarSegmento(const FVector& Origen, const FVector& Direccion, float Largo, float MedioAncho, float RadioMaximo,
+	const FSpatialGrid& Objetivos, const TArray<float>& Radios, const TArray<uint8>& Equipos, uint8 Dueno,
+	TArray<int32>& Candidatos, int32& OutObjetivo)
+{
+	OutObjetivo = INDEX_NONE;
+
+	Candidatos.Reset();
+	Objetivos.BuscarEnSegmento(Origen, Origen + Direccion * Largo, MedioAncho + RadioMaximo, Candidatos);
+
+	float Mejor = Largo;
+	const FVector2D Direccion2D(Direccion.X, Direccion.Y);
+	for (int32 Candidato : Candidatos)
+	{
+		if (Equipos[Candidato] == Dueno)
+		{
+			continue;
+		}
+
+		// Interseccion del rayo ensanchado con el circulo del objetivo
+		const FVector& Posicion = Objetivos.GetPosicion(Candidato);
+		const FVector2D Relativa(Posicion.X - Origen.X, Posicion.Y - Origen.Y);
+		const float Proyeccion = Relativa | Direccion2D;
+		const float Radio = MedioAncho + Radios[Candidato];
+		const float Perpendicular2 = Relativa.SizeSquared() - Proyeccion * Proyeccion;
+		if (Perpendicular2 > Radio * Radio)
+		{
+			continue;
+		}
+
+		const float MedioTramo = FMath::Sqrt(Radio * Radio - Perpendicular2);
+		if (Proyeccion + MedioTramo < 0.0f)
+		{
+			continue;
+		}
+
+		const float Entrada = FMath::Max(Proyeccion - MedioTramo, 0.0f);
+		if (Entrada < Mejor)
+		{
+			Mejor = Entrada;
+			OutObjetivo = Candidato;
+		}
+	}
+	return Mejor;
+}
+
+void FBulletBeams::AgregarTransforms(TArray<TArray<FTransform>>& TransformsPorTipo) const
+{
+	for (const FRayo& Rayo : Rayos)
+	{
+		if (Rayo.LargoActual <= 0.0f || !TransformsPorTipo.IsValidIndex(Rayo.Tipo))
+		{
+			continue;
+		}
+
+		// La malla se estira en X hasta el largo del rayo y en Y/Z hasta su ancho, centrada en el tramo
+		const FVector& Extension = ExtensionMalla[Rayo.Tipo];
+		const float AnchoRayo = Ancho[Rayo.Tipo];
+		const FVector Escala(Rayo.LargoActual / (2.0f * Extension.X), AnchoRayo / (2.0f * Extension.Y), AnchoRayo / (2.0f * Extension.Z));
+		TransformsPorTipo[Rayo.Tipo].Emplace(Rayo.Direccion.ToOrientationQuat(), Rayo.Origen + Rayo.Direccion * (Rayo.LargoActual * 0.5f), Escala);
+	}
+}
+
+// Galaga.Beam.Bench [Rayos] [Cuadros]: costo de trazar todos los rayos del cuadro contra la rejilla
+static void BenchRayos(const TArray<FString>& Args)
+{
+	const int32 Cantidad = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 64;
+	const int32 Cuadros = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 600;
+
+	FRandomStream Azar(1234);
+	TArray<FVector> Posiciones;
+	TArray<float> Radios;
+	TArray<uint8> Equipos;
+	for (int32 i = 0; i < 31; ++i)
+	{
+		Posiciones.Add(FVector(Azar.FRandRange(-1500.0f, 1500.0f), Azar.FRandRange(-1500.0f, 1500.0f), 200.0f));
+		Radios.Add(60.0f);
+		Equipos.Add(i == 0 ? 1 : 0);
+	}
+
+	FSpatialGrid Objetivos;
+	Objetivos.Configurar(FBulletKernel::LimiteCampo, 200.0f);
+	Objetivos.Construir(Posiciones);
+
+	TArray<FVector> Origenes;
+	TArray<FVector> Direcciones;
+	for (int32 i = 0; i < Cantidad; ++i)
+	{
+		Origenes.Add(FVector(Azar.FRandRange(-1600.0f, 1600.0f), Azar.FRandRange(-1600.0f, 1600.0f), 200.0f));
+		Direcciones.Add(FVector(Azar.FRandRange(-1.0f, 1.0f), Azar.FRandRange(-1.0f, 1.0f), 0.0f).GetSafeNormal());
+	}
+
+	TArray<int32> Candidatos;
+	int32 Bloqueados = 0;
+	const double Inicio = FPlatformTime::Seconds();
+	for (int32 Cuadro = 0; Cuadro < Cuadros; ++Cuadro)
+	{
+		for (int32 i = 0; i < Cantidad; ++i)
+		{
+			int32 Objetivo = INDEX_NONE;
+			FBulletBeams::TrazarSegmento(Origenes[i], Direcciones[i], 2400.0f, 10.0f, 60.0f, Objetivos, Radios, Equipos, 0, Candidatos, Objetivo);
+			Bloqueados += Objetivo != INDEX_NONE;
+		}
+	}
+	const double Total = FPlatformTime::Seconds() - Inicio;
+
+	UE_LOG(LogGalaga_USFX, Display, TEXT("Beam bench: %d rayos, %.1f bloqueados por cuadro, %.4f ms por cuadro"),
+		Cantidad, (float)Bloqueados / FMath::Max(Cuadros, 1), Total * 1000.0 / FMath::Max(Cuadros, 1));
+}
+
+static FAutoConsoleCommand CmdBenchRayos(
+	TEXT("Galaga.Beam.Bench"),
+	TEXT("Galaga.Beam.Bench [Rayos=64] [Cuadros=600]: costo de trazar los rayos del cuadro contra la rejilla de objetivos"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchRayos));
@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SpatialGrid.h"
+
+class AActor;
+
+/**
+ * Rayos continuos del campo de balas (el laser de ANaveEnemigaCaza). Un rayo sale de la
+ * nave que lo disparo, la sigue mientras dure y llega hasta el primer objetivo del equipo
+ * contrario que lo bloquea, o hasta su largo maximo. Cada cuadro todos los rayos activos
+ * se trazan juntos como segmentos contra la FSpatialGrid de objetivos, sin trazas de fisica.
+ */
+struct GALAGA_USFX_API FBulletBeams
+{
+	void SetNumTipos(int32 NumTipos);
+	void SetTipo(int32 Tipo, float InAncho, float InLargo, float InDanoPorSegundo, float InDuracion, const FVector& InExtensionMalla);
+
+	void Lanzar(AActor* Fuente, const FVector& Offset, const FVector& Direccion, uint8 Tipo, uint8 Dueno);
+
+	// Apaga el rayo de Fuente antes de que venza
+	void Cortar(const AActor* Fuente);
+
+	FORCEINLINE int32 Num() const { return Rayos.Num(); }
+
+	// Mueve los rayos con su nave, los traza en lote y suma en OutDanoPorObjetivo el dano del cuadro.
+	// Radios y Equipos son los de cada punto de la rejilla. Devuelve cuantos rayos se trazaron
+	int32 Trazar(const FSpatialGrid& Objetivos, const TArray<float>& Radios, const TArray<uint8>& Equipos, float DeltaTime, TArray<float>& OutDanoPorObjetivo);
+
+	// Largo hasta el primer objetivo que bloquea el segmento (Largo si no hay ninguno); OutObjetivo queda en INDEX_NONE sin bloqueo
+	static float TrazarSegmento(const FVector& Origen, const FVector& Direccion, float Largo, float MedioAncho, float RadioMaximo,
+		const FSpatialGrid& Objetivos, const TArray<float>& Radios, const TArray<uint8>& Equipos, uint8 Dueno,
+		TArray<int32>& Candidatos, int32& OutObjetivo);
+
+	// Una instancia por rayo: la malla del arquetipo estirada desde el origen hasta el impacto
+	void AgregarTransforms(TArray<TArray<FTransform>>& TransformsPorTipo) const;
+
+private:
+	struct FRayo
+	{
+		TWeakObjectPtr<AActor> Fuente;
+		FVector Offset;
+		FVector Direccion;
+		FVector Origen;
+		float Restante;
+		float LargoActual;
+		uint8 Tipo;
+		uint8 Dueno;
+	};
+
+	TArray<FRayo> Rayos;
+
+	TArray<float> Ancho;
+	TArray<float> Largo;
+	TArray<float> DanoPorSegundo;
+	TArray<float> Duracion;
+	TArray<FVector> ExtensionMalla;
+
+	TArray<int32> Candidatos;
+};
@@ -0,0 +1,232 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BulletCancel.h"
+#include "BulletFieldSubsystem.h"
+#include "Galaga_USFX.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+
+void FBulletCancel::SetNumTipos(int32 NumTipos)
+{
+	CancelaTipo.SetNumZeroed(NumTipos);
+	NumCanceladoras = 0;
+}
+
+void FBulletCancel::SetTipo(int32 Tipo, bool bCancela)
+{
+	if (!CancelaTipo.IsValidIndex(Tipo))
+	{
+		return;
+	}
+
+	NumCanceladoras += (int32)bCancela - (int32)(CancelaTipo[Tipo] != 0);
+	CancelaTipo[Tipo] = bCancela;
+}
+
+bool FBulletCancel::SeTocan(const FBulletSoA& Balas, int32 A, int32 B, float RadioA, float RadioB, float DeltaTime)
+{
+	// Una contra otra se acercan al doble de velocidad: sin barrido se atraviesan a pocos FPS
+	const FVector Ahora = Balas.GetPosicion(A) - Balas.GetPosicion(B);
+	const FVector Antes = Ahora - (Balas.GetVelocidad(A) - Balas.GetVelocidad(B)) * DeltaTime;
+	return UBulletFieldSubsystem::TiempoDeImpacto(Antes, Ahora, RadioA + RadioB) >= 0.0f;
+}
+
+int32 FBulletCancel::Cancelar(FBulletSoA& Balas, const float* RadioPorTipo, float DeltaTime, uint8 DuenoCancela)
+{
+	Propias.Reset();
+	Contrarias.Reset();
+	for (int32 i = 0; i < Balas.Num(); ++i)
+	{
+		const bool bPropia = Balas.Dueno[i] == DuenoCancela;
+		if (bPropia && !Cancela(Balas, i, DuenoCancela))
+		{
+			continue;
+		}
+
+		// El intervalo cubre desde donde estaba la bala al empezar el cuadro hasta donde quedo
+		const float Radio = RadioPorTipo[Balas.Tipo[i]];
+		const float Y = Balas.PosY[i];
+		const float YAnterior = Y - Balas.VelY[i] * DeltaTime;
+		FIntervalo Intervalo = { FMath::Min(Y, YAnterior) - Radio, FMath::Max(Y, YAnterior) + Radio, i };
+		(bPropia ? Propias : Contrarias).Add(Intervalo);
+	}
+
+	if (Propias.Num() == 0 || Contrarias.Num() == 0)
+	{
+		return 0;
+	}
+
+	auto PorMin = [](const FIntervalo& A, const FIntervalo& B) { return A.Min < B.Min; };
+	Propias.Sort(PorMin);
+	Contrarias.Sort(PorMin);
+
+	Cancelada.Reset();
+	Cancelada.SetNumZeroed(Balas.Num());
+	ActivasPropias.Reset();
+	ActivasContrarias.Reset();
+	Parejas = 0;
+
+	// Se recorren las dos listas juntas en orden de Min; cada intervalo nuevo solo se prueba
+	// contra los activos del otro lado, que son los unicos que pueden solaparlo
+	int32 p = 0;
+	int32 c = 0;
+	while (p < Propias.Num() && c < Contrarias.Num())
+	{
+		if (Propias[p].Min <= Contrarias[c].Min)
+		{
+			const FIntervalo& Nueva = Propias[p++];
+			if (!Barrer(Balas, RadioPorTipo, DeltaTime, Nueva, ActivasContrarias))
+			{
+				ActivasPropias.Add(Nueva);
+			}
+		}
+		else
+		{
+			const FIntervalo& Nueva = Contrarias[c++];
+			if (!Barrer(Balas, RadioPorTipo, DeltaTime, Nueva, ActivasPropias))
+			{
+				ActivasContrarias.Add(Nueva);
+			}
+		}
+	}
+	// Los que quedan en una sola lista todavia pueden tocar a los activos de la otra
+	while (p < Propias.Num())
+	{
+		Barrer(Balas, RadioPorTipo, DeltaTime, Propias[p++], ActivasContrarias);
+	}
+	while (c < Contrarias.Num())
+	{
+		Barrer(Balas, RadioPorTipo, DeltaTime, Contrarias[c++], ActivasPropias);
+	}
+
+	if (Parejas > 0)
+	{
+		Compactar(Balas);
+	}
+	return Parejas;
+}
+
+bool FBulletCancel::Barrer(const FBulletSoA& Balas, const float* RadioPorTipo, float DeltaTime, const FIntervalo& Nueva, TArray<FIntervalo>& Activos)
+{
+	const float RadioNueva = RadioPorTipo[Balas.Tipo[Nueva.Bala]];
+	for (int32 a = Activos.Num() - 1; a >= 0; --a)
+	{
+		const FIntervalo& Activo = Activos[a];
+
+		// Los Min llegan en orden, asi que un activo que termina antes de Nueva ya no toca a nadie mas
+		if (Activo.Max < Nueva.Min || Cancelada[Activo.Bala])
+		{
+			Activos.RemoveAtSwap(a, 1, false);
+			continue;
+		}
+
+		if (SeTocan(Balas, Nueva.Bala, Activo.Bala, RadioNueva, RadioPorTipo[Balas.Tipo[Activo.Bala]], DeltaTime))
+		{
+			Cancelada[Nueva.Bala] = 1;
+			Cancelada[Activo.Bala] = 1;
+			Activos.RemoveAtSwap(a, 1, false);
+			++Parejas;
+			return true;
+		}
+	}
+	return false;
+}
+
+void FBulletCancel::Compactar(FBulletSoA& Balas)
+{
+	int32 Quedan = 0;
+	for (int32 i = 0; i < Balas.Num(); ++i)
+	{
+		if (!Cancelada[i])
+		{
+			Balas.Copiar(i, Quedan++);
+		}
+	}
+	Balas.Truncar(Quedan);
+}
+
+int32 FBulletCancel::CancelarFuerzaBruta(FBulletSoA& Balas, const float* RadioPorTipo, float DeltaTime, uint8 DuenoCancela)
+{
+	Cancelada.Reset();
+	Cancelada.SetNumZeroed(Balas.Num());
+	Parejas = 0;
+	for (int32 i = 0; i < Balas.Num(); ++i)
+	{
+		if (!Cancela(Balas, i, DuenoCancela))
+		{
+			continue;
+		}
+		for (int32 j = 0; j < Balas.Num(); ++j)
+		{
+			if (Balas.Dueno[j] != DuenoCancela && !Cancelada[j]
+				&& SeTocan(Balas, i, j, RadioPorTipo[Balas.Tipo[i]], RadioPorTipo[Balas.Tipo[j]], DeltaTime))
+			{
+				Cancelada[i] = 1;
+				Cancelada[j] = 1;
+				++Parejas;
+				break;
+			}
+		}
+	}
+
+	if (Parejas > 0)
+	{
+		Compactar(Balas);
+	}
+	return Parejas;
+}
+
+// Galaga.Cancel.Bench [BalasPorLado] [Cuadros]: dos cortinas de balas que se cruzan en X
+static void BenchCancelacion(const TArray<FString>& Args)
+{
+	const int32 PorLado = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 4000;
+	const int32 Cuadros = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 60;
+	const float DeltaTime = 1.0f / 60.0f;
+	const float Radio = 15.0f;
+	const uint8 Jugador = (uint8)EBulletOwner::Jugador;
+	const uint8 Enemigo = (uint8)EBulletOwner::Enemigo;
+
+	FBulletCancel Cancelacion;
+	Cancelacion.SetNumTipos(1);
+	Cancelacion.SetTipo(0, true);
+
+	FRandomStream Azar(1234);
+	double TotalBarrido = 0.0;
+	double TotalFuerzaBruta = 0.0;
+	int32 ParejasBarrido = 0;
+	int32 ParejasFuerzaBruta = 0;
+	for (int32 Cuadro = 0; Cuadro < Cuadros; ++Cuadro)
+	{
+		FBulletSoA Balas;
+		Balas.Reserve(PorLado * 2);
+		for (int32 i = 0; i < PorLado; ++i)
+		{
+			Balas.Add(FVector(Azar.FRandRange(-1500.0f, 0.0f), Azar.FRandRange(-1500.0f, 1500.0f), 200.0f), FVector(3000.0f, 0.0f, 0.0f), 3.0f, 0, Jugador);
+			Balas.Add(FVector(Azar.FRandRange(0.0f, 1500.0f), Azar.FRandRange(-1500.0f, 1500.0f), 200.0f), FVector(-2000.0f, Azar.FRandRange(-200.0f, 200.0f), 0.0f), 3.0f, 0, Enemigo);
+		}
+		FBulletSoA Copia = Balas;
+
+		double Inicio = FPlatformTime::Seconds();
+		ParejasBarrido += Cancelacion.Cancelar(Balas, &Radio, DeltaTime, Jugador);
+		TotalBarrido += FPlatformTime::Seconds() - Inicio;
+
+		// La fuerza bruta es cuadratica; con muchas balas se mide un solo cuadro
+		if (Cuadro == 0 || PorLado <= 2000)
+		{
+			Inicio = FPlatformTime::Seconds();
+			ParejasFuerzaBruta += Cancelacion.CancelarFuerzaBruta(Copia, &Radio, DeltaTime, Jugador);
+			TotalFuerzaBruta += FPlatformTime::Seconds() - Inicio;
+		}
+	}
+
+	const int32 CuadrosFuerzaBruta = PorLado <= 2000 ? Cuadros : 1;
+	UE_LOG(LogGalaga_USFX, Display, TEXT("Cancel bench: %d balas por lado, sort-and-sweep %.3f ms por cuadro (%.1f parejas), todas contra todas %.3f ms (%.1f parejas)"),
+		PorLado, TotalBarrido * 1000.0 / FMath::Max(Cuadros, 1), (float)ParejasBarrido / FMath::Max(Cuadros, 1),
+		TotalFuerzaBruta * 1000.0 / FMath::Max(CuadrosFuerzaBruta, 1), (float)ParejasFuerzaBruta / FMath::Max(CuadrosFuerzaBruta, 1));
+}
+
+static FAutoConsoleCommand CmdBenchCancelacion(
+	TEXT("Galaga.Cancel.Bench"),
+	TEXT("Galaga.Cancel.Bench [BalasPorLado=4000] [Cuadros=60]: costo de cancelar balas contra balas, sort-and-sweep contra todas las parejas"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchCancelacion));
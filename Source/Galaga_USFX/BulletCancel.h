@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BulletSoA.h"
+
+/**
+ * Balas del jugador que cancelan balas enemigas al tocarlas (por arquetipo o con el
+ * potenciador). Los disparos viajan casi solo en X, asi que las parejas se buscan con un
+ * sort-and-sweep sobre el eje Y: cada bala es un intervalo [Min, Max] en Y que cubre su
+ * movimiento del cuadro, y solo se prueban las de equipos distintos cuyos intervalos se
+ * solapan. El costo es O(n log n + parejas) en lugar de todas contra todas.
+ */
+struct GALAGA_USFX_API FBulletCancel
+{
+	void SetNumTipos(int32 NumTipos);
+	void SetTipo(int32 Tipo, bool bCancela);
+
+	// Potenciador: todas las balas de DuenoCancela cancelan, sin importar su arquetipo
+	FORCEINLINE void SetCancelarTodas(bool bTodas) { bCancelarTodas = bTodas; }
+	FORCEINLINE bool HayCanceladoras() const { return bCancelarTodas || NumCanceladoras > 0; }
+
+	// Quita del SoA cada bala de DuenoCancela que toco una bala contraria en el cuadro, junto
+	// con esa bala; cada una cancela a lo sumo a otra. Devuelve cuantas parejas se quitaron
+	int32 Cancelar(FBulletSoA& Balas, const float* RadioPorTipo, float DeltaTime, uint8 DuenoCancela);
+
+	// Misma regla probando todas las parejas, para comparar en Galaga.Cancel.Bench
+	int32 CancelarFuerzaBruta(FBulletSoA& Balas, const float* RadioPorTipo, float DeltaTime, uint8 DuenoCancela);
+
+	// Verdadero si las dos balas se tocan en algun momento del cuadro (barrido relativo)
+	static bool SeTocan(const FBulletSoA& Balas, int32 A, int32 B, float RadioA, float RadioB, float DeltaTime);
+
+private:
+	struct FIntervalo
+	{
+		float Min;
+		float Max;
+		int32 Bala;
+	};
+
+	FORCEINLINE bool Cancela(const FBulletSoA& Balas, int32 Bala, uint8 DuenoCancela) const
+	{
+		return Balas.Dueno[Bala] == DuenoCancela && (bCancelarTodas || CancelaTipo[Balas.Tipo[Bala]]);
+	}
+
+	// Prueba Nueva contra los intervalos activos del otro lado; quita los que ya quedaron atras.
+	// Devuelve verdadero si Nueva se cancelo
+	bool Barrer(const FBulletSoA& Balas, const float* RadioPorTipo, float DeltaTime, const FIntervalo& Nueva, TArray<FIntervalo>& Activos);
+
+	// Quita las balas marcadas conservando el orden del resto
+	void Compactar(FBulletSoA& Balas);
+
+	TArray<uint8> CancelaTipo;
+	int32 NumCanceladoras = 0;
+	bool bCancelarTodas = false;
+
+	// Buffers del cuadro, se reutilizan
+	TArray<FIntervalo> Propias;
+	TArray<FIntervalo> Contrarias;
+	TArray<FIntervalo> ActivasPropias;
+	TArray<FIntervalo> ActivasContrarias;
+	TArray<uint8> Cancelada;
+	int32 Parejas = 0;
+};
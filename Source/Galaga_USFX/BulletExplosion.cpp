@@ -0,0 +1,183 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BulletExplosion.h"
+#include "BulletKernel.h"
+#include "Galaga_USFX.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+
+void FBulletExplosion::SetNumTipos(int32 NumTipos)
+{
+	RadioExplosion.SetNumZeroed(NumTipos);
+	RadioProximidad.SetNumZeroed(NumTipos);
+	Dano.SetNumZeroed(NumTipos);
+	NumExplosivos = 0;
+	RejillaBombas.Configurar(FBulletKernel::LimiteCampo, 200.0f);
+}
+
+void FBulletExplosion::SetTipo(int32 Tipo, float InRadioExplosion, float InRadioProximidad, float InDano)
+{
+	if (!RadioExplosion.IsValidIndex(Tipo))
+	{
+		return;
+	}
+
+	NumExplosivos += (int32)(InRadioExplosion > 0.0f) - (int32)(RadioExplosion[Tipo] > 0.0f);
+	RadioExplosion[Tipo] = FMath::Max(InRadioExplosion, 0.0f);
+	RadioProximidad[Tipo] = FMath::Max(InRadioProximidad, 0.0f);
+	Dano[Tipo] = InDano;
+}
+
+void FBulletExplosion::Encolar(const FVector& Posicion, uint8 Tipo, uint8 Dueno)
+{
+	if (RadioExplosion.IsValidIndex(Tipo) && RadioExplosion[Tipo] > 0.0f)
+	{
+		Pendientes.Add({ Posicion, Tipo, Dueno });
+	}
+}
+
+int32 FBulletExplosion::Detonar(FBulletSoA& Balas, const FSpatialGrid& Objetivos, const TArray<uint8>& Equipos, float DeltaTime, TArray<float>& OutDanoPorObjetivo)
+{
+	OutDanoPorObjetivo.Reset();
+	OutDanoPorObjetivo.SetNumZeroed(Objetivos.Num());
+
+	// Las explosiones encoladas desde fuera arrancan la cadena igual que una bomba del campo
+	Fuentes.Reset();
+	Fuentes.Append(Pendientes);
+	Pendientes.Reset();
+
+	Bombas.Reset();
+	PosicionBombas.Reset();
+	if (NumExplosivos > 0)
+	{
+		for (int32 i = 0; i < Balas.Num(); ++i)
+		{
+			if (RadioExplosion[Balas.Tipo[i]] > 0.0f)
+			{
+				Bombas.Add(i);
+				PosicionBombas.Add(Balas.GetPosicion(i));
+			}
+		}
+	}
+	Detonada.Reset();
+	Detonada.SetNumZeroed(Bombas.Num());
+
+	// Disparadores: espoleta (la bala vence en este cuadro) o un objetivo contrario cerca
+	for (int32 b = 0; b < Bombas.Num(); ++b)
+	{
+		const int32 i = Bombas[b];
+		const uint8 Tipo = Balas.Tipo[i];
+		const bool bEspoleta = Balas.Vida[i] <= DeltaTime;
+		const bool bProximidad = RadioProximidad[Tipo] > 0.0f
+			&& Objetivos.BuscarMasCercano(PosicionBombas[b], RadioProximidad[Tipo], Equipos, Balas.Dueno[i]) != INDEX_NONE;
+		if (bEspoleta || bProximidad)
+		{
+			Detonada[b] = 1;
+			Fuentes.Add({ PosicionBombas[b], Tipo, Balas.Dueno[i] });
+		}
+	}
+
+	if (Fuentes.Num() == 0)
+	{
+		return 0;
+	}
+
+	// Reaccion en cadena: cada explosion detona las bombas que alcanza, que se agregan al final de Fuentes
+	if (Bombas.Num() > 0)
+	{
+		RejillaBombas.Construir(PosicionBombas);
+		for (int32 f = 0; f < Fuentes.Num(); ++f)
+		{
+			Alcance.Reset();
+			RejillaBombas.BuscarEnRadio(Fuentes[f].Posicion, RadioExplosion[Fuentes[f].Tipo], Alcance);
+			for (int32 b : Alcance)
+			{
+				if (!Detonada[b])
+				{
+					Detonada[b] = 1;
+					const int32 i = Bombas[b];
+					Fuentes.Add({ PosicionBombas[b], Balas.Tipo[i], Balas.Dueno[i] });
+				}
+			}
+		}
+	}
+
+	// Dano con caida lineal, sumado por objetivo para aplicarlo una sola vez
+	for (const FFuente& Fuente : Fuentes)
+	{
+		const float Radio = RadioExplosion[Fuente.Tipo];
+		Alcance.Reset();
+		Objetivos.BuscarEnRadio(Fuente.Posicion, Radio, Alcance);
+		for (int32 Objetivo : Alcance)
+		{
+			if (Equipos[Objetivo] != Fuente.Dueno)
+			{
+				const float Distancia = FVector::Dist(Fuente.Posicion, Objetivos.GetPosicion(Objetivo));
+				OutDanoPorObjetivo[Objetivo] += Dano[Fuente.Tipo] * Caida(Distancia, Radio);
+			}
+		}
+	}
+
+	// Bombas en orden creciente: al quitarlas de atras hacia adelante RemoveAtSwap no mueve una pendiente
+	for (int32 b = Bombas.Num() - 1; b >= 0; --b)
+	{
+		if (Detonada[b])
+		{
+			Balas.RemoveAtSwap(Bombas[b]);
+		}
+	}
+	return Fuentes.Num();
+}
+
+// Galaga.Explosion.Bench [Bombas] [Cuadros]: una andanada que explota junta, con cadena
+static void BenchExplosion(const TArray<FString>& Args)
+{
+	const int32 Cantidad = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 64;
+	const int32 Cuadros = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 300;
+	const float DeltaTime = 1.0f / 60.0f;
+
+	FRandomStream Azar(1234);
+	TArray<FVector> Posiciones;
+	TArray<uint8> Equipos;
+	for (int32 i = 0; i < 31; ++i)
+	{
+		Posiciones.Add(FVector(Azar.FRandRange(-1500.0f, 1500.0f), Azar.FRandRange(-1500.0f, 1500.0f), 200.0f));
+		Equipos.Add(i == 0 ? 1 : 0);
+	}
+
+	FSpatialGrid Objetivos;
+	Objetivos.Configurar(FBulletKernel::LimiteCampo, 200.0f);
+	FBulletExplosion Explosion;
+	Explosion.SetNumTipos(1);
+	Explosion.SetTipo(0, 350.0f, 150.0f, 10.0f);
+
+	FBulletSoA Bombas;
+	TArray<float> DanoPorObjetivo;
+	double Total = 0.0;
+	int32 Explosiones = 0;
+	for (int32 Cuadro = 0; Cuadro < Cuadros; ++Cuadro)
+	{
+		// Bombas agrupadas como una andanada de Nodriza; una con la espoleta vencida arranca la cadena
+		Bombas.Reset();
+		const FVector Centro(Azar.FRandRange(-1000.0f, 1000.0f), Azar.FRandRange(-1000.0f, 1000.0f), 200.0f);
+		for (int32 i = 0; i < Cantidad; ++i)
+		{
+			Bombas.Add(Centro + FVector(Azar.FRandRange(-600.0f, 600.0f), Azar.FRandRange(-600.0f, 600.0f), 0.0f),
+				FVector(-3000.0f, 0.0f, 0.0f), i == 0 ? 0.0f : 3.0f, 0, 0);
+		}
+
+		const double Inicio = FPlatformTime::Seconds();
+		Objetivos.Construir(Posiciones);
+		Explosiones += Explosion.Detonar(Bombas, Objetivos, Equipos, DeltaTime, DanoPorObjetivo);
+		Total += FPlatformTime::Seconds() - Inicio;
+	}
+
+	UE_LOG(LogGalaga_USFX, Display, TEXT("Explosion bench: %d bombas por andanada, %.1f explosiones promedio, %.3f ms por cuadro"),
+		Cantidad, (float)Explosiones / FMath::Max(Cuadros, 1), Total * 1000.0 / FMath::Max(Cuadros, 1));
+}
+
+static FAutoConsoleCommand CmdBenchExplosion(
+	TEXT("Galaga.Explosion.Bench"),
+	TEXT("Galaga.Explosion.Bench [Bombas=64] [Cuadros=300]: costo de detonar una andanada de bombas con reaccion en cadena"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchExplosion));
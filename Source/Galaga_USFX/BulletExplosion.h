@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BulletSoA.h"
+#include "SpatialGrid.h"
+
+/**
+ * Detonaciones de las balas explosivas del campo (las bombas de ANaveEnemigaNodriza).
+ * Una bomba explota cuando se le acaba la espoleta o cuando tiene un objetivo del equipo
+ * contrario a menos de RadioProximidad. Cada explosion hace detonar a las bombas que
+ * alcanza (reaccion en cadena) y reparte dano con caida lineal hasta RadioExplosion.
+ * Todo se resuelve una vez por cuadro con consultas a rejillas, sin overlaps de fisica.
+ */
+struct GALAGA_USFX_API FBulletExplosion
+{
+	void SetNumTipos(int32 NumTipos);
+	void SetTipo(int32 Tipo, float InRadioExplosion, float InRadioProximidad, float InDano);
+
+	FORCEINLINE bool HayExplosivos() const { return NumExplosivos > 0 || Pendientes.Num() > 0; }
+
+	// Explosion que no viene del SoA (ABomba cuando el campo esta apagado); se resuelve en el proximo Detonar
+	void Encolar(const FVector& Posicion, uint8 Tipo, uint8 Dueno);
+
+	// Detona, quita del SoA las bombas que explotaron y suma en OutDanoPorObjetivo (uno por punto
+	// de la rejilla de objetivos) el dano recibido. Devuelve cuantas explosiones hubo
+	int32 Detonar(FBulletSoA& Balas, const FSpatialGrid& Objetivos, const TArray<uint8>& Equipos, float DeltaTime, TArray<float>& OutDanoPorObjetivo);
+
+	// Dano en el centro por Caida(distancia): 1 en el centro y 0 en el borde
+	static FORCEINLINE float Caida(float Distancia, float Radio)
+	{
+		return FMath::Clamp(1.0f - Distancia / Radio, 0.0f, 1.0f);
+	}
+
+private:
+	struct FFuente
+	{
+		FVector Posicion;
+		uint8 Tipo;
+		uint8 Dueno;
+	};
+
+	TArray<float> RadioExplosion;
+	TArray<float> RadioProximidad;
+	TArray<float> Dano;
+	int32 NumExplosivos = 0;
+
+	TArray<FFuente> Pendientes;
+
+	// Buffers del cuadro, se reutilizan
+	TArray<int32> Bombas;
+	TArray<FVector> PosicionBombas;
+	TArray<uint8> Detonada;
+	TArray<FFuente> Fuentes;
+	TArray<int32> Alcance;
+	FSpatialGrid RejillaBombas;
+};
@@ -0,0 +1,681 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BulletFieldSubsystem.h"
+#include "BulletKernel.h"
+#include "DamageQueue.h"
+#include "EscudoComponent.h"
+#include "Galaga_USFX.h"
+#include "Galaga_USFXPawn.h"
+#include "NaveEnemiga.h"
+#include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+
+DECLARE_CYCLE_STAT(TEXT("Integrar"), STAT_BulletField_Integrar, STATGROUP_BulletField);
+DECLARE_CYCLE_STAT(TEXT("Guiado"), STAT_BulletField_Guiado, STATGROUP_BulletField);
+DECLARE_CYCLE_STAT(TEXT("Explosiones"), STAT_BulletField_Explosiones, STATGROUP_BulletField);
+DECLARE_CYCLE_STAT(TEXT("Rayos"), STAT_BulletField_Rayos, STATGROUP_BulletField);
+DECLARE_CYCLE_STAT(TEXT("Impactos"), STAT_BulletField_Impactos, STATGROUP_BulletField);
+DECLARE_CYCLE_STAT(TEXT("Instancias"), STAT_BulletField_Instancias, STATGROUP_BulletField);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Balas vivas"), STAT_BulletField_Vivas, STATGROUP_BulletField);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Misiles guiados"), STAT_BulletField_Guiados, STATGROUP_BulletField);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Detonaciones"), STAT_BulletField_Detonaciones, STATGROUP_BulletField);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Rayos activos"), STAT_BulletField_Rayos_Activos, STATGROUP_BulletField);
+DECLARE_CYCLE_STAT(TEXT("Cancelacion"), STAT_BulletField_Cancelacion, STATGROUP_BulletField);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Balas canceladas"), STAT_BulletField_Canceladas, STATGROUP_BulletField);
+DECLARE_CYCLE_STAT(TEXT("Escudos"), STAT_BulletField_Escudos, STATGROUP_BulletField);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Balas absorbidas"), STAT_BulletField_Absorbidas, STATGROUP_BulletField);
+
+static TAutoConsoleVariable<int32> CVarBulletFieldEnable(
+	TEXT("Galaga.BulletField.Enable"),
+	1,
+	TEXT("1: los disparos van al campo de balas instanciado. 0: un actor por bala (pool)."));
+
+static TAutoConsoleVariable<float> CVarBulletFieldSweepUmbral(
+	TEXT("Galaga.BulletField.SweepUmbral"),
+	20.0f,
+	TEXT("Avance por cuadro a partir del cual una bala se prueba con barrido en lugar de solo en su posicion final. 0: siempre barrido."));
+
+static void BenchCampoBalas(const TArray<FString>& Args)
+{
+	const int32 Cantidad = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 10000;
+	const int32 Cuadros = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 600;
+	const float DeltaTime = 1.0f / 60.0f;
+
+	FBulletSoA Prueba;
+	Prueba.Reserve(Cantidad);
+	FRandomStream Azar(1234);
+
+	// Objetivos de prueba: una oleada de 30 naves y el jugador
+	TArray<FVector> Posiciones;
+	TArray<float> Radios;
+	TArray<uint8> Equipos;
+	for (int32 i = 0; i < 31; ++i)
+	{
+		Posiciones.Add(FVector(Azar.FRandRange(-1000.0f, 1000.0f), Azar.FRandRange(-1000.0f, 1000.0f), 200.0f));
+		Radios.Add(60.0f);
+		Equipos.Add(i == 0 ? (uint8)EBulletOwner::Jugador : (uint8)EBulletOwner::Enemigo);
+	}
+	// Seis tipos como los arquetipos por defecto, todos con el mismo radio
+	const int32 NumTipos = 6;
+	float RadioPorTipo[NumTipos];
+	for (float& Radio : RadioPorTipo)
+	{
+		Radio = 20.0f;
+	}
+
+	TArray<FIntPoint> Impactos;
+	TArray<FVector> Anteriores = Posiciones;
+	double Total = 0.0;
+	for (int32 Cuadro = 0; Cuadro < Cuadros; ++Cuadro)
+	{
+		// Mantiene la poblacion constante reponiendo las que vencieron o chocaron
+		while (Prueba.Num() < Cantidad)
+		{
+			const FVector Direccion = FVector(Azar.FRandRange(-1.0f, 1.0f), Azar.FRandRange(-1.0f, 1.0f), 0.0f).GetSafeNormal();
+			Prueba.Add(FVector(Azar.FRandRange(-1600.0f, 1600.0f), Azar.FRandRange(-1600.0f, 1600.0f), 200.0f),
+				Direccion * 2000.0f, Azar.FRandRange(0.5f, 3.0f), (uint8)Azar.RandHelper(NumTipos), (uint8)Azar.RandHelper(2));
+		}
+
+		const double Inicio = FPlatformTime::Seconds();
+		UBulletFieldSubsystem::Integrar(Prueba, DeltaTime);
+		UBulletFieldSubsystem::BuscarImpactos(Prueba, RadioPorTipo, Posiciones, Anteriores, Radios, Equipos, DeltaTime,
+			UBulletFieldSubsystem::GetUmbralBarrido(), Impactos);
+		for (int32 i = Impactos.Num() - 1; i >= 0; --i)
+		{
+			Prueba.RemoveAtSwap(Impactos[i].X);
+		}
+		Total += FPlatformTime::Seconds() - Inicio;
+	}
+
+	UE_LOG(LogGalaga_USFX, Display, TEXT("BulletField bench: %d balas, %d cuadros, %.3f ms por cuadro (60 Hz = 16.667 ms)"),
+		Cantidad, Cuadros, Total * 1000.0 / FMath::Max(Cuadros, 1));
+}
+
+static FAutoConsoleCommand CmdBenchCampoBalas(
+	TEXT("Galaga.BulletField.Bench"),
+	TEXT("Galaga.BulletField.Bench [Balas=10000] [Cuadros=600]: mide integracion + impactos del campo de balas en un hilo"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchCampoBalas));
+
+// Una bala contra un objetivo que cruza su camino, simulada a DeltaTime hasta un segundo
+static bool SimularDisparo(const FVector& Origen, const FVector& Velocidad, const FVector& ObjetivoInicio, const FVector& ObjetivoVelocidad,
+	float DeltaTime, float Umbral)
+{
+	FBulletSoA Bala;
+	Bala.Add(Origen, Velocidad, 2.0f, 0, (uint8)EBulletOwner::Jugador);
+
+	const float RadioBala = 10.0f;
+	TArray<FVector> Posiciones = { ObjetivoInicio };
+	TArray<FVector> Anteriores = { ObjetivoInicio };
+	const TArray<float> Radios = { 60.0f };
+	const TArray<uint8> Equipos = { (uint8)EBulletOwner::Enemigo };
+	TArray<FIntPoint> Impactos;
+
+	for (float Tiempo = 0.0f; Tiempo < 1.0f && Bala.Num() > 0; Tiempo += DeltaTime)
+	{
+		Anteriores[0] = Posiciones[0];
+		Posiciones[0] += ObjetivoVelocidad * DeltaTime;
+		UBulletFieldSubsystem::Integrar(Bala, DeltaTime);
+		UBulletFieldSubsystem::BuscarImpactos(Bala, &RadioBala, Posiciones, Anteriores, Radios, Equipos, DeltaTime, Umbral, Impactos);
+		if (Impactos.Num() > 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+// Galaga.BulletField.SweepTest [Disparos]: balas a 3000 uu/s contra un objetivo en movimiento, a cuadros cada vez mas largos
+static void PruebaBarrido(const TArray<FString>& Args)
+{
+	const int32 Disparos = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 500;
+	const float FPS[] = { 60.0f, 30.0f, 15.0f, 10.0f, 5.0f };
+	const float Umbral = UBulletFieldSubsystem::GetUmbralBarrido();
+
+	for (float Cuadros : FPS)
+	{
+		FRandomStream Azar(1234);
+		int32 Esperados = 0;
+		int32 PerdidosBarrido = 0;
+		int32 PerdidosDiscreto = 0;
+		int32 Falsos = 0;
+		for (int32 i = 0; i < Disparos; ++i)
+		{
+			// El jugador pasa de lado a 800 uu/s; las balas salen de frente con Y al azar
+			const FVector Origen(1000.0f, Azar.FRandRange(-500.0f, 500.0f), 200.0f);
+			const FVector Velocidad(-3000.0f, 0.0f, 0.0f);
+			const FVector ObjetivoInicio(-1000.0f, -400.0f, 200.0f);
+			const FVector ObjetivoVelocidad(0.0f, 800.0f, 0.0f);
+
+			// Referencia: pasos de 0.75 uu, sin barrido
+			const bool bReferencia = SimularDisparo(Origen, Velocidad, ObjetivoInicio, ObjetivoVelocidad, 1.0f / 4000.0f, BIG_NUMBER);
+			const bool bBarrido = SimularDisparo(Origen, Velocidad, ObjetivoInicio, ObjetivoVelocidad, 1.0f / Cuadros, Umbral);
+			const bool bDiscreto = SimularDisparo(Origen, Velocidad, ObjetivoInicio, ObjetivoVelocidad, 1.0f / Cuadros, BIG_NUMBER);
+
+			Esperados += bReferencia;
+			PerdidosBarrido += bReferencia && !bBarrido;
+			PerdidosDiscreto += bReferencia && !bDiscreto;
+			Falsos += !bReferencia && bBarrido;
+		}
+
+		UE_LOG(LogGalaga_USFX, Display, TEXT("SweepTest %2.0f FPS: %d impactos esperados, barrido pierde %d (%d falsos), sin barrido pierde %d"),
+			Cuadros, Esperados, PerdidosBarrido, Falsos, PerdidosDiscreto);
+		if (PerdidosBarrido > 0)
+		{
+			UE_LOG(LogGalaga_USFX, Warning, TEXT("SweepTest %2.0f FPS: el barrido perdio impactos"), Cuadros);
+		}
+	}
+}
+
+static FAutoConsoleCommand CmdPruebaBarrido(
+	TEXT("Galaga.BulletField.SweepTest"),
+	TEXT("Galaga.BulletField.SweepTest [Disparos=500]: cuenta los impactos perdidos a 60, 30, 15, 10 y 5 FPS con y sin barrido"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&PruebaBarrido));
+
+bool UBulletFieldSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World != nullptr && World->IsGameWorld();
+}
+
+void UBulletFieldSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Los arquetipos tienen que estar cargados antes de crear las instancias
+	Arquetipos = Collection.InitializeDependency<UProjectileArchetypeSubsystem>();
+}
+
+void UBulletFieldSubsystem::Deinitialize()
+{
+	Balas.Reset();
+	Objetivos.Empty();
+	Escudos.Empty();
+	Instancias.Empty();
+	Anfitrion = nullptr;
+	Arquetipos = nullptr;
+
+	Super::Deinitialize();
+}
+
+void UBulletFieldSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	FActorSpawnParameters Parametros;
+	Parametros.ObjectFlags |= RF_Transient;
+	Anfitrion = InWorld.SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, Parametros);
+
+	USceneComponent* Raiz = NewObject<USceneComponent>(Anfitrion, TEXT("Raiz"));
+	Anfitrion->SetRootComponent(Raiz);
+	Raiz->RegisterComponent();
+
+	const int32 NumTipos = Arquetipos ? Arquetipos->Num() : 0;
+	Instancias.SetNum(NumTipos);
+	TransformsPorTipo.SetNum(NumTipos);
+	RadioTipo.SetNum(NumTipos);
+	DanoTipo.SetNum(NumTipos);
+	Guiado.SetNumTipos(NumTipos);
+	Explosion.SetNumTipos(NumTipos);
+	Rayos.SetNumTipos(NumTipos);
+	Cancelacion.SetNumTipos(NumTipos);
+	Rejilla.Configurar(FBulletKernel::LimiteCampo, 200.0f);
+	for (int32 Tipo = 0; Tipo < NumTipos; ++Tipo)
+	{
+		const FProjectileArchetype& Arquetipo = Arquetipos->Get(Tipo);
+		RadioTipo[Tipo] = Arquetipo.Radio;
+		DanoTipo[Tipo] = Arquetipo.Dano;
+		Guiado.SetTipo(Tipo, Arquetipo.Teledirigido, Arquetipo.GiroMaximo, Arquetipo.Aceleracion, Arquetipo.VelocidadMaxima);
+		Explosion.SetTipo(Tipo, Arquetipo.RadioExplosion, Arquetipo.RadioProximidad, Arquetipo.Dano);
+		Cancelacion.SetTipo(Tipo, Arquetipo.CancelaBalas);
+		if (Arquetipo.EsRayo())
+		{
+			// La malla se estira a lo largo del rayo, hace falta su tamano sin escalar
+			const FVector Extension = Arquetipo.Malla ? Arquetipo.Malla->GetBounds().BoxExtent : FVector(50.0f);
+			Rayos.SetTipo(Tipo, Arquetipo.AnchoRayo, Arquetipo.LargoRayo, Arquetipo.DanoPorSegundo, Arquetipo.DuracionRayo, Extension);
+		}
+
+		UInstancedStaticMeshComponent* Instancia = NewObject<UInstancedStaticMeshComponent>(Anfitrion);
+		Instancia->SetStaticMesh(Arquetipo.Malla);
+		Instancia->SetMobility(EComponentMobility::Movable);
+		Instancia->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		Instancia->SetCastShadow(false);
+		Instancia->SetupAttachment(Raiz);
+		Instancia->RegisterComponent();
+		Instancias[Tipo] = Instancia;
+	}
+
+	Balas.Reserve(1024);
+}
+
+void UBulletFieldSubsystem::Tick(float DeltaTime)
+{
+	ActualizarObjetivos();
+	if (Guiado.HayTeledirigidos() || Explosion.HayExplosivos() || Rayos.Num() > 0)
+	{
+		Rejilla.Construir(ObjetivoPosicion);
+	}
+	if (Explosion.HayExplosivos())
+	{
+		// Todas las bombas que explotan en el cuadro, cadenas incluidas, se resuelven juntas
+		SCOPE_CYCLE_COUNTER(STAT_BulletField_Explosiones);
+		INC_DWORD_STAT_BY(STAT_BulletField_Detonaciones, Explosion.Detonar(Balas, Rejilla, ObjetivoEquipo, DeltaTime, DanoExplosion));
+		AplicarDanoArea(DanoExplosion, TEXT("Explosion"));
+	}
+	if (Rayos.Num() > 0)
+	{
+		// Un segmento por rayo, todos contra la misma rejilla
+		SCOPE_CYCLE_COUNTER(STAT_BulletField_Rayos);
+		SET_DWORD_STAT(STAT_BulletField_Rayos_Activos, Rayos.Trazar(Rejilla, ObjetivoRadio, ObjetivoEquipo, DeltaTime, DanoRayos));
+		AplicarDanoArea(DanoRayos, TEXT("Laser"));
+	}
+	if (Guiado.HayTeledirigidos())
+	{
+		// Los misiles eligen objetivo con una sola consulta en lote a la rejilla, antes de moverse
+		SCOPE_CYCLE_COUNTER(STAT_BulletField_Guiado);
+		SET_DWORD_STAT(STAT_BulletField_Guiados, Guiado.Guiar(Balas, Rejilla, ObjetivoEquipo, DeltaTime));
+	}
+	{
+		SCOPE_CYCLE_COUNTER(STAT_BulletField_Integrar);
+		Integrar(Balas, DeltaTime);
+	}
+	if (CancelacionRestante > 0.0f)
+	{
+		CancelacionRestante -= DeltaTime;
+		Cancelacion.SetCancelarTodas(CancelacionRestante > 0.0f);
+	}
+	if (Cancelacion.HayCanceladoras())
+	{
+		// Antes de los impactos: una bala enemiga cancelada ya no puede pegarle al jugador
+		SCOPE_CYCLE_COUNTER(STAT_BulletField_Cancelacion);
+		INC_DWORD_STAT_BY(STAT_BulletField_Canceladas, 2 * Cancelacion.Cancelar(Balas, RadioTipo.GetData(), DeltaTime, (uint8)EBulletOwner::Jugador));
+	}
+	if (Escudos.Num() > 0)
+	{
+		// Tambien antes de los impactos: lo que absorbe el escudo no llega a la nave
+		SCOPE_CYCLE_COUNTER(STAT_BulletField_Escudos);
+		INC_DWORD_STAT_BY(STAT_BulletField_Absorbidas, AbsorberEnEscudos(DeltaTime));
+	}
+	{
+		SCOPE_CYCLE_COUNTER(STAT_BulletField_Impactos);
+		BuscarImpactos(Balas, RadioTipo.GetData(), ObjetivoPosicion, ObjetivoAnterior, ObjetivoRadio, ObjetivoEquipo, DeltaTime, GetUmbralBarrido(), Impactos);
+		AplicarImpactos();
+	}
+	{
+		SCOPE_CYCLE_COUNTER(STAT_BulletField_Instancias);
+		ActualizarInstancias();
+	}
+	SET_DWORD_STAT(STAT_BulletField_Vivas, Balas.Num());
+}
+
+ETickableTickType UBulletFieldSubsystem::GetTickableTickType() const
+{
+	return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UBulletFieldSubsystem::IsTickable() const
+{
+	return Anfitrion != nullptr;
+}
+
+TStatId UBulletFieldSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBulletFieldSubsystem, STATGROUP_Tickables);
+}
+
+bool UBulletFieldSubsystem::IsEnabled()
+{
+	return CVarBulletFieldEnable.GetValueOnGameThread() != 0;
+}
+
+float UBulletFieldSubsystem::GetUmbralBarrido()
+{
+	return FMath::Max(CVarBulletFieldSweepUmbral.GetValueOnGameThread(), 0.0f);
+}
+
+void UBulletFieldSubsystem::Spawn(FProjectileArchetypeHandle Arquetipo, const FVector& Location, const FVector& Velocity, EBulletOwner Dueno)
+{
+	if (!Arquetipo.IsValid() || !Instancias.IsValidIndex(Arquetipo.Indice))
+	{
+		return;
+	}
+
+	// Con espoleta la bala dura solo hasta explotar
+	const FProjectileArchetype& Datos = Arquetipos->Get(Arquetipo);
+	const float Vida = Datos.Espoleta > 0.0f ? FMath::Min(Datos.VidaUtil, Datos.Espoleta) : Datos.VidaUtil;
+	Balas.Add(Location, Velocity, Vida, (uint8)Arquetipo.Indice, (uint8)Dueno);
+}
+
+void UBulletFieldSubsystem::SpawnBatch(const TArray<FVector>& Locations, const TArray<FVector>& Velocities, const TArray<uint8>& Tipos, const TArray<uint8>& Duenos)
+{
+	const int32 Cantidad = Locations.Num();
+	if (Cantidad == 0 || Arquetipos == nullptr)
+	{
+		return;
+	}
+
+	// Se reserva el lote entero y se escribe directo en cada arreglo, sin pasar por Add
+	const int32 Primera = Balas.AddUninitialized(Cantidad);
+	int32 Hasta = Primera;
+	for (int32 i = 0; i < Cantidad; ++i)
+	{
+		const uint8 Tipo = Tipos[i];
+		if (!Instancias.IsValidIndex(Tipo))
+		{
+			continue;
+		}
+
+		const FProjectileArchetype& Datos = Arquetipos->Get(Tipo);
+		Balas.PosX[Hasta] = Locations[i].X;
+		Balas.PosY[Hasta] = Locations[i].Y;
+		Balas.PosZ[Hasta] = Locations[i].Z;
+		Balas.VelX[Hasta] = Velocities[i].X;
+		Balas.VelY[Hasta] = Velocities[i].Y;
+		Balas.VelZ[Hasta] = Velocities[i].Z;
+		Balas.Vida[Hasta] = Datos.Espoleta > 0.0f ? FMath::Min(Datos.VidaUtil, Datos.Espoleta) : Datos.VidaUtil;
+		Balas.Tipo[Hasta] = Tipo;
+		Balas.Dueno[Hasta] = Duenos[i];
+		++Hasta;
+	}
+	Balas.Truncar(Hasta);
+}
+
+void UBulletFieldSubsystem::Detonar(FProjectileArchetypeHandle Arquetipo, const FVector& Location, EBulletOwner Dueno)
+{
+	if (Arquetipo.IsValid() && Arquetipos && Arquetipo.Indice < Arquetipos->Num())
+	{
+		Explosion.Encolar(Location, (uint8)Arquetipo.Indice, (uint8)Dueno);
+	}
+}
+
+void UBulletFieldSubsystem::SpawnBeam(FProjectileArchetypeHandle Arquetipo, AActor* Fuente, const FVector& Offset, const FVector& Direccion, EBulletOwner Dueno)
+{
+	if (Arquetipo.IsValid() && Instancias.IsValidIndex(Arquetipo.Indice))
+	{
+		Rayos.Lanzar(Fuente, Offset, Direccion, (uint8)Arquetipo.Indice, (uint8)Dueno);
+	}
+}
+
+void UBulletFieldSubsystem::StopBeams(const AActor* Fuente)
+{
+	Rayos.Cortar(Fuente);
+}
+
+void UBulletFieldSubsystem::ActivarCancelacion(float Segundos)
+{
+	CancelacionRestante = FMath::Max(CancelacionRestante, Segundos);
+	Cancelacion.SetCancelarTodas(CancelacionRestante > 0.0f);
+}
+
+void UBulletFieldSubsystem::RegisterTarget(AActor* Actor, EBulletOwner Equipo)
+{
+	if (Actor == nullptr)
+	{
+		return;
+	}
+
+	FVector Origen;
+	FVector Extension;
+	Actor->GetActorBounds(true, Origen, Extension);
+
+	FBulletTarget Objetivo;
+	Objetivo.Actor = Actor;
+	Objetivo.Radio = FMath::Max(Extension.X, Extension.Y);
+	Objetivo.Equipo = Equipo;
+	Objetivo.PosicionAnterior = Actor->GetActorLocation();
+	Objetivos.Add(Objetivo);
+}
+
+void UBulletFieldSubsystem::UnregisterTarget(AActor* Actor)
+{
+	Objetivos.RemoveAllSwap([Actor](const FBulletTarget& Objetivo) { return Objetivo.Actor.Get() == Actor; });
+}
+
+void UBulletFieldSubsystem::RegisterShield(UEscudoComponent* Escudo, EBulletOwner Equipo)
+{
+	if (Escudo == nullptr || Escudo->GetOwner() == nullptr)
+	{
+		return;
+	}
+
+	UnregisterShield(Escudo);
+	FBulletShieldTarget Registro;
+	Registro.Escudo = Escudo;
+	Registro.Equipo = Equipo;
+	Registro.PosicionAnterior = Escudo->GetOwner()->GetActorLocation();
+	Escudos.Add(Registro);
+}
+
+void UBulletFieldSubsystem::UnregisterShield(UEscudoComponent* Escudo)
+{
+	Escudos.RemoveAllSwap([Escudo](const FBulletShieldTarget& Registro) { return Registro.Escudo.Get() == Escudo; });
+}
+
+void UBulletFieldSubsystem::Integrar(FBulletSoA& InBalas, float DeltaTime)
+{
+	// Todas las balas van en linea recta y sin gravedad; el kernel tambien quita las que salen del area de juego
+	FBulletKernel::Integrar(InBalas, DeltaTime, FBulletKernel::GetRutaActiva());
+}
+
+void UBulletFieldSubsystem::BuscarImpactos(const FBulletSoA& InBalas, const float* RadioPorTipo, const TArray<FVector>& Posiciones,
+	const TArray<FVector>& PosicionesAnteriores, const TArray<float>& Radios, const TArray<uint8>& Equipos,
+	float DeltaTime, float UmbralBarrido, TArray<FIntPoint>& OutImpactos)
+{
+	OutImpactos.Reset();
+
+	const float Umbral2 = UmbralBarrido * UmbralBarrido;
+	const int32 NumObjetivos = Posiciones.Num();
+	for (int32 Bala = 0; Bala < InBalas.Num(); ++Bala)
+	{
+		const FVector Posicion = InBalas.GetPosicion(Bala);
+		const FVector Paso = InBalas.GetVelocidad(Bala) * DeltaTime;
+		const float RadioBala = RadioPorTipo[InBalas.Tipo[Bala]];
+		const uint8 Dueno = InBalas.Dueno[Bala];
+
+		// Las balas lentas se prueban solo donde quedaron; las rapidas con barrido para no atravesar nada
+		const bool bBarrido = Paso.SizeSquared() > Umbral2;
+		const FVector Anterior = Posicion - Paso;
+
+		int32 Mejor = INDEX_NONE;
+		float MejorTiempo = 2.0f;
+		for (int32 Objetivo = 0; Objetivo < NumObjetivos; ++Objetivo)
+		{
+			// Las balas solo chocan con el equipo contrario
+			if (Equipos[Objetivo] == Dueno)
+			{
+				continue;
+			}
+
+			const float Suma = RadioBala + Radios[Objetivo];
+			if (!bBarrido)
+			{
+				if (FVector::DistSquared(Posicion, Posiciones[Objetivo]) <= Suma * Suma)
+				{
+					Mejor = Objetivo;
+					break;
+				}
+				continue;
+			}
+
+			// En el marco del objetivo la bala recorre un segmento recto: capsula contra esfera, exacto
+			// para el movimiento lineal de los dos dentro del cuadro
+			const float Tiempo = TiempoDeImpacto(Anterior - PosicionesAnteriores[Objetivo], Posicion - Posiciones[Objetivo], Suma);
+			if (Tiempo >= 0.0f && Tiempo < MejorTiempo)
+			{
+				MejorTiempo = Tiempo;
+				Mejor = Objetivo;
+			}
+		}
+
+		if (Mejor != INDEX_NONE)
+		{
+			OutImpactos.Add(FIntPoint(Bala, Mejor));
+		}
+	}
+}
+
+float UBulletFieldSubsystem::TiempoDeImpacto(const FVector& A0, const FVector& A1, float Radio)
+{
+	const float C = A0.SizeSquared() - Radio * Radio;
+	if (C <= 0.0f)
+	{
+		return 0.0f;
+	}
+
+	// |A0 + t*D|^2 = Radio^2, la raiz menor
+	const FVector D = A1 - A0;
+	const float A = D.SizeSquared();
+	const float B = A0 | D;
+	if (B >= 0.0f || A <= SMALL_NUMBER)
+	{
+		return -1.0f;
+	}
+
+	const float Discriminante = B * B - A * C;
+	if (Discriminante < 0.0f)
+	{
+		return -1.0f;
+	}
+
+	const float Tiempo = (-B - FMath::Sqrt(Discriminante)) / A;
+	return Tiempo <= 1.0f ? Tiempo : -1.0f;
+}
+
+void UBulletFieldSubsystem::ActualizarObjetivos()
+{
+	Objetivos.RemoveAllSwap([](const FBulletTarget& Objetivo) { return !Objetivo.Actor.IsValid(); });
+
+	ObjetivoPosicion.Reset(Objetivos.Num());
+	ObjetivoAnterior.Reset(Objetivos.Num());
+	ObjetivoRadio.Reset(Objetivos.Num());
+	ObjetivoEquipo.Reset(Objetivos.Num());
+	for (FBulletTarget& Objetivo : Objetivos)
+	{
+		const FVector Posicion = Objetivo.Actor->GetActorLocation();
+		ObjetivoAnterior.Add(Objetivo.PosicionAnterior);
+		ObjetivoPosicion.Add(Posicion);
+		Objetivo.PosicionAnterior = Posicion;
+		ObjetivoRadio.Add(Objetivo.Radio);
+		ObjetivoEquipo.Add((uint8)Objetivo.Equipo);
+	}
+}
+
+void UBulletFieldSubsystem::AplicarImpactos()
+{
+	// Los impactos vienen en orden de bala; se recorren al reves para que RemoveAtSwap no mueva una bala pendiente
+	for (int32 i = Impactos.Num() - 1; i >= 0; --i)
+	{
+		const int32 Bala = Impactos[i].X;
+		AActor* Actor = Objetivos[Impactos[i].Y].Actor.Get();
+
+		// Igual que los NotifyHit: el dano se suma en la cola del cuadro. Las balas del jugador solo
+		// encuentran naves enemigas y las de las naves solo al jugador
+		if (Cast<AGalaga_USFXPawn>(Actor) || Cast<ANaveEnemiga>(Actor))
+		{
+			const FProjectileArchetype& Arquetipo = Arquetipos->Get(Balas.Tipo[Bala]);
+			UDamageQueueSubsystem::EncolarDano(Actor, Arquetipo.Dano, Arquetipo.Nombre);
+		}
+
+		Balas.RemoveAtSwap(Bala);
+	}
+}
+
+void UBulletFieldSubsystem::AplicarDanoArea(const TArray<float>& DanoPorObjetivo, FName Tipo)
+{
+	// Un solo EncolarDano por objetivo con la suma de todo lo que lo alcanzo en el cuadro
+	for (int32 Objetivo = 0; Objetivo < DanoPorObjetivo.Num(); ++Objetivo)
+	{
+		if (DanoPorObjetivo[Objetivo] <= 0.0f)
+		{
+			continue;
+		}
+
+		AActor* Actor = Objetivos[Objetivo].Actor.Get();
+		if (Cast<AGalaga_USFXPawn>(Actor) || Cast<ANaveEnemiga>(Actor))
+		{
+			UDamageQueueSubsystem::EncolarDano(Actor, DanoPorObjetivo[Objetivo], Tipo);
+		}
+	}
+}
+
+int32 UBulletFieldSubsystem::AbsorberEnEscudos(float DeltaTime)
+{
+	Escudos.RemoveAllSwap([](const FBulletShieldTarget& Registro) { return !Registro.Escudo.IsValid() || Registro.Escudo->GetOwner() == nullptr; });
+
+	// La elipse va centrada en la nave, no en la malla del escudo
+	Absorcion.Escudos.Reset(Escudos.Num());
+	for (FBulletShieldTarget& Registro : Escudos)
+	{
+		const UEscudoComponent* Escudo = Registro.Escudo.Get();
+		const FVector Centro = Escudo->GetOwner()->GetActorLocation();
+
+		FBulletShields::FEscudo& Elipse = Absorcion.Escudos.AddDefaulted_GetRef();
+		Elipse.Centro = Centro;
+		Elipse.CentroAnterior = Registro.PosicionAnterior;
+		Elipse.RadioX = Escudo->RadioX;
+		Elipse.RadioY = Escudo->RadioY;
+		Elipse.Resistencia = Escudo->GetResistencia();
+		Elipse.Dueno = (uint8)Registro.Equipo;
+		Registro.PosicionAnterior = Centro;
+	}
+
+	const int32 Total = Absorcion.Absorber(Balas, RadioTipo.GetData(), DanoTipo.GetData(), DeltaTime);
+	if (Total == 0)
+	{
+		return 0;
+	}
+
+	// Se avisa al final porque un escudo que se rompe se quita de Escudos
+	for (int32 i = Absorcion.Escudos.Num() - 1; i >= 0; --i)
+	{
+		const FBulletShields::FEscudo& Elipse = Absorcion.Escudos[i];
+		if (Elipse.Absorbidas > 0)
+		{
+			Escudos[i].Escudo->Absorber(Elipse.Absorbidas, Elipse.DanoAbsorbido);
+		}
+	}
+	return Total;
+}
+
+void UBulletFieldSubsystem::ActualizarInstancias()
+{
+	for (TArray<FTransform>& Transforms : TransformsPorTipo)
+	{
+		Transforms.Reset();
+	}
+
+	for (int32 i = 0; i < Balas.Num(); ++i)
+	{
+		const uint8 Tipo = Balas.Tipo[i];
+		// Igual que bRotationFollowsVelocity en el UProjectileMovementComponent
+		TransformsPorTipo[Tipo].Emplace(Balas.GetVelocidad(i).ToOrientationQuat(), Balas.GetPosicion(i), FVector(Arquetipos->Get(Tipo).Escala));
+	}
+	Rayos.AgregarTransforms(TransformsPorTipo);
+
+	for (int32 Tipo = 0; Tipo < Instancias.Num(); ++Tipo)
+	{
+		UInstancedStaticMeshComponent* Instancia = Instancias[Tipo];
+		const TArray<FTransform>& Transforms = TransformsPorTipo[Tipo];
+		if (Instancia == nullptr)
+		{
+			continue;
+		}
+
+		// Solo se agregan o quitan instancias del final, el resto se reescribe en lote
+		for (int32 Sobrante = Instancia->GetInstanceCount() - 1; Sobrante >= Transforms.Num(); --Sobrante)
+		{
+			Instancia->RemoveInstance(Sobrante);
+		}
+		while (Instancia->GetInstanceCount() < Transforms.Num())
+		{
+			Instancia->AddInstance(FTransform::Identity);
+		}
+		if (Transforms.Num() > 0)
+		{
+			Instancia->BatchUpdateInstancesTransforms(0, Transforms, true, true, true);
+		}
+	}
+}
@@ -0,0 +1,168 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "BulletSoA.h"
+#include "BulletBeam.h"
+#include "BulletCancel.h"
+#include "BulletExplosion.h"
+#include "BulletHoming.h"
+#include "BulletShield.h"
+#include "SpatialGrid.h"
+#include "ProjectileArchetype.h"
+#include "BulletFieldSubsystem.generated.h"
+
+class UInstancedStaticMeshComponent;
+class UEscudoComponent;
+
+DECLARE_STATS_GROUP(TEXT("BulletField"), STATGROUP_BulletField, STATCAT_Advanced);
+
+UENUM()
+enum class EBulletOwner : uint8
+{
+	Enemigo,
+	Jugador
+};
+
+// Actor o nave con la que chocan las balas del campo
+struct FBulletTarget
+{
+	TWeakObjectPtr<AActor> Actor;
+	float Radio;
+	EBulletOwner Equipo;
+
+	// Posicion del cuadro anterior, para el barrido de las balas rapidas
+	FVector PosicionAnterior;
+};
+
+// Escudo activo que absorbe las balas del equipo contrario
+struct FBulletShieldTarget
+{
+	TWeakObjectPtr<UEscudoComponent> Escudo;
+	EBulletOwner Equipo;
+	FVector PosicionAnterior;
+};
+
+/**
+ * Campo de balas orientado a datos: todas las balas enemigas y del jugador viven en
+ * arreglos (FBulletSoA), se integran en un solo bucle y se dibujan con un
+ * UInstancedStaticMeshComponent por arquetipo en lugar de un actor por bala.
+ * El tipo de cada bala es el indice de su arquetipo en el UProjectileArchetypeSubsystem.
+ */
+UCLASS()
+class GALAGA_USFX_API UBulletFieldSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+public:
+	// Si es falso los disparos siguen usando actores del UProjectilePoolSubsystem
+	static bool IsEnabled();
+
+	void Spawn(FProjectileArchetypeHandle Arquetipo, const FVector& Location, const FVector& Velocity, EBulletOwner Dueno);
+
+	// Un lote de balas copiado columna por columna al final de los arreglos; Tipos y Duenos son
+	// el indice de arquetipo y el EBulletOwner. Las de tipo invalido se saltan
+	void SpawnBatch(const TArray<FVector>& Locations, const TArray<FVector>& Velocities, const TArray<uint8>& Tipos, const TArray<uint8>& Duenos);
+
+	// Explosion fuera del campo (una ABomba actor); se resuelve en el lote del proximo cuadro
+	void Detonar(FProjectileArchetypeHandle Arquetipo, const FVector& Location, EBulletOwner Dueno);
+
+	// Rayo continuo desde Fuente (+Offset) que la sigue mientras dure; volver a llamarlo lo renueva
+	void SpawnBeam(FProjectileArchetypeHandle Arquetipo, AActor* Fuente, const FVector& Offset, const FVector& Direccion, EBulletOwner Dueno);
+
+	// Apaga el rayo de Fuente, por ejemplo cuando la nave que lo disparaba muere
+	void StopBeams(const AActor* Fuente);
+
+	FORCEINLINE int32 GetNumBeams() const { return Rayos.Num(); }
+
+	// Potenciador: durante estos segundos todas las balas del jugador cancelan balas enemigas
+	void ActivarCancelacion(float Segundos);
+
+	void RegisterTarget(AActor* Actor, EBulletOwner Equipo);
+	void UnregisterTarget(AActor* Actor);
+
+	// Los escudos se registran al prenderse y salen al apagarse
+	void RegisterShield(UEscudoComponent* Escudo, EBulletOwner Equipo = EBulletOwner::Jugador);
+	void UnregisterShield(UEscudoComponent* Escudo);
+
+	FORCEINLINE int32 GetNumBullets() const { return Balas.Num(); }
+
+	// Integra posiciones y descuenta vida; las balas vencidas o fuera del area se quitan (FBulletKernel). Es estatico para poder medirlo sin mundo
+	static void Integrar(FBulletSoA& InBalas, float DeltaTime);
+
+	// Pares (bala, objetivo) que chocaron este cuadro, a lo sumo uno por bala y en orden de bala.
+	// Las balas que avanzan mas de UmbralBarrido en el cuadro se prueban con un barrido desde su
+	// posicion anterior, contra el objetivo moviendose de PosicionesAnteriores a Posiciones
+	static void BuscarImpactos(const FBulletSoA& InBalas, const float* RadioPorTipo, const TArray<FVector>& Posiciones,
+		const TArray<FVector>& PosicionesAnteriores, const TArray<float>& Radios, const TArray<uint8>& Equipos,
+		float DeltaTime, float UmbralBarrido, TArray<FIntPoint>& OutImpactos);
+
+	// Galaga.BulletField.SweepUmbral
+	static float GetUmbralBarrido();
+
+	// Primer instante en [0, 1] en que el punto que va de A0 a A1 queda a distancia <= Radio del origen, o -1
+	static float TiempoDeImpacto(const FVector& A0, const FVector& A1, float Radio);
+
+private:
+	void ActualizarObjetivos();
+	void AplicarImpactos();
+	void AplicarDanoArea(const TArray<float>& DanoPorObjetivo, FName Tipo);
+	int32 AbsorberEnEscudos(float DeltaTime);
+	void ActualizarInstancias();
+
+	FBulletSoA Balas;
+
+	TArray<FBulletTarget> Objetivos;
+
+	// Copia por cuadro de los objetivos para no tocar los actores dentro del bucle
+	TArray<FVector> ObjetivoPosicion;
+	TArray<FVector> ObjetivoAnterior;
+	TArray<float> ObjetivoRadio;
+	TArray<uint8> ObjetivoEquipo;
+
+	TArray<FIntPoint> Impactos;
+
+	// Indice de los objetivos del cuadro para el guiado de los misiles, las explosiones y los rayos
+	FSpatialGrid Rejilla;
+	FBulletHoming Guiado;
+	FBulletExplosion Explosion;
+	FBulletBeams Rayos;
+	FBulletCancel Cancelacion;
+	float CancelacionRestante = 0.0f;
+
+	TArray<FBulletShieldTarget> Escudos;
+	FBulletShields Absorcion;
+	TArray<float> DanoExplosion;
+	TArray<float> DanoRayos;
+
+	// Radio de colision de cada arquetipo, sale de los bounds de la malla escalada
+	TArray<float> RadioTipo;
+	TArray<float> DanoTipo;
+
+	UPROPERTY()
+	UProjectileArchetypeSubsystem* Arquetipos;
+
+	UPROPERTY()
+	AActor* Anfitrion;
+
+	UPROPERTY()
+	TArray<UInstancedStaticMeshComponent*> Instancias;
+
+	TArray<TArray<FTransform>> TransformsPorTipo;
+};
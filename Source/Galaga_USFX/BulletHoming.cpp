@@ -0,0 +1,202 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BulletHoming.h"
+#include "Galaga_USFX.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+
+void FBulletHoming::SetNumTipos(int32 NumTipos)
+{
+	Teledirigido.SetNumZeroed(NumTipos);
+	GiroMaximo.SetNumZeroed(NumTipos);
+	Aceleracion.SetNumZeroed(NumTipos);
+	VelocidadMaxima.SetNumZeroed(NumTipos);
+	NumTeledirigidos = 0;
+}
+
+void FBulletHoming::SetTipo(int32 Tipo, bool bTeledirigido, float GiroMaximoGrados, float InAceleracion, float InVelocidadMaxima)
+{
+	if (!Teledirigido.IsValidIndex(Tipo))
+	{
+		return;
+	}
+
+	NumTeledirigidos += (int32)bTeledirigido - (int32)Teledirigido[Tipo];
+	Teledirigido[Tipo] = bTeledirigido ? 1 : 0;
+	GiroMaximo[Tipo] = FMath::DegreesToRadians(GiroMaximoGrados);
+	Aceleracion[Tipo] = InAceleracion;
+	VelocidadMaxima[Tipo] = InVelocidadMaxima;
+}
+
+void FBulletHoming::Juntar(const FBulletSoA& Balas)
+{
+	Misiles.Reset();
+	Consultas.Reset();
+	EquiposConsulta.Reset();
+
+	for (int32 i = 0; i < Balas.Num(); ++i)
+	{
+		if (Teledirigido[Balas.Tipo[i]])
+		{
+			Misiles.Add(i);
+			Consultas.Add(Balas.GetPosicion(i));
+			EquiposConsulta.Add(Balas.Dueno[i]);
+		}
+	}
+}
+
+int32 FBulletHoming::Guiar(FBulletSoA& Balas, const FSpatialGrid& Rejilla, const TArray<uint8>& Equipos, float DeltaTime)
+{
+	if (NumTeledirigidos == 0)
+	{
+		return 0;
+	}
+
+	Juntar(Balas);
+	if (Misiles.Num() > 0)
+	{
+		// Una sola consulta en lote para todos los misiles del cuadro
+		Rejilla.BuscarMasCercanos(Consultas, EquiposConsulta, RadioBusqueda, Equipos, Resultados);
+		Girar(Balas, Rejilla.GetPosiciones(), DeltaTime);
+	}
+	return Misiles.Num();
+}
+
+int32 FBulletHoming::GuiarFuerzaBruta(FBulletSoA& Balas, const TArray<FVector>& Posiciones, const TArray<uint8>& Equipos, float DeltaTime)
+{
+	if (NumTeledirigidos == 0)
+	{
+		return 0;
+	}
+
+	Juntar(Balas);
+	Resultados.SetNumUninitialized(Misiles.Num(), false);
+	for (int32 m = 0; m < Misiles.Num(); ++m)
+	{
+		int32 Mejor = INDEX_NONE;
+		float MejorDistancia = RadioBusqueda * RadioBusqueda;
+		for (int32 Objetivo = 0; Objetivo < Posiciones.Num(); ++Objetivo)
+		{
+			if (Equipos[Objetivo] == EquiposConsulta[m])
+			{
+				continue;
+			}
+			const float Distancia = FVector::DistSquared(Consultas[m], Posiciones[Objetivo]);
+			if (Distancia < MejorDistancia)
+			{
+				MejorDistancia = Distancia;
+				Mejor = Objetivo;
+			}
+		}
+		Resultados[m] = Mejor;
+	}
+	Girar(Balas, Posiciones, DeltaTime);
+	return Misiles.Num();
+}
+
+void FBulletHoming::Girar(FBulletSoA& Balas, const TArray<FVector>& Posiciones, float DeltaTime)
+{
+	for (int32 m = 0; m < Misiles.Num(); ++m)
+	{
+		const int32 i = Misiles[m];
+		const uint8 Tipo = Balas.Tipo[i];
+
+		const FVector2D Velocidad(Balas.VelX[i], Balas.VelY[i]);
+		const float Rapidez = Velocidad.Size();
+		if (Rapidez <= KINDA_SMALL_NUMBER)
+		{
+			continue;
+		}
+
+		// Acelera desde la velocidad de lanzamiento hasta la maxima, como el MaxSpeed del misil
+		const float NuevaRapidez = FMath::Min(Rapidez + Aceleracion[Tipo] * DeltaTime, FMath::Max(VelocidadMaxima[Tipo], Rapidez));
+		FVector2D Direccion = Velocidad / Rapidez;
+
+		const int32 Objetivo = Resultados[m];
+		if (Objetivo != INDEX_NONE)
+		{
+			const FVector2D Hacia = FVector2D(Posiciones[Objetivo].X - Consultas[m].X, Posiciones[Objetivo].Y - Consultas[m].Y).GetSafeNormal();
+			if (!Hacia.IsZero())
+			{
+				// Angulo con signo entre la direccion actual y la del objetivo, recortado al giro del cuadro
+				const float Angulo = FMath::Atan2(Direccion ^ Hacia, Direccion | Hacia);
+				const float Tope = GiroMaximo[Tipo] * DeltaTime;
+				const float Giro = FMath::Clamp(Angulo, -Tope, Tope);
+
+				float Seno, Coseno;
+				FMath::SinCos(&Seno, &Coseno, Giro);
+				Direccion = FVector2D(Direccion.X * Coseno - Direccion.Y * Seno, Direccion.X * Seno + Direccion.Y * Coseno);
+			}
+		}
+
+		Balas.VelX[i] = Direccion.X * NuevaRapidez;
+		Balas.VelY[i] = Direccion.Y * NuevaRapidez;
+	}
+}
+
+// Galaga.Homing.Bench [Objetivos] [Cuadros]: costo de resolver objetivos segun la cantidad de misiles
+static void BenchGuiado(const TArray<FString>& Args)
+{
+	const int32 NumObjetivos = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 31;
+	const int32 Cuadros = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 300;
+	const float DeltaTime = 1.0f / 60.0f;
+
+	FRandomStream Azar(1234);
+	TArray<FVector> Posiciones;
+	TArray<uint8> Equipos;
+	for (int32 i = 0; i < NumObjetivos; ++i)
+	{
+		Posiciones.Add(FVector(Azar.FRandRange(-1500.0f, 1500.0f), Azar.FRandRange(-1500.0f, 1500.0f), 200.0f));
+		Equipos.Add(i % 2 == 0 ? 1 : 0);
+	}
+
+	FBulletHoming Guiado;
+	Guiado.SetNumTipos(1);
+	Guiado.SetTipo(0, true, 90.0f, 1000.0f, 2000.0f);
+
+	FSpatialGrid Rejilla;
+	Rejilla.Configurar(1600.0f, 200.0f);
+
+	const int32 Cantidades[] = { 100, 250, 500, 1000, 2000, 4000 };
+	for (int32 Cantidad : Cantidades)
+	{
+		double Tiempos[2] = { 0.0, 0.0 };
+		for (int32 Modo = 0; Modo < 2; ++Modo)
+		{
+			// La misma poblacion para los dos modos; sin integrar, solo el costo del guiado
+			FRandomStream AzarMisiles(Cantidad);
+			FBulletSoA Misiles;
+			Misiles.Reserve(Cantidad);
+			for (int32 i = 0; i < Cantidad; ++i)
+			{
+				Misiles.Add(FVector(AzarMisiles.FRandRange(-1600.0f, 1600.0f), AzarMisiles.FRandRange(-1600.0f, 1600.0f), 200.0f),
+					FVector(-1000.0f, 0.0f, 0.0f), 3.0f, 0, (uint8)AzarMisiles.RandHelper(2));
+			}
+
+			const double Inicio = FPlatformTime::Seconds();
+			for (int32 Cuadro = 0; Cuadro < Cuadros; ++Cuadro)
+			{
+				if (Modo == 0)
+				{
+					Rejilla.Construir(Posiciones);
+					Guiado.Guiar(Misiles, Rejilla, Equipos, DeltaTime);
+				}
+				else
+				{
+					Guiado.GuiarFuerzaBruta(Misiles, Posiciones, Equipos, DeltaTime);
+				}
+			}
+			Tiempos[Modo] = FPlatformTime::Seconds() - Inicio;
+		}
+
+		const double Cuadro = 1000.0 / FMath::Max(Cuadros, 1);
+		UE_LOG(LogGalaga_USFX, Display, TEXT("Homing bench: %5d misiles, %d objetivos: rejilla %.3f ms, fuerza bruta %.3f ms por cuadro (x%.2f)"),
+			Cantidad, NumObjetivos, Tiempos[0] * Cuadro, Tiempos[1] * Cuadro, Tiempos[0] > 0.0 ? Tiempos[1] / Tiempos[0] : 0.0);
+	}
+}
+
+static FAutoConsoleCommand CmdBenchGuiado(
+	TEXT("Galaga.Homing.Bench"),
+	TEXT("Galaga.Homing.Bench [Objetivos=31] [Cuadros=300]: costo por cuadro del guiado de misiles (rejilla vs fuerza bruta) con 100 a 4000 misiles"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchGuiado));
@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BulletSoA.h"
+#include "SpatialGrid.h"
+
+/**
+ * Guiado de las balas teledirigidas del campo (los misiles de ANaveEnemigaTransporte).
+ * Cada cuadro junta las balas de los tipos teledirigidos, resuelve su objetivo con una
+ * sola consulta en lote a la FSpatialGrid de objetivos y gira la velocidad de cada una
+ * hacia el suyo sin pasar de GiroMaximo, acelerando hasta VelocidadMaxima.
+ * El juego es plano, asi que el giro es en XY y VelZ no se toca.
+ */
+struct GALAGA_USFX_API FBulletHoming
+{
+	// Parametros por tipo de bala (indice de arquetipo)
+	void SetNumTipos(int32 NumTipos);
+	void SetTipo(int32 Tipo, bool bTeledirigido, float GiroMaximoGrados, float Aceleracion, float VelocidadMaxima);
+
+	FORCEINLINE bool HayTeledirigidos() const { return NumTeledirigidos > 0; }
+
+	// Devuelve cuantas balas se guiaron. Equipos es el equipo de cada punto de la rejilla
+	int32 Guiar(FBulletSoA& Balas, const FSpatialGrid& Rejilla, const TArray<uint8>& Equipos, float DeltaTime);
+
+	// Lo mismo que Guiar pero recorriendo todos los objetivos por misil; solo para comparar en el bench
+	int32 GuiarFuerzaBruta(FBulletSoA& Balas, const TArray<FVector>& Posiciones, const TArray<uint8>& Equipos, float DeltaTime);
+
+	// Distancia maxima a la que un misil elige objetivo; por defecto todo el area de juego
+	float RadioBusqueda = 3200.0f;
+
+private:
+	void Juntar(const FBulletSoA& Balas);
+	void Girar(FBulletSoA& Balas, const TArray<FVector>& Posiciones, float DeltaTime);
+
+	TArray<uint8> Teledirigido;
+	TArray<float> GiroMaximo;      // radianes por segundo
+	TArray<float> Aceleracion;
+	TArray<float> VelocidadMaxima;
+	int32 NumTeledirigidos = 0;
+
+	// Buffers del cuadro, se reutilizan
+	TArray<int32> Misiles;
+	TArray<FVector> Consultas;
+	TArray<uint8> EquiposConsulta;
+	TArray<int32> Resultados;
+};
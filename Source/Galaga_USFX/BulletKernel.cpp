@@ -0,0 +1,355 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BulletKernel.h"
+#include "Galaga_USFX.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "ProjectilePool.h"
+#include "DisparoBasic.h"
+
+#define BULLETKERNEL_CON_AVX2 (PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_CPU_X86_FAMILY && PLATFORM_64BITS)
+
+#if BULLETKERNEL_CON_AVX2
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define BULLETKERNEL_AVX2_TARGET
+#else
+// clang/gcc solo emiten AVX2 en funciones marcadas, el resto del modulo sigue en SSE
+#define BULLETKERNEL_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+static TAutoConsoleVariable<int32> CVarBulletKernelPath(
+	TEXT("Galaga.BulletKernel.Path"),
+	-1,
+	TEXT("Kernel de integracion del campo de balas. -1: el mas ancho que soporte la CPU, 0: escalar, 1: VectorRegister, 2: AVX2."));
+
+static bool TieneAVX2()
+{
+#if BULLETKERNEL_CON_AVX2
+#if defined(_MSC_VER) && !defined(__clang__)
+	int Info[4];
+	__cpuid(Info, 0);
+	if (Info[0] < 7)
+	{
+		return false;
+	}
+	__cpuid(Info, 1);
+	const bool bOSXSAVE = (Info[2] & (1 << 27)) != 0;
+	const bool bAVX = (Info[2] & (1 << 28)) != 0;
+	// El sistema operativo tiene que guardar los registros YMM en los cambios de contexto
+	if (!bOSXSAVE || !bAVX || (_xgetbv(0) & 0x6) != 0x6)
+	{
+		return false;
+	}
+	__cpuidex(Info, 7, 0);
+	return (Info[1] & (1 << 5)) != 0;
+#else
+	return __builtin_cpu_supports("avx2");
+#endif
+#else
+	return false;
+#endif
+}
+
+// Mueve las balas vivas de un bloque [Inicio, Inicio + Ancho) a partir de Escritura
+static FORCEINLINE int32 CompactarBloque(FBulletSoA& Balas, int32 Inicio, int32 Ancho, int32 Mascara, int32 Escritura)
+{
+	const int32 Llena = (1 << Ancho) - 1;
+	if (Mascara == Llena && Escritura == Inicio)
+	{
+		return Escritura + Ancho;
+	}
+
+	for (int32 Carril = 0; Carril < Ancho; ++Carril)
+	{
+		if (Mascara & (1 << Carril))
+		{
+			if (Escritura != Inicio + Carril)
+			{
+				Balas.Copiar(Inicio + Carril, Escritura);
+			}
+			++Escritura;
+		}
+	}
+	return Escritura;
+}
+
+// Version escalar; los kernels anchos la usan para las balas que sobran al final
+static int32 IntegrarRestoEscalar(FBulletSoA& Balas, float DeltaTime, int32 Inicio, int32 Escritura)
+{
+	const float Limite = FBulletKernel::LimiteCampo;
+	const int32 Num = Balas.Num();
+	for (int32 i = Inicio; i < Num; ++i)
+	{
+		const float X = Balas.PosX[i] + Balas.VelX[i] * DeltaTime;
+		const float Y = Balas.PosY[i] + Balas.VelY[i] * DeltaTime;
+		const float Z = Balas.PosZ[i] + Balas.VelZ[i] * DeltaTime;
+		const float Vida = Balas.Vida[i] - DeltaTime;
+
+		if (Vida > 0.0f && FMath::Abs(X) <= Limite && FMath::Abs(Y) <= Limite)
+		{
+			if (Escritura != i)
+			{
+				Balas.Copiar(i, Escritura);
+			}
+			Balas.PosX[Escritura] = X;
+			Balas.PosY[Escritura] = Y;
+			Balas.PosZ[Escritura] = Z;
+			Balas.Vida[Escritura] = Vida;
+			++Escritura;
+		}
+	}
+	return Escritura;
+}
+
+int32 FBulletKernel::Integrar(FBulletSoA& Balas, float DeltaTime, EBulletKernelPath Ruta)
+{
+	if (Ruta == EBulletKernelPath::AVX2 && EsRutaSoportada(EBulletKernelPath::AVX2))
+	{
+		return IntegrarAVX2(Balas, DeltaTime);
+	}
+	// Sin AVX2 cae al de 4 carriles
+	if (Ruta == EBulletKernelPath::AVX2 || Ruta == EBulletKernelPath::VectorRegister)
+	{
+		return IntegrarVectorRegister(Balas, DeltaTime);
+	}
+	return IntegrarEscalar(Balas, DeltaTime);
+}
+
+EBulletKernelPath FBulletKernel::GetRutaActiva()
+{
+	const int32 Forzada = CVarBulletKernelPath.GetValueOnGameThread();
+	if (Forzada >= 0 && Forzada < (int32)EBulletKernelPath::MAX && EsRutaSoportada((EBulletKernelPath)Forzada))
+	{
+		return (EBulletKernelPath)Forzada;
+	}
+	return EsRutaSoportada(EBulletKernelPath::AVX2) ? EBulletKernelPath::AVX2 : EBulletKernelPath::VectorRegister;
+}
+
+bool FBulletKernel::EsRutaSoportada(EBulletKernelPath Ruta)
+{
+	static const bool bAVX2 = TieneAVX2();
+	return Ruta != EBulletKernelPath::AVX2 || bAVX2;
+}
+
+const TCHAR* FBulletKernel::GetNombreRuta(EBulletKernelPath Ruta)
+{
+	switch (Ruta)
+	{
+	case EBulletKernelPath::Escalar: return TEXT("Escalar");
+	case EBulletKernelPath::VectorRegister: return TEXT("VectorRegister");
+	case EBulletKernelPath::AVX2: return TEXT("AVX2");
+	default: return TEXT("?");
+	}
+}
+
+int32 FBulletKernel::IntegrarEscalar(FBulletSoA& Balas, float DeltaTime)
+{
+	const int32 Num = Balas.Num();
+	const int32 Escritura = IntegrarRestoEscalar(Balas, DeltaTime, 0, 0);
+	Balas.Truncar(Escritura);
+	return Num - Escritura;
+}
+
+int32 FBulletKernel::IntegrarVectorRegister(FBulletSoA& Balas, float DeltaTime)
+{
+	const int32 Num = Balas.Num();
+	float* PX = Balas.PosX.GetData();
+	float* PY = Balas.PosY.GetData();
+	float* PZ = Balas.PosZ.GetData();
+	const float* VX = Balas.VelX.GetData();
+	const float* VY = Balas.VelY.GetData();
+	const float* VZ = Balas.VelZ.GetData();
+	float* Vida = Balas.Vida.GetData();
+
+	const VectorRegister Dt = VectorSetFloat1(DeltaTime);
+	const VectorRegister Limite = VectorSetFloat1(LimiteCampo);
+	const VectorRegister Cero = VectorZero();
+
+	int32 Escritura = 0;
+	int32 i = 0;
+	for (; i + 4 <= Num; i += 4)
+	{
+		const VectorRegister X = VectorMultiplyAdd(VectorLoad(VX + i), Dt, VectorLoad(PX + i));
+		const VectorRegister Y = VectorMultiplyAdd(VectorLoad(VY + i), Dt, VectorLoad(PY + i));
+		const VectorRegister Z = VectorMultiplyAdd(VectorLoad(VZ + i), Dt, VectorLoad(PZ + i));
+		const VectorRegister V = VectorSubtract(VectorLoad(Vida + i), Dt);
+
+		// Se escribe en su lugar y despues se compacta solo si el bloque tiene balas muertas
+		VectorStore(X, PX + i);
+		VectorStore(Y, PY + i);
+		VectorStore(Z, PZ + i);
+		VectorStore(V, Vida + i);
+
+		VectorRegister Vivas = VectorCompareGT(V, Cero);
+		Vivas = VectorBitwiseAnd(Vivas, VectorCompareGE(Limite, VectorAbs(X)));
+		Vivas = VectorBitwiseAnd(Vivas, VectorCompareGE(Limite, VectorAbs(Y)));
+
+		Escritura = CompactarBloque(Balas, i, 4, VectorMaskBits(Vivas), Escritura);
+	}
+
+	Escritura = IntegrarRestoEscalar(Balas, DeltaTime, i, Escritura);
+	Balas.Truncar(Escritura);
+	return Num - Escritura;
+}
+
+#if BULLETKERNEL_CON_AVX2
+BULLETKERNEL_AVX2_TARGET int32 FBulletKernel::IntegrarAVX2(FBulletSoA& Balas, float DeltaTime)
+{
+	const int32 Num = Balas.Num();
+	float* PX = Balas.PosX.GetData();
+	float* PY = Balas.PosY.GetData();
+	float* PZ = Balas.PosZ.GetData();
+	const float* VX = Balas.VelX.GetData();
+	const float* VY = Balas.VelY.GetData();
+	const float* VZ = Balas.VelZ.GetData();
+	float* Vida = Balas.Vida.GetData();
+
+	const __m256 Dt = _mm256_set1_ps(DeltaTime);
+	const __m256 Limite = _mm256_set1_ps(LimiteCampo);
+	const __m256 Cero = _mm256_setzero_ps();
+	const __m256 SinSigno = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+
+	int32 Escritura = 0;
+	int32 i = 0;
+	for (; i + 8 <= Num; i += 8)
+	{
+		// Sin FMA: mul + add da el mismo resultado que las otras rutas
+		const __m256 X = _mm256_add_ps(_mm256_loadu_ps(PX + i), _mm256_mul_ps(_mm256_loadu_ps(VX + i), Dt));
+		const __m256 Y = _mm256_add_ps(_mm256_loadu_ps(PY + i), _mm256_mul_ps(_mm256_loadu_ps(VY + i), Dt));
+		const __m256 Z = _mm256_add_ps(_mm256_loadu_ps(PZ + i), _mm256_mul_ps(_mm256_loadu_ps(VZ + i), Dt));
+		const __m256 V = _mm256_sub_ps(_mm256_loadu_ps(Vida + i), Dt);
+
+		_mm256_storeu_ps(PX + i, X);
+		_mm256_storeu_ps(PY + i, Y);
+		_mm256_storeu_ps(PZ + i, Z);
+		_mm256_storeu_ps(Vida + i, V);
+
+		__m256 Vivas = _mm256_cmp_ps(V, Cero, _CMP_GT_OQ);
+		Vivas = _mm256_and_ps(Vivas, _mm256_cmp_ps(_mm256_and_ps(X, SinSigno), Limite, _CMP_LE_OQ));
+		Vivas = _mm256_and_ps(Vivas, _mm256_cmp_ps(_mm256_and_ps(Y, SinSigno), Limite, _CMP_LE_OQ));
+
+		Escritura = CompactarBloque(Balas, i, 8, _mm256_movemask_ps(Vivas), Escritura);
+	}
+
+	Escritura = IntegrarRestoEscalar(Balas, DeltaTime, i, Escritura);
+	Balas.Truncar(Escritura);
+	return Num - Escritura;
+}
+#else
+int32 FBulletKernel::IntegrarAVX2(FBulletSoA& Balas, float DeltaTime)
+{
+	return IntegrarVectorRegister(Balas, DeltaTime);
+}
+#endif
+
+static void LlenarBalasPrueba(FBulletSoA& Balas, int32 Cantidad, FRandomStream& Azar)
+{
+	Balas.Reset();
+	Balas.Reserve(Cantidad);
+	for (int32 i = 0; i < Cantidad; ++i)
+	{
+		const FVector Direccion = FVector(Azar.FRandRange(-1.0f, 1.0f), Azar.FRandRange(-1.0f, 1.0f), 0.0f).GetSafeNormal();
+		Balas.Add(FVector(Azar.FRandRange(-1600.0f, 1600.0f), Azar.FRandRange(-1600.0f, 1600.0f), 200.0f),
+			Direccion * 2000.0f, Azar.FRandRange(0.5f, 3.0f), 0, 0);
+	}
+}
+
+// Galaga.BulletKernel.Bench [Balas] [Cuadros] [Proyectiles]
+static void BenchKernel(const TArray<FString>& Args, UWorld* World)
+{
+	const int32 Cantidad = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 10000;
+	const int32 Cuadros = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 600;
+	const int32 Proyectiles = Args.Num() > 2 ? FCString::Atoi(*Args[2]) : 500;
+	const float DeltaTime = 1.0f / 60.0f;
+
+	FBulletSoA Balas;
+	double NsEscalar = 0.0;
+	for (int32 Ruta = 0; Ruta < (int32)EBulletKernelPath::MAX; ++Ruta)
+	{
+		if (!FBulletKernel::EsRutaSoportada((EBulletKernelPath)Ruta))
+		{
+			UE_LOG(LogGalaga_USFX, Display, TEXT("BulletKernel %s: no soportado en esta CPU"), FBulletKernel::GetNombreRuta((EBulletKernelPath)Ruta));
+			continue;
+		}
+
+		// Misma semilla en todas las rutas: las balas que quedan deben coincidir
+		FRandomStream Azar(1234);
+		LlenarBalasPrueba(Balas, Cantidad, Azar);
+
+		double Total = 0.0;
+		int32 Procesadas = 0;
+		for (int32 Cuadro = 0; Cuadro < Cuadros; ++Cuadro)
+		{
+			if (Balas.Num() < Cantidad / 2)
+			{
+				LlenarBalasPrueba(Balas, Cantidad, Azar);
+			}
+			Procesadas += Balas.Num();
+
+			const double Inicio = FPlatformTime::Seconds();
+			FBulletKernel::Integrar(Balas, DeltaTime, (EBulletKernelPath)Ruta);
+			Total += FPlatformTime::Seconds() - Inicio;
+		}
+
+		const double NsPorBala = Total * 1.0e9 / FMath::Max(Procesadas, 1);
+		if (Ruta == (int32)EBulletKernelPath::Escalar)
+		{
+			NsEscalar = NsPorBala;
+		}
+		UE_LOG(LogGalaga_USFX, Display, TEXT("BulletKernel %s: %.3f ms por cuadro, %.2f ns por bala (x%.2f sobre escalar), quedan %d"),
+			FBulletKernel::GetNombreRuta((EBulletKernelPath)Ruta), Total * 1000.0 / FMath::Max(Cuadros, 1), NsPorBala,
+			NsPorBala > 0.0 ? NsEscalar / NsPorBala : 0.0, Balas.Num());
+	}
+
+	// Referencia: el camino de antes, un UProjectileMovementComponent por bala
+	UProjectilePoolSubsystem* Pool = World ? World->GetSubsystem<UProjectilePoolSubsystem>() : nullptr;
+	if (Pool == nullptr || Proyectiles <= 0)
+	{
+		return;
+	}
+
+	TArray<UProjectileMovementComponent*> Movimientos;
+	TArray<AActor*> Actores;
+	FRandomStream Azar(1234);
+	for (int32 i = 0; i < Proyectiles; ++i)
+	{
+		const FVector Posicion(Azar.FRandRange(-1600.0f, 1600.0f), Azar.FRandRange(-1600.0f, 1600.0f), 200.0f);
+		AActor* Proyectil = Pool->Acquire(ADisparoBasic::StaticClass(), Posicion, FRotator(0.0f, Azar.FRandRange(0.0f, 360.0f), 0.0f));
+		if (UProjectileMovementComponent* Movimiento = Proyectil ? Proyectil->FindComponentByClass<UProjectileMovementComponent>() : nullptr)
+		{
+			Actores.Add(Proyectil);
+			Movimientos.Add(Movimiento);
+		}
+	}
+
+	const int32 CuadrosComponentes = FMath::Min(Cuadros, 60);
+	const double Inicio = FPlatformTime::Seconds();
+	for (int32 Cuadro = 0; Cuadro < CuadrosComponentes; ++Cuadro)
+	{
+		for (UProjectileMovementComponent* Movimiento : Movimientos)
+		{
+			Movimiento->TickComponent(DeltaTime, LEVELTICK_All, nullptr);
+		}
+	}
+	const double Total = FPlatformTime::Seconds() - Inicio;
+
+	for (AActor* Proyectil : Actores)
+	{
+		Pool->Release(Proyectil);
+	}
+
+	const double NsPorBala = Total * 1.0e9 / FMath::Max(Movimientos.Num() * CuadrosComponentes, 1);
+	UE_LOG(LogGalaga_USFX, Display, TEXT("UProjectileMovementComponent: %d proyectiles, %.2f ns por bala (x%.2f sobre escalar)"),
+		Movimientos.Num(), NsPorBala, NsPorBala > 0.0 ? NsEscalar / NsPorBala : 0.0);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CmdBenchKernel(
+	TEXT("Galaga.BulletKernel.Bench"),
+	TEXT("Galaga.BulletKernel.Bench [Balas=10000] [Cuadros=600] [Proyectiles=500]: compara las rutas del kernel entre si y con un UProjectileMovementComponent por bala"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&BenchKernel));
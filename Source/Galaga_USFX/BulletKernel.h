@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BulletSoA.h"
+
+// Implementaciones del kernel de integracion, de la mas simple a la mas ancha
+enum class EBulletKernelPath : uint8
+{
+	Escalar,         // un float por iteracion, sirve en cualquier CPU
+	VectorRegister,  // 4 floats con VectorRegister (SSE en x86, NEON en ARM)
+	AVX2,            // 8 floats con intrinsics AVX2, solo si la CPU lo soporta
+	MAX
+};
+
+/**
+ * Kernel de movimiento en linea recta de las balas del UBulletFieldSubsystem.
+ * Ningun proyectil usa gravedad (ProjectileGravityScale = 0), asi que la actualizacion es
+ * p += v*dt; vida -= dt. En la misma pasada se descartan las balas vencidas o fuera del
+ * area de juego y se compacta el arreglo conservando el orden.
+ */
+struct GALAGA_USFX_API FBulletKernel
+{
+	// Mitad del lado del area de juego en X e Y; fuera de ella la bala ya no se ve
+	static constexpr float LimiteCampo = 1600.0f;
+
+	// Integra, descarta y compacta. Devuelve cuantas balas se quitaron
+	static int32 Integrar(FBulletSoA& Balas, float DeltaTime, EBulletKernelPath Ruta);
+
+	// Ruta elegida segun la CPU y Galaga.BulletKernel.Path
+	static EBulletKernelPath GetRutaActiva();
+
+	static bool EsRutaSoportada(EBulletKernelPath Ruta);
+	static const TCHAR* GetNombreRuta(EBulletKernelPath Ruta);
+
+private:
+	static int32 IntegrarEscalar(FBulletSoA& Balas, float DeltaTime);
+	static int32 IntegrarVectorRegister(FBulletSoA& Balas, float DeltaTime);
+	static int32 IntegrarAVX2(FBulletSoA& Balas, float DeltaTime);
+};
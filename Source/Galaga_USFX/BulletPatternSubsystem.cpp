@@ -0,0 +1,233 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BulletPatternSubsystem.h"
+#include "Galaga_USFX.h"
+#include "WeaponsSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "GameFramework/Pawn.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DECLARE_CYCLE_STAT(TEXT("Patrones"), STAT_BulletPattern_Ejecutar, STATGROUP_BulletField);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Emisores de patrones"), STAT_BulletPattern_Emisores, STATGROUP_BulletField);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Balas de patrones descartadas"), STAT_BulletPattern_Descartadas, STATGROUP_BulletField);
+
+// Galaga.Pattern.Bench [Emisores] [Cuadros]: corre Emisores copias del patron Nodriza sin mundo
+static void BenchPatrones(const TArray<FString>& Args)
+{
+	const int32 Cantidad = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 100;
+	const int32 Cuadros = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 600;
+	const float DeltaTime = 1.0f / 60.0f;
+
+	FBulletPatternVM VM;
+	FString Texto;
+	FString Ruta;
+	FString Error;
+	if (!UBulletPatternSubsystem::LeerArchivoPatrones(Texto, Ruta))
+	{
+		UE_LOG(LogGalaga_USFX, Warning, TEXT("Pattern bench: no se pudo leer %s"), *Ruta);
+		return;
+	}
+	if (!VM.Compilar(Texto, [](FName) { return 0; }, Error))
+	{
+		UE_LOG(LogGalaga_USFX, Warning, TEXT("Pattern bench: %s"), *Error);
+		return;
+	}
+
+	// Cada Nodriza tiene a lo sumo una espiral hija viva a la vez
+	VM.Reservar(Cantidad * 2, 4096);
+	const int32 Nodriza = VM.FindPrograma(TEXT("Nodriza"));
+	for (int32 i = 0; i < Cantidad; ++i)
+	{
+		VM.Iniciar(Nodriza, FVector(1000.0f, -1000.0f + 2000.0f * i / FMath::Max(Cantidad - 1, 1), 200.0f), 180.0f, 0, 0);
+	}
+
+	float VelocidadTipo[MAX_uint8 + 1];
+	for (float& Velocidad : VelocidadTipo)
+	{
+		Velocidad = 1000.0f;
+	}
+
+	FBulletPatternSalida Salida;
+	const FVector Jugador(-1000.0f, 0.0f, 200.0f);
+
+	// Un cuadro de calentamiento; despues la memoria no deberia crecer
+	VM.Ejecutar(DeltaTime, Jugador, VelocidadTipo, Salida);
+	VM.Limpiar();
+	const SIZE_T Memoria = Salida.Posiciones.GetAllocatedSize();
+
+	int32 Balas = 0;
+	int32 MaxBalas = 0;
+	int32 Descartadas = 0;
+	const double Inicio = FPlatformTime::Seconds();
+	for (int32 Cuadro = 0; Cuadro < Cuadros; ++Cuadro)
+	{
+		VM.Ejecutar(DeltaTime, Jugador, VelocidadTipo, Salida);
+		VM.Limpiar();
+		Balas += Salida.Num();
+		MaxBalas = FMath::Max(MaxBalas, Salida.Num());
+		Descartadas += Salida.Descartadas;
+	}
+	const double Total = FPlatformTime::Seconds() - Inicio;
+
+	UE_LOG(LogGalaga_USFX, Display, TEXT("Pattern bench: %d emisores (%d vivos), %.1f balas por cuadro (max %d), %d descartadas por el tope, %.4f ms por cuadro, memoria de salida %s"),
+		Cantidad, VM.NumEmisores(), (float)Balas / FMath::Max(Cuadros, 1), MaxBalas, Descartadas, Total * 1000.0 / FMath::Max(Cuadros, 1),
+		Salida.Posiciones.GetAllocatedSize() == Memoria ? TEXT("estable") : TEXT("crecio"));
+}
+
+static FAutoConsoleCommand CmdBenchPatrones(
+	TEXT("Galaga.Pattern.Bench"),
+	TEXT("Galaga.Pattern.Bench [Emisores=100] [Cuadros=600]: corre emisores del patron Nodriza en la VM de patrones"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchPatrones));
+
+bool UBulletPatternSubsystem::LeerArchivoPatrones(FString& OutTexto, FString& OutRuta)
+{
+	OutRuta = FPaths::ProjectContentDir() / GetDefault<UBulletPatternSubsystem>()->ArchivoPatrones;
+	return FFileHelper::LoadFileToString(OutTexto, *OutRuta);
+}
+
+bool UBulletPatternSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World != nullptr && World->IsGameWorld();
+}
+
+void UBulletPatternSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Armas = Collection.InitializeDependency<UWeaponsSubsystem>();
+	UProjectileArchetypeSubsystem* Arquetipos = Collection.InitializeDependency<UProjectileArchetypeSubsystem>();
+
+	for (float& Velocidad : VelocidadTipo)
+	{
+		Velocidad = 0.0f;
+	}
+	for (int32 Tipo = 0; Arquetipos && Tipo < Arquetipos->Num(); ++Tipo)
+	{
+		VelocidadTipo[Tipo] = Arquetipos->Get(Tipo).Velocidad;
+	}
+
+	auto ResolverTipo = [Arquetipos](FName Nombre)
+	{
+		return Arquetipos ? Arquetipos->FindHandle(Nombre).Indice : INDEX_NONE;
+	};
+
+	// Los patrones se compilan una sola vez, nunca durante el juego. El archivo es la unica
+	// fuente: sin el los jefes no tienen patrones
+	FString Texto;
+	FString Ruta;
+	FString Error;
+	if (!LeerArchivoPatrones(Texto, Ruta))
+	{
+		UE_LOG(LogGalaga_USFX, Error, TEXT("No se pudo leer el archivo de patrones %s"), *Ruta);
+	}
+	else if (VM.Compilar(Texto, ResolverTipo, Error))
+	{
+		UE_LOG(LogGalaga_USFX, Log, TEXT("Patrones de disparo: %d compilados de %s"), VM.NumProgramas(), *Ruta);
+	}
+	else
+	{
+		UE_LOG(LogGalaga_USFX, Error, TEXT("Error en %s, %s"), *Ruta, *Error);
+	}
+
+	VM.Reservar(MaxEmisores, MaxBalasPorCuadro);
+}
+
+void UBulletPatternSubsystem::Deinitialize()
+{
+	Armas = nullptr;
+
+	Super::Deinitialize();
+}
+
+void UBulletPatternSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BulletPattern_Ejecutar);
+
+	// Los emisores se mueven con su nave antes de correr
+	for (int32 i = 0; i < VM.NumEmisores(); ++i)
+	{
+		FBulletEmitter& Emisor = VM.GetEmisor(i);
+		if (AActor* Fuente = Emisor.Fuente.Get())
+		{
+			Emisor.Origen = Fuente->GetActorLocation() + Emisor.Offset;
+		}
+	}
+
+	const APawn* Jugador = UGameplayStatics::GetPlayerPawn(GetWorld(), 0);
+	const FVector PosicionJugador = Jugador ? Jugador->GetActorLocation() : FVector::ZeroVector;
+
+	VM.Ejecutar(DeltaTime, PosicionJugador, VelocidadTipo, Salida);
+	VM.Limpiar();
+
+	// Todas las balas del cuadro en un solo lote
+	if (Armas && Salida.Num() > 0)
+	{
+		Armas->LaunchBatch(Salida.Posiciones, Salida.Velocidades, Salida.Tipos, Salida.Duenos);
+	}
+	INC_DWORD_STAT_BY(STAT_BulletPattern_Descartadas, Salida.Descartadas);
+	SET_DWORD_STAT(STAT_BulletPattern_Emisores, VM.NumEmisores());
+}
+
+ETickableTickType UBulletPatternSubsystem::GetTickableTickType() const
+{
+	return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UBulletPatternSubsystem::IsTickable() const
+{
+	return VM.NumEmisores() > 0;
+}
+
+TStatId UBulletPatternSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBulletPatternSubsystem, STATGROUP_Tickables);
+}
+
+bool UBulletPatternSubsystem::Iniciar(FName Patron, AActor* Fuente, const FVector& Offset, float Angulo, FProjectileArchetypeHandle Arquetipo, EBulletOwner Dueno)
+{
+	const int32 Programa = VM.FindPrograma(Patron);
+	if (Programa == INDEX_NONE || Fuente == nullptr || !Arquetipo.IsValid())
+	{
+		return false;
+	}
+
+	const int32 Indice = VM.Iniciar(Programa, Fuente->GetActorLocation() + Offset, Angulo, (uint8)Arquetipo.Indice, (uint8)Dueno);
+	if (Indice == INDEX_NONE)
+	{
+		return false;
+	}
+
+	FBulletEmitter& Emisor = VM.GetEmisor(Indice);
+	Emisor.Fuente = Fuente;
+	Emisor.Offset = Offset;
+	return true;
+}
+
+bool UBulletPatternSubsystem::TieneEmisor(const AActor* Fuente) const
+{
+	for (int32 i = 0; i < VM.NumEmisores(); ++i)
+	{
+		if (VM.GetEmisor(i).Fuente.Get() == Fuente)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void UBulletPatternSubsystem::Detener(const AActor* Fuente)
+{
+	for (int32 i = 0; i < VM.NumEmisores(); ++i)
+	{
+		FBulletEmitter& Emisor = VM.GetEmisor(i);
+		if (Emisor.Fuente.Get() == Fuente)
+		{
+			Emisor.Programa = INDEX_NONE;
+		}
+	}
+}
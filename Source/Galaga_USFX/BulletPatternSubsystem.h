@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "BulletPatternVM.h"
+#include "BulletFieldSubsystem.h"
+#include "BulletPatternSubsystem.generated.h"
+
+class UWeaponsSubsystem;
+
+/**
+ * Corre los patrones de disparo de los jefes (FBulletPatternVM). Compila el archivo de
+ * patrones al crear el mundo, mueve cada emisor con la nave que lo lanzo y entrega las
+ * balas de todos los emisores al UWeaponsSubsystem una vez por cuadro.
+ */
+UCLASS(config = Game)
+class GALAGA_USFX_API UBulletPatternSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+public:
+	// Lanza el patron desde Fuente + Offset; Angulo es el yaw inicial en grados. Falso si no existe o no hay lugar
+	bool Iniciar(FName Patron, AActor* Fuente, const FVector& Offset, float Angulo, FProjectileArchetypeHandle Arquetipo, EBulletOwner Dueno);
+
+	// Verdadero si Fuente tiene algun emisor vivo (incluidos los hijos)
+	bool TieneEmisor(const AActor* Fuente) const;
+
+	// Termina todos los emisores de Fuente, tambien los hijos; se quitan en el proximo Limpiar
+	void Detener(const AActor* Fuente);
+
+	FORCEINLINE int32 GetNumEmisores() const { return VM.NumEmisores(); }
+
+	// Lee el ArchivoPatrones configurado; OutRuta queda con la ruta completa aunque falle
+	static bool LeerArchivoPatrones(FString& OutTexto, FString& OutRuta);
+
+protected:
+	// Relativo a la carpeta Content del proyecto
+	UPROPERTY(Config)
+	FString ArchivoPatrones = TEXT("Data/BulletPatterns.txt");
+
+	UPROPERTY(Config)
+	int32 MaxEmisores = 256;
+
+	// Tope de balas que entregan todos los emisores en un cuadro, el resto se descarta
+	UPROPERTY(Config)
+	int32 MaxBalasPorCuadro = 4096;
+
+private:
+	FBulletPatternVM VM;
+	FBulletPatternSalida Salida;
+
+	// Velocidad base de cada arquetipo, indexada por el tipo de la instruccion
+	float VelocidadTipo[MAX_uint8 + 1];
+
+	UPROPERTY()
+	UWeaponsSubsystem* Armas;
+};
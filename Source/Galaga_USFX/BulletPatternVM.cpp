@@ -0,0 +1,330 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BulletPatternVM.h"
+#include "GameFramework/Actor.h"
+
+bool FBulletPatternVM::Compilar(const FString& Texto, TFunctionRef<int32(FName)> ResolverTipo, FString& OutError)
+{
+	struct FPendiente
+	{
+		int32 Programa;
+		int32 Instruccion;
+		FName Nombre;
+		int32 Linea;
+	};
+
+	Programas.Reset();
+	TArray<FPendiente> Subs;
+	TArray<int32> Bucles;
+	int32 Actual = INDEX_NONE;
+
+	TArray<FString> Lineas;
+	Texto.ParseIntoArrayLines(Lineas, false);
+	for (int32 NumLinea = 0; NumLinea < Lineas.Num(); ++NumLinea)
+	{
+		FString Linea = Lineas[NumLinea];
+		int32 Comentario;
+		if (Linea.FindChar(TEXT('#'), Comentario))
+		{
+			Linea.LeftInline(Comentario);
+		}
+
+		TArray<FString> Partes;
+		Linea.ParseIntoArrayWS(Partes);
+		if (Partes.Num() == 0)
+		{
+			continue;
+		}
+
+		const FString& Op = Partes[0];
+		auto Numero = [&Partes](int32 Indice, float PorDefecto)
+		{
+			return Partes.IsValidIndex(Indice) ? FCString::Atof(*Partes[Indice]) : PorDefecto;
+		};
+		auto Error = [&OutError, NumLinea](const FString& Mensaje)
+		{
+			OutError = FString::Printf(TEXT("linea %d: %s"), NumLinea + 1, *Mensaje);
+			return false;
+		};
+
+		if (Op == TEXT("patron"))
+		{
+			if (Actual != INDEX_NONE || Partes.Num() < 2)
+			{
+				return Error(TEXT("'patron Nombre' solo fuera de otro patron"));
+			}
+			if (FindPrograma(FName(*Partes[1])) != INDEX_NONE)
+			{
+				return Error(FString::Printf(TEXT("patron '%s' repetido"), *Partes[1]));
+			}
+			Actual = Programas.AddDefaulted();
+			Programas[Actual].Nombre = FName(*Partes[1]);
+			continue;
+		}
+
+		if (Actual == INDEX_NONE)
+		{
+			return Error(FString::Printf(TEXT("'%s' fuera de un patron"), *Op));
+		}
+
+		FBulletInstr Instr = { EBulletOp::Fin, 0, 0, 0.0f, 0.0f };
+		if (Op == TEXT("anillo"))
+		{
+			Instr.Op = EBulletOp::Anillo;
+			Instr.Cuenta = (uint16)FMath::Clamp((int32)Numero(1, 1.0f), 1, 360);
+			Instr.A = Numero(2, 1.0f);
+		}
+		else if (Op == TEXT("abanico") || Op == TEXT("apuntado"))
+		{
+			Instr.Op = Op == TEXT("abanico") ? EBulletOp::Abanico : EBulletOp::Apuntado;
+			Instr.Cuenta = (uint16)FMath::Clamp((int32)Numero(1, 1.0f), 1, 360);
+			Instr.A = Numero(2, 0.0f);
+			Instr.B = Numero(3, 1.0f);
+		}
+		else if (Op == TEXT("girar") || Op == TEXT("angulo") || Op == TEXT("esperar"))
+		{
+			Instr.Op = Op == TEXT("girar") ? EBulletOp::Girar : (Op == TEXT("angulo") ? EBulletOp::Angulo : EBulletOp::Esperar);
+			Instr.A = Numero(1, 0.0f);
+		}
+		else if (Op == TEXT("repetir"))
+		{
+			if (Bucles.Num() >= FBulletEmitter::MaxAnidamiento)
+			{
+				return Error(TEXT("demasiados repetir anidados"));
+			}
+			Instr.Op = EBulletOp::Repetir;
+			Instr.Cuenta = (uint16)FMath::Clamp((int32)Numero(1, 0.0f), 0, (int32)MAX_uint16);
+			Bucles.Add(Programas[Actual].Codigo.Num());
+		}
+		else if (Op == TEXT("fin"))
+		{
+			if (Bucles.Num() > 0)
+			{
+				Instr.Op = EBulletOp::FinRepetir;
+				Bucles.Pop();
+			}
+			else
+			{
+				Programas[Actual].Codigo.Add(Instr);
+				Actual = INDEX_NONE;
+				continue;
+			}
+		}
+		else if (Op == TEXT("sub"))
+		{
+			if (Partes.Num() < 2)
+			{
+				return Error(TEXT("falta el patron de 'sub'"));
+			}
+			// El patron puede estar mas abajo, se resuelve al final
+			Instr.Op = EBulletOp::Sub;
+			Subs.Add({ Actual, Programas[Actual].Codigo.Num(), FName(*Partes[1]), NumLinea });
+		}
+		else if (Op == TEXT("arquetipo"))
+		{
+			const int32 Tipo = Partes.Num() > 1 ? ResolverTipo(FName(*Partes[1])) : INDEX_NONE;
+			if (Tipo == INDEX_NONE || Tipo > MAX_uint8)
+			{
+				return Error(TEXT("arquetipo desconocido"));
+			}
+			Instr.Op = EBulletOp::Arquetipo;
+			Instr.Tipo = (uint8)Tipo;
+		}
+		else
+		{
+			return Error(FString::Printf(TEXT("instruccion desconocida '%s'"), *Op));
+		}
+		Programas[Actual].Codigo.Add(Instr);
+	}
+
+	if (Actual != INDEX_NONE)
+	{
+		OutError = FString::Printf(TEXT("falta 'fin' en el patron '%s'"), *Programas[Actual].Nombre.ToString());
+		return false;
+	}
+
+	for (const FPendiente& Sub : Subs)
+	{
+		const int32 Programa = FindPrograma(Sub.Nombre);
+		if (Programa == INDEX_NONE)
+		{
+			OutError = FString::Printf(TEXT("linea %d: no existe el patron '%s'"), Sub.Linea + 1, *Sub.Nombre.ToString());
+			return false;
+		}
+		Programas[Sub.Programa].Codigo[Sub.Instruccion].Cuenta = (uint16)Programa;
+	}
+	return true;
+}
+
+int32 FBulletPatternVM::FindPrograma(FName Nombre) const
+{
+	return Programas.IndexOfByPredicate([Nombre](const FBulletProgram& Programa) { return Programa.Nombre == Nombre; });
+}
+
+void FBulletPatternVM::Reservar(int32 MaxEmisores, int32 MaxBalasPorCuadro)
+{
+	Capacidad = MaxEmisores;
+	Emisores.Reserve(MaxEmisores);
+	PorCuadro = MaxBalasPorCuadro;
+}
+
+int32 FBulletPatternVM::Iniciar(int32 Programa, const FVector& Origen, float Angulo, uint8 Tipo, uint8 Dueno)
+{
+	if (!Programas.IsValidIndex(Programa) || Emisores.Num() >= Capacidad)
+	{
+		return INDEX_NONE;
+	}
+
+	FBulletEmitter& Emisor = Emisores.AddDefaulted_GetRef();
+	Emisor.Programa = Programa;
+	Emisor.Origen = Origen;
+	Emisor.Angulo = Angulo;
+	Emisor.Tipo = Tipo;
+	Emisor.Dueno = Dueno;
+	return Emisores.Num() - 1;
+}
+
+void FBulletPatternVM::Ejecutar(float DeltaTime, const FVector& Jugador, const float* VelocidadTipo, FBulletPatternSalida& Salida)
+{
+	Salida.Reset();
+	if (Salida.Posiciones.Max() < PorCuadro)
+	{
+		Salida.Posiciones.Reserve(PorCuadro);
+		Salida.Velocidades.Reserve(PorCuadro);
+		Salida.Tipos.Reserve(PorCuadro);
+		Salida.Duenos.Reserve(PorCuadro);
+	}
+
+	// Los hijos que se lanzan en este cuadro empiezan en el siguiente
+	const int32 Num = Emisores.Num();
+	for (int32 i = 0; i < Num; ++i)
+	{
+		FBulletEmitter& Emisor = Emisores[i];
+		if (Emisor.Programa == INDEX_NONE)
+		{
+			continue;
+		}
+
+		Emisor.Espera -= DeltaTime;
+		if (!Avanzar(Emisor, Jugador, VelocidadTipo, Salida))
+		{
+			Emisor.Programa = INDEX_NONE;
+		}
+	}
+}
+
+void FBulletPatternVM::Limpiar()
+{
+	Emisores.RemoveAllSwap([](const FBulletEmitter& Emisor)
+	{
+		return Emisor.Programa == INDEX_NONE || Emisor.Fuente.IsStale();
+	}, false);
+}
+
+bool FBulletPatternVM::Avanzar(FBulletEmitter& Emisor, const FVector& Jugador, const float* VelocidadTipo, FBulletPatternSalida& Salida)
+{
+	const TArray<FBulletInstr>& Codigo = Programas[Emisor.Programa].Codigo;
+
+	for (int32 Pasos = 0; Emisor.Espera <= 0.0f && Pasos < MaxPasos; ++Pasos)
+	{
+		if (!Codigo.IsValidIndex(Emisor.PC))
+		{
+			return false;
+		}
+
+		const FBulletInstr& Instr = Codigo[Emisor.PC++];
+		const float Velocidad = VelocidadTipo[Emisor.Tipo];
+		switch (Instr.Op)
+		{
+		case EBulletOp::Anillo:
+		{
+			const float Paso = 360.0f / Instr.Cuenta;
+			for (int32 k = 0; k < Instr.Cuenta; ++k)
+			{
+				Emitir(Emisor, Emisor.Angulo + k * Paso, Velocidad * Instr.A, Salida);
+			}
+			break;
+		}
+		case EBulletOp::Abanico:
+		case EBulletOp::Apuntado:
+		{
+			float Centro = Emisor.Angulo;
+			if (Instr.Op == EBulletOp::Apuntado)
+			{
+				Centro = FMath::RadiansToDegrees(FMath::Atan2(Jugador.Y - Emisor.Origen.Y, Jugador.X - Emisor.Origen.X));
+			}
+			const float Paso = Instr.Cuenta > 1 ? Instr.A / (Instr.Cuenta - 1) : 0.0f;
+			const float Primero = Instr.Cuenta > 1 ? Centro - Instr.A * 0.5f : Centro;
+			for (int32 k = 0; k < Instr.Cuenta; ++k)
+			{
+				Emitir(Emisor, Primero + k * Paso, Velocidad * Instr.B, Salida);
+			}
+			break;
+		}
+		case EBulletOp::Girar:
+			Emisor.Angulo = FMath::Fmod(Emisor.Angulo + Instr.A, 360.0f);
+			break;
+		case EBulletOp::Angulo:
+			Emisor.Angulo = Instr.A;
+			break;
+		case EBulletOp::Esperar:
+			Emisor.Espera += Instr.A;
+			break;
+		case EBulletOp::Repetir:
+			Emisor.Pila[Emisor.Profundidad++] = { Emisor.PC, Instr.Cuenta == 0 ? INDEX_NONE : (int32)Instr.Cuenta };
+			break;
+		case EBulletOp::FinRepetir:
+		{
+			FBulletEmitter::FMarco& Marco = Emisor.Pila[Emisor.Profundidad - 1];
+			if (Marco.Restantes == INDEX_NONE || --Marco.Restantes > 0)
+			{
+				Emisor.PC = Marco.Cuerpo;
+			}
+			else
+			{
+				--Emisor.Profundidad;
+			}
+			break;
+		}
+		case EBulletOp::Sub:
+			// Sin lugar el hijo se pierde; Emisores tiene la capacidad reservada asi que Emisor sigue valido
+			if (Emisores.Num() < Capacidad)
+			{
+				FBulletEmitter& Hijo = Emisores.AddDefaulted_GetRef();
+				Hijo.Programa = Instr.Cuenta;
+				Hijo.Origen = Emisor.Origen;
+				Hijo.Angulo = Emisor.Angulo;
+				Hijo.Tipo = Emisor.Tipo;
+				Hijo.Dueno = Emisor.Dueno;
+				Hijo.Fuente = Emisor.Fuente;
+				Hijo.Offset = Emisor.Offset;
+			}
+			break;
+		case EBulletOp::Arquetipo:
+			Emisor.Tipo = Instr.Tipo;
+			break;
+		case EBulletOp::Fin:
+			return false;
+		}
+	}
+	return true;
+}
+
+void FBulletPatternVM::Emitir(const FBulletEmitter& Emisor, float AnguloGrados, float Velocidad, FBulletPatternSalida& Salida) const
+{
+	// Lleno el tope del cuadro las balas se descartan, la salida nunca crece mas alla de lo reservado
+	if (Salida.Num() >= PorCuadro)
+	{
+		++Salida.Descartadas;
+		return;
+	}
+
+	float Seno, Coseno;
+	FMath::SinCos(&Seno, &Coseno, FMath::DegreesToRadians(AnguloGrados));
+
+	Salida.Posiciones.Add(Emisor.Origen);
+	Salida.Velocidades.Add(FVector(Coseno * Velocidad, Seno * Velocidad, 0.0f));
+	Salida.Tipos.Add(Emisor.Tipo);
+	Salida.Duenos.Add(Emisor.Dueno);
+}
@@ -0,0 +1,142 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+
+class AActor;
+
+// Instrucciones de la maquina de patrones de disparo
+enum class EBulletOp : uint8
+{
+	Anillo,     // Cuenta balas repartidas en 360 grados desde Angulo; A = multiplo de velocidad
+	Abanico,    // Cuenta balas en A grados centradas en Angulo; B = multiplo de velocidad
+	Apuntado,   // igual que Abanico pero centrado en el jugador
+	Girar,      // Angulo += A
+	Angulo,     // Angulo = A
+	Esperar,    // A segundos
+	Repetir,    // repite hasta su Fin Cuenta veces (0: para siempre)
+	FinRepetir,
+	Sub,        // lanza un emisor hijo con el programa Cuenta en la posicion actual
+	Arquetipo,  // las balas siguientes usan el arquetipo Tipo
+	Fin         // termina el emisor
+};
+
+// Una instruccion de tamano fijo; un programa es un arreglo contiguo de estas
+struct FBulletInstr
+{
+	EBulletOp Op;
+	uint8 Tipo;
+	uint16 Cuenta;
+	float A;
+	float B;
+};
+
+struct FBulletProgram
+{
+	FName Nombre;
+	TArray<FBulletInstr> Codigo;
+};
+
+// Estado de un emisor en ejecucion. Sin memoria dinamica: la pila de Repetir es fija
+struct FBulletEmitter
+{
+	static constexpr int32 MaxAnidamiento = 4;
+
+	struct FMarco
+	{
+		int32 Cuerpo;
+		int32 Restantes;
+	};
+
+	int32 Programa = INDEX_NONE;
+	int32 PC = 0;
+	float Espera = 0.0f;
+	float Angulo = 180.0f;
+	FVector Origen = FVector::ZeroVector;
+	uint8 Tipo = 0;
+	uint8 Dueno = 0;
+	int32 Profundidad = 0;
+	FMarco Pila[MaxAnidamiento];
+
+	// Para el subsistema: el emisor sigue a este actor y muere con el
+	TWeakObjectPtr<AActor> Fuente;
+	FVector Offset = FVector::ZeroVector;
+};
+
+// Balas emitidas en un cuadro, se entregan en un solo lote
+struct FBulletPatternSalida
+{
+	TArray<FVector> Posiciones;
+	TArray<FVector> Velocidades;
+	TArray<uint8> Tipos;
+	TArray<uint8> Duenos;
+
+	// Balas que no entraron por el tope de balas por cuadro
+	int32 Descartadas = 0;
+
+	void Reset()
+	{
+		Posiciones.Reset();
+		Velocidades.Reset();
+		Tipos.Reset();
+		Duenos.Reset();
+		Descartadas = 0;
+	}
+
+	FORCEINLINE int32 Num() const { return Posiciones.Num(); }
+};
+
+/**
+ * Maquina virtual de patrones de disparo al estilo BulletML. Los patrones se escriben en
+ * texto y se compilan una vez a bytecode; cada cuadro Ejecutar avanza todos los emisores
+ * y junta las balas en una FBulletPatternSalida, a lo sumo MaxBalasPorCuadro; las que pasan
+ * el tope se descartan. Despues de Reservar no reserva memoria.
+ *
+ * Formato del texto, una instruccion por linea y # para comentarios:
+ *   patron Nombre ... fin
+ *   anillo N [vel]   abanico N grados [vel]   apuntado N grados [vel]
+ *   girar grados   angulo grados   esperar segundos
+ *   repetir N ... fin   sub NombrePatron   arquetipo NombreArquetipo
+ */
+struct GALAGA_USFX_API FBulletPatternVM
+{
+	// Compila todos los patrones del texto. ResolverTipo traduce un nombre de arquetipo a su
+	// indice (INDEX_NONE si no existe). Devuelve falso y deja el error en OutError si falla
+	bool Compilar(const FString& Texto, TFunctionRef<int32(FName)> ResolverTipo, FString& OutError);
+
+	int32 FindPrograma(FName Nombre) const;
+	FORCEINLINE int32 NumProgramas() const { return Programas.Num(); }
+
+	// Reserva memoria para este tope de emisores y balas por cuadro
+	void Reservar(int32 MaxEmisores, int32 MaxBalasPorCuadro);
+
+	// Devuelve el indice del emisor nuevo, o INDEX_NONE si no hay lugar
+	int32 Iniciar(int32 Programa, const FVector& Origen, float Angulo, uint8 Tipo, uint8 Dueno);
+
+	// Avanza todos los emisores y deja en Salida las balas del cuadro. Jugador es el blanco de Apuntado;
+	// VelocidadTipo da la velocidad base de cada arquetipo
+	void Ejecutar(float DeltaTime, const FVector& Jugador, const float* VelocidadTipo, FBulletPatternSalida& Salida);
+
+	// Quita los emisores que terminaron o cuya fuente ya no existe
+	void Limpiar();
+
+	FORCEINLINE int32 NumEmisores() const { return Emisores.Num(); }
+	FORCEINLINE FBulletEmitter& GetEmisor(int32 Indice) { return Emisores[Indice]; }
+	FORCEINLINE const FBulletEmitter& GetEmisor(int32 Indice) const { return Emisores[Indice]; }
+
+private:
+	// Corre un emisor hasta que espere o termine; devuelve falso si termino
+	bool Avanzar(FBulletEmitter& Emisor, const FVector& Jugador, const float* VelocidadTipo, FBulletPatternSalida& Salida);
+
+	void Emitir(const FBulletEmitter& Emisor, float AnguloGrados, float Velocidad, FBulletPatternSalida& Salida) const;
+
+	TArray<FBulletProgram> Programas;
+	TArray<FBulletEmitter> Emisores;
+	int32 Capacidad = 0;
+	int32 PorCuadro = 0;
+
+	// Tope de instrucciones por emisor y cuadro, para que un bucle sin Esperar no congele el juego
+	static constexpr int32 MaxPasos = 256;
+};
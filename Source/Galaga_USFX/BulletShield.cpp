@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BulletShield.h"
+#include "BulletFieldSubsystem.h"
+
+bool FBulletShields::Alcanza(const FEscudo& Escudo, const FVector& Anterior, const FVector& Posicion, float RadioBala)
+{
+	// En el espacio del escudo la elipse es un circulo unitario y la bala un segmento
+	const FVector Escala(1.0f / (Escudo.RadioX + RadioBala), 1.0f / (Escudo.RadioY + RadioBala), 0.0f);
+	const FVector A0 = (Anterior - Escudo.CentroAnterior) * Escala;
+	const FVector A1 = (Posicion - Escudo.Centro) * Escala;
+	return UBulletFieldSubsystem::TiempoDeImpacto(A0, A1, 1.0f) >= 0.0f;
+}
+
+int32 FBulletShields::Absorber(FBulletSoA& Balas, const float* RadioPorTipo, const float* DanoPorTipo, float DeltaTime)
+{
+	for (FEscudo& Escudo : Escudos)
+	{
+		Escudo.Absorbidas = 0;
+		Escudo.DanoAbsorbido = 0.0f;
+	}
+	if (Escudos.Num() == 0)
+	{
+		return 0;
+	}
+
+	Absorbida.Reset();
+	Absorbida.SetNumZeroed(Balas.Num());
+	int32 Total = 0;
+	for (int32 i = 0; i < Balas.Num(); ++i)
+	{
+		const FVector Posicion = Balas.GetPosicion(i);
+		const FVector Anterior = Posicion - Balas.GetVelocidad(i) * DeltaTime;
+		const uint8 Tipo = Balas.Tipo[i];
+		for (FEscudo& Escudo : Escudos)
+		{
+			if (Escudo.Dueno == Balas.Dueno[i] || Escudo.Resistencia <= 0.0f || !Alcanza(Escudo, Anterior, Posicion, RadioPorTipo[Tipo]))
+			{
+				continue;
+			}
+
+			// Un escudo que se rompe con esta bala igual la detiene
+			Escudo.Resistencia -= DanoPorTipo[Tipo];
+			Escudo.DanoAbsorbido += DanoPorTipo[Tipo];
+			++Escudo.Absorbidas;
+			Absorbida[i] = 1;
+			++Total;
+			break;
+		}
+	}
+
+	if (Total > 0)
+	{
+		int32 Quedan = 0;
+		for (int32 i = 0; i < Balas.Num(); ++i)
+		{
+			if (!Absorbida[i])
+			{
+				Balas.Copiar(i, Quedan++);
+			}
+		}
+		Balas.Truncar(Quedan);
+	}
+	return Total;
+}
@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BulletSoA.h"
+
+/**
+ * Escudos que absorben balas del campo. Cada escudo es una elipse analitica en el plano XY
+ * alrededor de su nave; cada cuadro las balas del equipo contrario se prueban contra ella con
+ * un barrido (el movimiento de la bala relativo al escudo, escalado a un circulo unitario), y
+ * las que entran se quitan y descuentan su dano de la resistencia del escudo.
+ */
+struct GALAGA_USFX_API FBulletShields
+{
+	struct FEscudo
+	{
+		FVector Centro;
+		FVector CentroAnterior;
+		float RadioX;
+		float RadioY;
+		float Resistencia;
+		uint8 Dueno;
+
+		// Lo que absorbio en el ultimo Absorber
+		int32 Absorbidas;
+		float DanoAbsorbido;
+	};
+
+	// Los arma el subsistema cada cuadro con los escudos activos
+	TArray<FEscudo> Escudos;
+
+	// Quita del SoA las balas que entraron en algun escudo con resistencia. Devuelve cuantas
+	int32 Absorber(FBulletSoA& Balas, const float* RadioPorTipo, const float* DanoPorTipo, float DeltaTime);
+
+	// Verdadero si la bala que fue de Anterior a Posicion toco la elipse (agrandada por RadioBala) en el cuadro
+	static bool Alcanza(const FEscudo& Escudo, const FVector& Anterior, const FVector& Posicion, float RadioBala);
+
+private:
+	TArray<uint8> Absorbida;
+};
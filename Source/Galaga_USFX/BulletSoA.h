@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Almacenamiento estructura-de-arreglos de las balas del UBulletFieldSubsystem.
+ * Cada componente va en su propio arreglo para que el bucle de integracion lea memoria contigua.
+ */
+struct FBulletSoA
+{
+	TArray<float> PosX;
+	TArray<float> PosY;
+	TArray<float> PosZ;
+	TArray<float> VelX;
+	TArray<float> VelY;
+	TArray<float> VelZ;
+	TArray<float> Vida;   // segundos que le quedan a la bala
+	TArray<uint8> Tipo;   // tipo de proyectil (mesh, dano, etc.)
+	TArray<uint8> Dueno;  // EBulletOwner de quien la disparo
+
+	FORCEINLINE int32 Num() const { return PosX.Num(); }
+
+	void Reserve(int32 Cantidad)
+	{
+		PosX.Reserve(Cantidad); PosY.Reserve(Cantidad); PosZ.Reserve(Cantidad);
+		VelX.Reserve(Cantidad); VelY.Reserve(Cantidad); VelZ.Reserve(Cantidad);
+		Vida.Reserve(Cantidad); Tipo.Reserve(Cantidad); Dueno.Reserve(Cantidad);
+	}
+
+	int32 Add(const FVector& Posicion, const FVector& Velocidad, float VidaUtil, uint8 InTipo, uint8 InDueno)
+	{
+		PosX.Add(Posicion.X); PosY.Add(Posicion.Y); PosZ.Add(Posicion.Z);
+		VelX.Add(Velocidad.X); VelY.Add(Velocidad.Y); VelZ.Add(Velocidad.Z);
+		Vida.Add(VidaUtil);
+		Tipo.Add(InTipo);
+		return Dueno.Add(InDueno);
+	}
+
+	// Agrega Cantidad balas sin iniciar al final; devuelve el indice de la primera
+	int32 AddUninitialized(int32 Cantidad)
+	{
+		PosX.AddUninitialized(Cantidad); PosY.AddUninitialized(Cantidad); PosZ.AddUninitialized(Cantidad);
+		VelX.AddUninitialized(Cantidad); VelY.AddUninitialized(Cantidad); VelZ.AddUninitialized(Cantidad);
+		Vida.AddUninitialized(Cantidad);
+		Tipo.AddUninitialized(Cantidad);
+		return Dueno.AddUninitialized(Cantidad);
+	}
+
+	void RemoveAtSwap(int32 Indice)
+	{
+		PosX.RemoveAtSwap(Indice, 1, false); PosY.RemoveAtSwap(Indice, 1, false); PosZ.RemoveAtSwap(Indice, 1, false);
+		VelX.RemoveAtSwap(Indice, 1, false); VelY.RemoveAtSwap(Indice, 1, false); VelZ.RemoveAtSwap(Indice, 1, false);
+		Vida.RemoveAtSwap(Indice, 1, false);
+		Tipo.RemoveAtSwap(Indice, 1, false);
+		Dueno.RemoveAtSwap(Indice, 1, false);
+	}
+
+	// Copia la bala Desde sobre Hasta; con Hasta <= Desde sirve para compactar en el mismo arreglo
+	FORCEINLINE void Copiar(int32 Desde, int32 Hasta)
+	{
+		PosX[Hasta] = PosX[Desde]; PosY[Hasta] = PosY[Desde]; PosZ[Hasta] = PosZ[Desde];
+		VelX[Hasta] = VelX[Desde]; VelY[Hasta] = VelY[Desde]; VelZ[Hasta] = VelZ[Desde];
+		Vida[Hasta] = Vida[Desde];
+		Tipo[Hasta] = Tipo[Desde];
+		Dueno[Hasta] = Dueno[Desde];
+	}
+
+	// Deja las primeras Cantidad balas sin liberar memoria
+	void Truncar(int32 Cantidad)
+	{
+		PosX.SetNum(Cantidad, false); PosY.SetNum(Cantidad, false); PosZ.SetNum(Cantidad, false);
+		VelX.SetNum(Cantidad, false); VelY.SetNum(Cantidad, false); VelZ.SetNum(Cantidad, false);
+		Vida.SetNum(Cantidad, false); Tipo.SetNum(Cantidad, false); Dueno.SetNum(Cantidad, false);
+	}
+
+	void Reset()
+	{
+		PosX.Reset(); PosY.Reset(); PosZ.Reset();
+		VelX.Reset(); VelY.Reset(); VelZ.Reset();
+		Vida.Reset(); Tipo.Reset(); Dueno.Reset();
+	}
+
+	FORCEINLINE FVector GetPosicion(int32 Indice) const { return FVector(PosX[Indice], PosY[Indice], PosZ[Indice]); }
+	FORCEINLINE FVector GetVelocidad(int32 Indice) const { return FVector(VelX[Indice], VelY[Indice], VelZ[Indice]); }
+};
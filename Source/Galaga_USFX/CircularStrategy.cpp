@@ -3,6 +3,7 @@
 
 #include "CircularStrategy.h"
 #include "NaveEnemiga.h"
+#include "EnemyKernel.h"
 
 // Sets default values
 ACircularStrategy::ACircularStrategy()
@@ -26,27 +27,9 @@ void ACircularStrategy::Tick(float DeltaTime)
 
 }
 
-void ACircularStrategy::Movement(ANaveEnemiga* enemy)
+void ACircularStrategy::Movement(ANaveEnemiga* enemy, float DeltaTime)
 {
-    // Define una velocidad de rotacin
-    float VelocidadRotacion = 10.0f; // Puedes ajustar este valor segn la velocidad deseada
-
-    // Obtiene el tiempo transcurrido desde el inicio del juego y lo escala para que avance ms lentamente
-    float TiempoTranscurrido = enemy->GetWorld()->TimeSeconds * 0.1f; // Escala de tiempo para que vaya ms lento (0.1f)
-
-    // Calcula el ngulo de rotacin basado en el tiempo
-    float Angulo = FMath::Fmod(TiempoTranscurrido, 6.0f) * VelocidadRotacion; // El ngulo cambia cada 6 segundos
-
-    // Calcula las coordenadas X e Y para el movimiento circular
-    float Radio = 3.0f; // Radio del crculo
-    float X = FMath::Cos(Angulo) * Radio; // Coordenada X del crculo
-    float Y = FMath::Sin(Angulo) * Radio; // Coordenada Y del crculo
-
-    // Calcula la nueva posicin sumando las coordenadas X e Y a la posicin del punto alrededor del cual quieres que la nave se mueva
-    FVector PuntoCentral = enemy->GetActorLocation(); // Cambia esto a la posicin inicial de la nave
-    FVector NuevaPosicion = PuntoCentral + FVector(X, Y, 0.0f);
-
-    // Establece la nueva posicin del actor
-    enemy->SetActorLocation(NuevaPosicion);
+    // El mismo circulo que ANaveEnemigaCazaAlfa (FEnemyKernel) con radio 3, escalado por DeltaTime
+    enemy->SetActorLocation(enemy->GetActorLocation() + FEnemyKernel::OffsetCircular(enemy->GetWorld()->TimeSeconds, DeltaTime, 3.0f));
 }
 
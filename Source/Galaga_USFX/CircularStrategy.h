@@ -24,6 +24,6 @@ public:
 	virtual void Tick(float DeltaTime) override;
 
 	protected:
-		virtual void Movement(class ANaveEnemiga* enemy) override;
+		virtual void Movement(class ANaveEnemiga* enemy, float DeltaTime) override;
 
 };
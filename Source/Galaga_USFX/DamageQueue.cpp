@@ -0,0 +1,132 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DamageQueue.h"
+#include "Galaga_USFX.h"
+#include "Galaga_USFXPawn.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_STATS_GROUP(TEXT("DamageQueue"), STATGROUP_DamageQueue, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Aplicar"), STAT_DamageQueue_Aplicar, STATGROUP_DamageQueue);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Impactos por cuadro"), STAT_DamageQueue_Impactos, STATGROUP_DamageQueue);
+
+static FAutoConsoleCommandWithWorld CmdDamageStats(
+	TEXT("Galaga.Damage.Stats"),
+	TEXT("Muestra los impactos y el dano acumulado por tipo de proyectil"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (UDamageQueueSubsystem* Cola = World ? World->GetSubsystem<UDamageQueueSubsystem>() : nullptr)
+		{
+			Cola->LogTotales();
+		}
+	}));
+
+bool UDamageQueueSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World != nullptr && World->IsGameWorld();
+}
+
+void UDamageQueueSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Despues de los actores y de los subsistemas que tickean, antes de dibujar
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UDamageQueueSubsystem::OnPostActorTick);
+}
+
+void UDamageQueueSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	LogTotales();
+	Pendiente.Empty();
+	Totales.Empty();
+
+	Super::Deinitialize();
+}
+
+void UDamageQueueSubsystem::Encolar(AActor* Objetivo, float Dano, FName Tipo)
+{
+	if (Objetivo == nullptr)
+	{
+		return;
+	}
+
+	Pendiente.FindOrAdd(Objetivo) += Dano;
+
+	FDamageTypeTotals& Total = Totales.FindOrAdd(Tipo);
+	++Total.Impactos;
+	Total.Dano += Dano;
+	INC_DWORD_STAT(STAT_DamageQueue_Impactos);
+}
+
+void UDamageQueueSubsystem::EncolarDano(AActor* Objetivo, float Dano, FName Tipo)
+{
+	UWorld* World = Objetivo ? Objetivo->GetWorld() : nullptr;
+	if (UDamageQueueSubsystem* Cola = World ? World->GetSubsystem<UDamageQueueSubsystem>() : nullptr)
+	{
+		Cola->Encolar(Objetivo, Dano, Tipo);
+	}
+	else
+	{
+		AplicarDano(Objetivo, Dano);
+	}
+}
+
+void UDamageQueueSubsystem::Aplicar()
+{
+	SCOPE_CYCLE_COUNTER(STAT_DamageQueue_Aplicar);
+
+	for (auto It = Pendiente.CreateIterator(); It; ++It)
+	{
+		// La fraccion que no se aplico queda para el proximo cuadro, asi el dano de rayos y bombas no se pierde
+		AActor* Objetivo = It.Key().Get();
+		It.Value() = Objetivo ? AplicarDano(Objetivo, It.Value()) : 0.0f;
+		if (It.Value() == 0.0f)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UDamageQueueSubsystem::LogTotales() const
+{
+	for (const TPair<FName, FDamageTypeTotals>& Total : Totales)
+	{
+		UE_LOG(LogGalaga_USFX, Log, TEXT("Dano %s: impactos=%d dano=%.1f"), *Total.Key.ToString(), Total.Value.Impactos, Total.Value.Dano);
+	}
+}
+
+float UDamageQueueSubsystem::AplicarDano(AActor* Objetivo, float Dano)
+{
+	if (Objetivo == nullptr)
+	{
+		return 0.0f;
+	}
+
+	AGalaga_USFXPawn* GalagaPawn = Cast<AGalaga_USFXPawn>(Objetivo);
+	if (GalagaPawn == nullptr)
+	{
+		Objetivo->TakeDamage(Dano, FDamageEvent(), nullptr, nullptr);
+		return 0.0f;
+	}
+
+	// La vida del jugador es entera: el total del cuadro se redondea una sola vez. SetVida vuelve
+	// a evaluar los estados del jugador, por eso una sola vez con el total y solo si cambia
+	const int32 Entero = FMath::RoundToInt(Dano);
+	if (Entero != 0)
+	{
+		GalagaPawn->SetVida(GalagaPawn->GetVida() - Entero);
+		UE_LOG(LogGalaga_USFX, Verbose, TEXT("Vida jugador: %.0f (dano %.2f)"), GalagaPawn->GetVida(), Dano);
+	}
+	return Dano - Entero;
+}
+
+void UDamageQueueSubsystem::OnPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World == GetWorld() && Pendiente.Num() > 0)
+	{
+		Aplicar();
+	}
+}
@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DamageQueue.generated.h"
+
+// Impactos y dano acumulados de un tipo de proyectil desde que empezo el nivel
+USTRUCT(BlueprintType)
+struct FDamageTypeTotals
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Dano")
+	int32 Impactos = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Dano")
+	float Dano = 0.0f;
+};
+
+/**
+ * Cola de dano por cuadro. Los proyectiles y el campo de balas encolan sus impactos y la
+ * cola los aplica todos juntos despues del tick de actores: un solo SetVida por objetivo,
+ * asi InicializarEstados corre una vez por cuadro y no una vez por bala.
+ */
+UCLASS()
+class GALAGA_USFX_API UDamageQueueSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+public:
+	// Guarda el impacto para aplicarlo al final del cuadro. Tipo es el nombre del arquetipo del proyectil
+	void Encolar(AActor* Objetivo, float Dano, FName Tipo);
+
+	// Para los NotifyHit: encola en la cola del mundo del objetivo, o aplica directo si no hay cola
+	static void EncolarDano(AActor* Objetivo, float Dano, FName Tipo);
+
+	// Aplica lo acumulado; normalmente lo llama OnWorldPostActorTick
+	void Aplicar();
+
+	FORCEINLINE const TMap<FName, FDamageTypeTotals>& GetTotales() const { return Totales; }
+	void LogTotales() const;
+
+private:
+	// Devuelve el dano que quedo sin aplicar: la fraccion que el jugador, con vida entera, no pudo restar
+	static float AplicarDano(AActor* Objetivo, float Dano);
+	void OnPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	// Dano acumulado por objetivo en el cuadro actual, mas lo que sobro de cuadros anteriores
+	TMap<TWeakObjectPtr<AActor>, float> Pendiente;
+
+	TMap<FName, FDamageTypeTotals> Totales;
+
+	FDelegateHandle PostActorTickHandle;
+};
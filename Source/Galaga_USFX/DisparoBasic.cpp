@@ -5,33 +5,30 @@
 #include "Components/StaticMeshComponent.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Galaga_USFXPawn.h"
+#include "ProjectilePool.h"
+#include "DamageQueue.h"
+#include "EscudoComponent.h"
+#include "ProjectileArchetype.h"
+#include "Engine/World.h"
 
 // Sets default values
 ADisparoBasic::ADisparoBasic()
 {
  	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
-	static ConstructorHelpers::FObjectFinder<UStaticMesh> BallMesh(TEXT("StaticMesh'/Game/TwinStick/Meshes/TwinStickProjectile_2.TwinStickProjectile_2'"));
 	 MeshDisparoBasic = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("StaticMesh'/Game/TwinStick/Meshes/TwinStickProjectile_2.TwinStickProjectile_2'"));
-	 MeshDisparoBasic->BodyInstance.SetCollisionProfileName("Projectile");
 	RootComponent =  MeshDisparoBasic;
-	 MeshDisparoBasic->SetStaticMesh(BallMesh.Object);
-	 MeshDisparoBasic->SetRelativeScale3D(FVector(1.5f, 1.5f, 1.5f));
 	 MeshDisparoBasic->SetupAttachment(RootComponent);
 
 	// MeshDisparoBasic->SetCollisionProfileName(UCollisionProfile::Pawn_ProfileName);
 
 	ProjectileMovementComponent = CreateDefaultSubobject<UProjectileMovementComponent>(TEXT("ProjectileMovementComponent"));
 	ProjectileMovementComponent->UpdatedComponent =  MeshDisparoBasic;
-	ProjectileMovementComponent->InitialSpeed = 2000.0f;
-	ProjectileMovementComponent->MaxSpeed = 2000.0f;
 	ProjectileMovementComponent->bRotationFollowsVelocity = true;
 	ProjectileMovementComponent->bShouldBounce = false;
 	ProjectileMovementComponent->ProjectileGravityScale = 0.0f;
 	ProjectileMovementComponent->bShouldBounce = true;
 	//ProjectileMovementComponent->Bounciness = 0.6f;  // Ajusta la cantidad de energa que se conserva despus de un rebote
-	//Damage = 10;
-	InitialLifeSpan = 3.0f;
 
 
 }
@@ -40,7 +37,17 @@ ADisparoBasic::ADisparoBasic()
 void ADisparoBasic::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	// Malla, velocidades, dano y vida util salen del arquetipo "Basico"
+	if (UProjectileArchetypeSubsystem* Arquetipos = GetWorld()->GetSubsystem<UProjectileArchetypeSubsystem>())
+	{
+		const FProjectileArchetypeHandle Arquetipo = Arquetipos->FindHandle(TEXT("Basico"));
+		Arquetipos->Aplicar(Arquetipo, this);
+		if (Arquetipo.IsValid())
+		{
+			Damage = Arquetipos->Get(Arquetipo).Dano;
+		}
+	}
 }
 
 // Called every frame
@@ -59,15 +66,19 @@ void ADisparoBasic::Movimientoproyectil(float DeltaTime)
 
 void ADisparoBasic::NotifyHit(UPrimitiveComponent* MyComp, AActor* Other, UPrimitiveComponent* OtherComp, bool bSelfMoved, FVector HitLocation, FVector HitNormal, FVector NormalImpulse, const FHitResult& Hit)
 {
+	// El escudo de la nave se lleva el impacto, no el jugador
+	if (UEscudoComponent::AbsorberImpacto(OtherComp, Damage))
+	{
+		UProjectilePoolSubsystem::ReleaseOrDestroy(this);
+		return;
+	}
+
 	AGalaga_USFXPawn* GalagaPawn = Cast<AGalaga_USFXPawn>(Other);
 	if (GalagaPawn)
 	{
-		Destroy();
-		vida=GalagaPawn->GetVida();
-		vida = vida - 10;
-		GalagaPawn->SetVida(vida);
-		FString Message = FString::Printf(TEXT("Vida Jugador: %d"), vida);
-		GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Green, Message);
+		UProjectilePoolSubsystem::ReleaseOrDestroy(this);
+		// El dano se suma en la cola y se aplica una sola vez al final del cuadro
+		UDamageQueueSubsystem::EncolarDano(GalagaPawn, Damage, TEXT("Basico"));
 	}
 }
 
@@ -20,6 +20,8 @@ public:
 		float velocidadBasic = 2000.0f;
 		UPROPERTY(VisibleAnywhere, Category = "Movement")
 		UProjectileMovementComponent* ProjectileMovementComponent;
+		UPROPERTY(EditAnywhere, Category = "Damage")
+		float Damage;
 
 		UFUNCTION()
 		virtual void NotifyHit(class UPrimitiveComponent* MyComp,
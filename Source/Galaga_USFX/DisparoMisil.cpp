@@ -3,6 +3,8 @@
 
 #include "DisparoMisil.h"
 #include "Components/StaticMeshComponent.h"
+#include "ProjectileArchetype.h"
+#include "Engine/World.h"
 #include "GameFramework/ProjectileMovementComponent.h"  // Aade esta lnea
 
 // Sets default values
@@ -12,27 +14,19 @@ ADisparoMisil::ADisparoMisil()
 	PrimaryActorTick.bCanEverTick = true;
 
 
-	static ConstructorHelpers::FObjectFinder<UStaticMesh> BallMesh(TEXT("StaticMesh'/Game/Content/Meshes/Missile.Missile'"));
 	Misilmalla = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("StaticMesh'/Game/Content/Meshes/Missile.Missile'"));
-	Misilmalla->BodyInstance.SetCollisionProfileName("Projectile");
 	RootComponent = Misilmalla;
-	Misilmalla->SetStaticMesh(BallMesh.Object);
-	Misilmalla->SetRelativeScale3D(FVector(1.5f, 1.5f, 1.5f));
 	Misilmalla->SetupAttachment(RootComponent);
 
 	//Misilmalla->SetCollisionProfileName(UCollisionProfile::Pawn_ProfileName);
 
 	ProjectileMovementComponent = CreateDefaultSubobject<UProjectileMovementComponent>(TEXT("ProjectileMovementComponent"));
 	ProjectileMovementComponent->UpdatedComponent = Misilmalla;
-	ProjectileMovementComponent->InitialSpeed = 1000.0f;
-	ProjectileMovementComponent->MaxSpeed = 2000.0f;
 	ProjectileMovementComponent->bRotationFollowsVelocity = true;
 	ProjectileMovementComponent->bShouldBounce = false;
 	ProjectileMovementComponent->ProjectileGravityScale = 0.0f;
 	ProjectileMovementComponent->bShouldBounce = true;
 	//ProjectileMovementComponent->Bounciness = 0.6f;  // Ajusta la cantidad de energa que se conserva despus de un rebote
-	Damage = 10;
-	InitialLifeSpan = 3.0f;
 
 }
 
@@ -40,7 +34,17 @@ ADisparoMisil::ADisparoMisil()
 void ADisparoMisil::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	// Malla, velocidades, dano y vida util salen del arquetipo "Misil"
+	if (UProjectileArchetypeSubsystem* Arquetipos = GetWorld()->GetSubsystem<UProjectileArchetypeSubsystem>())
+	{
+		const FProjectileArchetypeHandle Arquetipo = Arquetipos->FindHandle(TEXT("Misil"));
+		Arquetipos->Aplicar(Arquetipo, this);
+		if (Arquetipo.IsValid())
+		{
+			Damage = Arquetipos->Get(Arquetipo).Dano;
+		}
+	}
 }
 
 // Called every frame
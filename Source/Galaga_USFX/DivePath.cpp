@@ -0,0 +1,141 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DivePath.h"
+
+// Muestras por tramo entre puntos de control para medir el largo antes de reparametrizar
+static const int32 MuestrasPorTramo = 64;
+
+bool FDivePaths::Cargar(const FString& Texto, float Paso, FString& OutError)
+{
+	Rutas.Reset();
+	TArray<FVector> Control;
+	FName Actual = NAME_None;
+
+	TArray<FString> Lineas;
+	Texto.ParseIntoArrayLines(Lineas, false);
+	for (int32 NumLinea = 0; NumLinea < Lineas.Num(); ++NumLinea)
+	{
+		FString Linea = Lineas[NumLinea];
+		int32 Comentario;
+		if (Linea.FindChar(TEXT('#'), Comentario))
+		{
+			Linea.LeftInline(Comentario);
+		}
+
+		TArray<FString> Partes;
+		Linea.ParseIntoArrayWS(Partes);
+		if (Partes.Num() == 0)
+		{
+			continue;
+		}
+
+		auto Error = [&OutError, NumLinea](const FString& Mensaje)
+		{
+			OutError = FString::Printf(TEXT("linea %d: %s"), NumLinea + 1, *Mensaje);
+			return false;
+		};
+
+		const FString& Op = Partes[0];
+		if (Op == TEXT("ruta"))
+		{
+			if (!Actual.IsNone() || Partes.Num() < 2)
+			{
+				return Error(TEXT("'ruta Nombre' solo fuera de otra ruta"));
+			}
+			if (FindRuta(FName(*Partes[1])) != INDEX_NONE)
+			{
+				return Error(FString::Printf(TEXT("ruta '%s' repetida"), *Partes[1]));
+			}
+			Actual = FName(*Partes[1]);
+			Control.Reset();
+		}
+		else if (Op == TEXT("punto"))
+		{
+			if (Actual.IsNone() || Partes.Num() < 3)
+			{
+				return Error(TEXT("'punto X Y' solo dentro de una ruta"));
+			}
+			Control.Add(FVector(FCString::Atof(*Partes[1]), FCString::Atof(*Partes[2]), 0.0f));
+		}
+		else if (Op == TEXT("fin"))
+		{
+			if (Actual.IsNone() || Control.Num() < 2)
+			{
+				return Error(TEXT("una ruta necesita al menos dos puntos"));
+			}
+			FDivePath& Ruta = Rutas.AddDefaulted_GetRef();
+			Hornear(Control, Paso, Ruta);
+			Ruta.Nombre = Actual;
+			Actual = NAME_None;
+		}
+		else
+		{
+			return Error(FString::Printf(TEXT("instruccion desconocida '%s'"), *Op));
+		}
+	}
+
+	if (!Actual.IsNone())
+	{
+		OutError = FString::Printf(TEXT("falta 'fin' en la ruta '%s'"), *Actual.ToString());
+		return false;
+	}
+	return true;
+}
+
+void FDivePaths::Hornear(const TArray<FVector>& Control, float Paso, FDivePath& OutRuta)
+{
+	// Catmull-Rom: la tangente en cada punto es la mitad de la cuerda entre sus vecinos
+	const int32 NumControl = Control.Num();
+	TArray<FVector> Tangentes;
+	Tangentes.SetNumUninitialized(NumControl);
+	for (int32 i = 0; i < NumControl; ++i)
+	{
+		const FVector& Anterior = Control[FMath::Max(i - 1, 0)];
+		const FVector& Siguiente = Control[FMath::Min(i + 1, NumControl - 1)];
+		Tangentes[i] = (Siguiente - Anterior) * 0.5f;
+	}
+
+	// Muestreo denso con el largo acumulado hasta cada muestra
+	TArray<FVector> Densos;
+	TArray<float> Acumulado;
+	Densos.Add(Control[0]);
+	Acumulado.Add(0.0f);
+	for (int32 Tramo = 0; Tramo + 1 < NumControl; ++Tramo)
+	{
+		for (int32 Muestra = 1; Muestra <= MuestrasPorTramo; ++Muestra)
+		{
+			const float T = (float)Muestra / MuestrasPorTramo;
+			const FVector Punto = FMath::CubicInterp(Control[Tramo], Tangentes[Tramo], Control[Tramo + 1], Tangentes[Tramo + 1], T);
+			Acumulado.Add(Acumulado.Last() + FVector::Dist(Densos.Last(), Punto));
+			Densos.Add(Punto);
+		}
+	}
+
+	// Reparametriza por longitud de arco: una entrada cada Paso, la ultima justo al final
+	OutRuta.Largo = Acumulado.Last();
+	const int32 Entradas = FMath::Max(2, FMath::CeilToInt(OutRuta.Largo / FMath::Max(Paso, 1.0f)) + 1);
+	OutRuta.Paso = OutRuta.Largo / (Entradas - 1);
+	OutRuta.InvPaso = OutRuta.Paso > 0.0f ? 1.0f / OutRuta.Paso : 0.0f;
+	OutRuta.Puntos.SetNumUninitialized(Entradas);
+	OutRuta.Direcciones.SetNumUninitialized(Entradas);
+
+	int32 Denso = 0;
+	for (int32 Entrada = 0; Entrada < Entradas; ++Entrada)
+	{
+		const float S = Entrada * OutRuta.Paso;
+		while (Denso + 2 < Acumulado.Num() && Acumulado[Denso + 1] < S)
+		{
+			++Denso;
+		}
+		const float Tramo = Acumulado[Denso + 1] - Acumulado[Denso];
+		const float Alfa = Tramo > 0.0f ? FMath::Clamp((S - Acumulado[Denso]) / Tramo, 0.0f, 1.0f) : 0.0f;
+		OutRuta.Puntos[Entrada] = FMath::Lerp(Densos[Denso], Densos[Denso + 1], Alfa);
+		OutRuta.Direcciones[Entrada] = (Densos[Denso + 1] - Densos[Denso]).GetSafeNormal();
+	}
+}
+
+int32 FDivePaths::FindRuta(FName Nombre) const
+{
+	return Rutas.IndexOfByPredicate([Nombre](const FDivePath& Ruta) { return Ruta.Nombre == Nombre; });
+}
@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Ruta de picada horneada: puntos a igual distancia sobre la curva, relativos al lugar de la nave
+struct FDivePath
+{
+	FName Nombre;
+
+	// Posicion y direccion (unitaria) cada Paso unidades de recorrido
+	TArray<FVector> Puntos;
+	TArray<FVector> Direcciones;
+
+	float Largo = 0.0f;
+	float Paso = 1.0f;
+	float InvPaso = 1.0f;
+
+	// Posicion y direccion a S unidades del inicio. Espejo (1 o -1) refleja la ruta en Y y Origen
+	// la lleva a la nave, sin hornear otra tabla
+	FORCEINLINE void Muestrear(float S, const FVector& Origen, float Espejo, FVector& OutPosicion, FVector& OutDireccion) const
+	{
+		const float Indice = FMath::Clamp(S, 0.0f, Largo) * InvPaso;
+		const int32 i = FMath::Min((int32)Indice, Puntos.Num() - 2);
+		const float Alfa = Indice - i;
+
+		const FVector Punto = FMath::Lerp(Puntos[i], Puntos[i + 1], Alfa);
+		const FVector Direccion = FMath::Lerp(Direcciones[i], Direcciones[i + 1], Alfa);
+		OutPosicion = Origen + FVector(Punto.X, Punto.Y * Espejo, Punto.Z);
+		OutDireccion = FVector(Direccion.X, Direccion.Y * Espejo, Direccion.Z);
+	}
+};
+
+/**
+ * Rutas de picada al estilo Galaga. Cada ruta es un spline Catmull-Rom por sus puntos de
+ * control y se hornea una sola vez al cargar en una tabla parametrizada por longitud de arco:
+ * una nave en picada solo avanza un escalar y Muestrear interpola dos entradas de la tabla,
+ * sin trigonometria ni evaluar el spline en juego.
+ *
+ * Formato del texto, una instruccion por linea y # para comentarios:
+ *   ruta Nombre ... fin   punto X Y   (X hacia adelante de la nave, Y hacia el costado)
+ */
+struct GALAGA_USFX_API FDivePaths
+{
+	// Lee y hornea todas las rutas del texto con una entrada cada Paso unidades. Devuelve falso
+	// y deja el error en OutError si falla
+	bool Cargar(const FString& Texto, float Paso, FString& OutError);
+
+	// Hornea una ruta desde sus puntos de control; la curva pasa por todos ellos
+	static void Hornear(const TArray<FVector>& Control, float Paso, FDivePath& OutRuta);
+
+	int32 FindRuta(FName Nombre) const;
+	FORCEINLINE int32 Num() const { return Rutas.Num(); }
+	FORCEINLINE const FDivePath& Get(int32 Indice) const { return Rutas[Indice]; }
+
+private:
+	TArray<FDivePath> Rutas;
+};
@@ -0,0 +1,250 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DiveSubsystem.h"
+#include "EnemyKernel.h"
+#include "FormationManager.h"
+#include "NaveEnemiga.h"
+#include "Galaga_USFX.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DECLARE_CYCLE_STAT(TEXT("Picadas"), STAT_Dive_Tick, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Naves en picada"), STAT_Dive_Picadas, STATGROUP_Game);
+
+// Galaga.Dive.Bench [Picadas] [Cuadros]: costo de avanzar y muestrear naves en picada con la tabla
+static void BenchPicadas(const TArray<FString>& Args)
+{
+	const int32 Picadas = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 500;
+	const int32 Cuadros = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 600;
+	const float DeltaTime = 1.0f / 60.0f;
+
+	FDivePaths Rutas;
+	FString Texto;
+	FString Archivo;
+	FString Error;
+	if (!UDiveSubsystem::LeerArchivoRutas(Texto, Archivo))
+	{
+		UE_LOG(LogGalaga_USFX, Warning, TEXT("Dive bench: no se pudo leer %s"), *Archivo);
+		return;
+	}
+	if (!Rutas.Cargar(Texto, 10.0f, Error) || Rutas.Num() == 0)
+	{
+		UE_LOG(LogGalaga_USFX, Warning, TEXT("Dive bench: %s"), *Error);
+		return;
+	}
+
+	FRandomStream Azar(1234);
+	TArray<int32> Ruta;
+	TArray<float> Recorrido;
+	TArray<FVector> Origen;
+	TArray<float> Espejo;
+	for (int32 i = 0; i < Picadas; ++i)
+	{
+		Ruta.Add(Azar.RandHelper(Rutas.Num()));
+		Recorrido.Add(Azar.FRandRange(0.0f, Rutas.Get(Ruta.Last()).Largo));
+		Origen.Add(FVector(1000.0f, Azar.FRandRange(-1000.0f, 1000.0f), 200.0f));
+		Espejo.Add(Azar.RandHelper(2) ? 1.0f : -1.0f);
+	}
+
+	TArray<FVector> Posiciones;
+	TArray<FVector> Direcciones;
+	Posiciones.SetNumUninitialized(Picadas);
+	Direcciones.SetNumUninitialized(Picadas);
+	const double Inicio = FPlatformTime::Seconds();
+	for (int32 Cuadro = 0; Cuadro < Cuadros; ++Cuadro)
+	{
+		for (int32 i = 0; i < Picadas; ++i)
+		{
+			const FDivePath& Camino = Rutas.Get(Ruta[i]);
+			Recorrido[i] = FMath::Fmod(Recorrido[i] + 900.0f * DeltaTime, Camino.Largo);
+			Camino.Muestrear(Recorrido[i], Origen[i], Espejo[i], Posiciones[i], Direcciones[i]);
+		}
+	}
+	const double Total = FPlatformTime::Seconds() - Inicio;
+
+	// Algo que dependa del resultado, para que el compilador no quite el bucle
+	FVector Suma = FVector::ZeroVector;
+	for (int32 i = 0; i < Picadas; ++i)
+	{
+		Suma += Posiciones[i] + Direcciones[i];
+	}
+	UE_LOG(LogGalaga_USFX, Display, TEXT("Dive bench: %d picadas, %d cuadros, %.2f ns por nave y cuadro (%d rutas, %s)"),
+		Picadas, Cuadros, Total * 1e9 / FMath::Max(Picadas * Cuadros, 1), Rutas.Num(), *Suma.ToCompactString());
+}
+
+static FAutoConsoleCommand CmdBenchPicadas(
+	TEXT("Galaga.Dive.Bench"),
+	TEXT("Galaga.Dive.Bench [Picadas=500] [Cuadros=600]: nanosegundos por nave en picada para avanzar y muestrear la tabla horneada"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchPicadas));
+
+bool UDiveSubsystem::LeerArchivoRutas(FString& OutTexto, FString& OutRuta)
+{
+	OutRuta = FPaths::ProjectContentDir() / GetDefault<UDiveSubsystem>()->ArchivoRutas;
+	return FFileHelper::LoadFileToString(OutTexto, *OutRuta);
+}
+
+bool UDiveSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World != nullptr && World->IsGameWorld();
+}
+
+void UDiveSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Las rutas se hornean una sola vez, nunca durante el juego
+	FString Texto;
+	FString Ruta;
+	FString Error;
+	if (!LeerArchivoRutas(Texto, Ruta))
+	{
+		UE_LOG(LogGalaga_USFX, Error, TEXT("No se pudo leer el archivo de rutas %s"), *Ruta);
+	}
+	else if (Rutas.Cargar(Texto, PasoTabla, Error))
+	{
+		UE_LOG(LogGalaga_USFX, Log, TEXT("Rutas de picada: %d horneadas de %s"), Rutas.Num(), *Ruta);
+	}
+	else
+	{
+		UE_LOG(LogGalaga_USFX, Error, TEXT("Error en %s, %s"), *Ruta, *Error);
+	}
+}
+
+void UDiveSubsystem::Deinitialize()
+{
+	Picadas.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UDiveSubsystem::Lanzar(ANaveEnemiga* Nave, FName Ruta, bool bEspejo)
+{
+	const int32 Indice = Rutas.FindRuta(Ruta);
+	AFormationManager* Formacion = Nave ? Nave->GetFormacion() : nullptr;
+	FVector Offset;
+	if (Indice == INDEX_NONE || Formacion == nullptr || !Formacion->GetOffset(Nave, Offset))
+	{
+		return false;
+	}
+
+	// Fuera de la formacion pero con el Tick apagado: la mueve la picada
+	Nave->RomperFormacion();
+	Nave->SetActorTickEnabled(false);
+
+	FPicada& Picada = Picadas.AddDefaulted_GetRef();
+	Picada.Nave = Nave;
+	Picada.Formacion = Formacion;
+	Picada.Offset = Offset;
+	Picada.Lugar = Formacion->GetPosicionSlot(Offset);
+	Picada.Origen = Picada.Lugar;
+	Picada.Rotacion = Nave->GetActorRotation();
+	Picada.Ruta = Indice;
+	Picada.Recorrido = 0.0f;
+	Picada.Espejo = bEspejo ? -1.0f : 1.0f;
+	return true;
+}
+
+void UDiveSubsystem::Cancelar(const ANaveEnemiga* Nave)
+{
+	Picadas.RemoveAllSwap([Nave](const FPicada& Picada) { return Picada.Nave.Get() == Nave; });
+}
+
+FName UDiveSubsystem::GetRutaAlAzar() const
+{
+	return Rutas.Num() > 0 ? Rutas.Get(FMath::RandHelper(Rutas.Num())).Nombre : NAME_None;
+}
+
+void UDiveSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_Dive_Tick);
+
+	Picadas.RemoveAllSwap([](const FPicada& Picada) { return !Picada.Nave.IsValid(); });
+
+	// Muestreo de todas las picadas: un escalar y dos entradas de tabla por nave
+	const int32 Num = Picadas.Num();
+	Posiciones.SetNumUninitialized(Num, false);
+	Direcciones.SetNumUninitialized(Num, false);
+	for (int32 i = 0; i < Num; ++i)
+	{
+		FPicada& Picada = Picadas[i];
+		const FDivePath& Ruta = Rutas.Get(Picada.Ruta);
+		Picada.Recorrido += VelocidadPicada * DeltaTime;
+
+		// El origen sigue al lugar en la formacion sin envolver: cuando el lugar pasa de un limite al
+		// otro solo se suma su paso de este cuadro, asi la nave no salta 2*LimiteY a mitad de ruta.
+		// Si la formacion ya no esta la ruta sigue desde donde estaba su lugar
+		if (const AFormationManager* Formacion = Picada.Formacion.Get())
+		{
+			const FVector Lugar = Formacion->GetPosicionSlot(Picada.Offset);
+			FVector Paso = Lugar - Picada.Lugar;
+			Paso.Y = FEnemyKernel::Envolver(Paso.Y, Formacion->LimiteY);
+			Picada.Origen += Paso;
+			Picada.Lugar = Lugar;
+		}
+		Ruta.Muestrear(Picada.Recorrido, Picada.Origen, Picada.Espejo, Posiciones[i], Direcciones[i]);
+	}
+
+	// Despues se escribe y se avanza el disparo de cada nave; las que llegaron al final vuelven
+	for (int32 i = Num - 1; i >= 0; --i)
+	{
+		const FPicada Picada = Picadas[i];
+		ANaveEnemiga* Nave = Picada.Nave.Get();
+		if (Nave == nullptr)
+		{
+			continue;
+		}
+		if (Picada.Recorrido >= Rutas.Get(Picada.Ruta).Largo)
+		{
+			// Recien al volver se envuelve, asi entra a la formacion en su mismo lugar
+			FVector Final = Posiciones[i];
+			if (const AFormationManager* Formacion = Picada.Formacion.Get())
+			{
+				Final.Y = FEnemyKernel::Envolver(Final.Y, Formacion->LimiteY);
+			}
+			Nave->SetActorLocationAndRotation(Final, Picada.Rotacion);
+			Picadas.RemoveAtSwap(i, 1, false);
+			Terminar(Nave, Picada.Formacion.Get());
+			continue;
+		}
+
+		Nave->SetActorLocationAndRotation(Posiciones[i], Direcciones[i].Rotation());
+
+		float Temporizador = Nave->GetFireRate();
+		const bool bDispara = FEnemyKernel::AvanzarDisparo(Temporizador, Nave->GetIntervaloDisparo(), DeltaTime);
+		Nave->AplicarDisparo(Temporizador, bDispara);
+	}
+
+	SET_DWORD_STAT(STAT_Dive_Picadas, Picadas.Num());
+}
+
+void UDiveSubsystem::Terminar(ANaveEnemiga* Nave, AFormationManager* Formacion) const
+{
+	if (Formacion)
+	{
+		Formacion->AgregarNave(Nave);
+	}
+	else
+	{
+		Nave->SetActorTickEnabled(true);
+	}
+}
+
+ETickableTickType UDiveSubsystem::GetTickableTickType() const
+{
+	return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UDiveSubsystem::IsTickable() const
+{
+	return Picadas.Num() > 0;
+}
+
+TStatId UDiveSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDiveSubsystem, STATGROUP_Tickables);
+}
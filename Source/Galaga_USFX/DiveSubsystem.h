@@ -0,0 +1,95 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "DivePath.h"
+#include "DiveSubsystem.generated.h"
+
+class ANaveEnemiga;
+class AFormationManager;
+
+/**
+ * Mueve las naves que salen de la formacion en picada. Hornea las rutas del archivo al crear
+ * el mundo; cada cuadro avanza el recorrido de todas las naves en picada, muestrea su tabla y
+ * escribe posicion y rumbo en un solo bucle. La ruta se mide desde el lugar de la nave en la
+ * formacion, que sigue moviendose, asi que al terminar la nave vuelve justo a su lugar. Ese
+ * origen se acumula sin envolver en +-LimiteY durante la picada y se envuelve al volver.
+ */
+UCLASS(config = Game)
+class GALAGA_USFX_API UDiveSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+public:
+	// Saca a la nave de su formacion y la lanza por la ruta; bEspejo la refleja en Y. Falso si no
+	// existe la ruta o la nave no esta en formacion
+	bool Lanzar(ANaveEnemiga* Nave, FName Ruta, bool bEspejo);
+
+	// Quita la picada de la nave sin devolverla a la formacion, por ejemplo si murio en el camino
+	void Cancelar(const ANaveEnemiga* Nave);
+
+	// Nombre de una ruta cualquiera, para las formaciones que eligen al azar
+	FName GetRutaAlAzar() const;
+
+	FORCEINLINE int32 GetNumPicadas() const { return Picadas.Num(); }
+
+	// Lee el ArchivoRutas configurado; OutRuta queda con la ruta completa aunque falle
+	static bool LeerArchivoRutas(FString& OutTexto, FString& OutRuta);
+
+protected:
+	// Relativo a la carpeta Content del proyecto
+	UPROPERTY(Config)
+	FString ArchivoRutas = TEXT("Data/DivePaths.txt");
+
+	// Unidades de recorrido entre entradas de la tabla
+	UPROPERTY(Config)
+	float PasoTabla = 10.0f;
+
+	// Unidades por segundo a lo largo de la ruta
+	UPROPERTY(Config)
+	float VelocidadPicada = 900.0f;
+
+private:
+	// Termina la picada: la nave vuelve a su formacion o, si ya no existe, a su propio Tick
+	void Terminar(ANaveEnemiga* Nave, AFormationManager* Formacion) const;
+
+	struct FPicada
+	{
+		TWeakObjectPtr<ANaveEnemiga> Nave;
+		TWeakObjectPtr<AFormationManager> Formacion;
+		FVector Offset;
+
+		// Lugar en la formacion el cuadro anterior (envuelto) y origen de la ruta (sin envolver)
+		FVector Lugar;
+		FVector Origen;
+
+		// Rotacion de la nave en la formacion, se devuelve al terminar la picada
+		FRotator Rotacion;
+
+		int32 Ruta;
+		float Recorrido;
+		float Espejo;
+	};
+
+	FDivePaths Rutas;
+	TArray<FPicada> Picadas;
+
+	// Resultado del cuadro, se escribe despues de muestrear todas las picadas
+	TArray<FVector> Posiciones;
+	TArray<FVector> Direcciones;
+};
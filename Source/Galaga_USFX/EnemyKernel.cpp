@@ -0,0 +1,136 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "EnemyKernel.h"
+#include "Galaga_USFX.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+
+static TAutoConsoleVariable<int32> CVarEnemyParalelo(
+	TEXT("Galaga.Enemy.Paralelo"),
+	1,
+	TEXT("1: el paso de las naves en formacion se calcula con ParallelFor. 0: en el hilo de juego."));
+
+static TAutoConsoleVariable<int32> CVarEnemyMinParalelo(
+	TEXT("Galaga.Enemy.MinParalelo"),
+	256,
+	TEXT("Naves minimas en una formacion para repartir el calculo entre hilos."));
+
+// Naves por tarea de ParallelFor; con menos el costo de despachar supera al calculo
+static const int32 NavesPorLote = 128;
+
+static FORCEINLINE void CalcularNave(const FEnemyEstado& Estado, const FVector& Desplazamiento, float LimiteY, float DeltaTime, FEnemyResultado& Resultado)
+{
+	Resultado.Posicion = Estado.Offset + Desplazamiento;
+	Resultado.Posicion.Y = FEnemyKernel::Envolver(Resultado.Posicion.Y, LimiteY);
+	Resultado.Temporizador = Estado.Temporizador;
+	Resultado.bDispara = FEnemyKernel::AvanzarDisparo(Resultado.Temporizador, Estado.Intervalo, DeltaTime);
+}
+
+void FEnemyKernel::Calcular(const TArray<FEnemyEstado>& Estados, const FVector& Desplazamiento, float LimiteY, float DeltaTime,
+	TArray<FEnemyResultado>& OutResultados, bool bParalelo)
+{
+	const int32 Num = Estados.Num();
+	OutResultados.SetNumUninitialized(Num, false);
+
+	const FEnemyEstado* RESTRICT Entrada = Estados.GetData();
+	FEnemyResultado* RESTRICT Salida = OutResultados.GetData();
+	if (!bParalelo)
+	{
+		for (int32 i = 0; i < Num; ++i)
+		{
+			CalcularNave(Entrada[i], Desplazamiento, LimiteY, DeltaTime, Salida[i]);
+		}
+		return;
+	}
+
+	const int32 NumLotes = FMath::DivideAndRoundUp(Num, NavesPorLote);
+	ParallelFor(NumLotes, [=](int32 Lote)
+	{
+		const int32 Fin = FMath::Min(Num, (Lote + 1) * NavesPorLote);
+		for (int32 i = Lote * NavesPorLote; i < Fin; ++i)
+		{
+			CalcularNave(Entrada[i], Desplazamiento, LimiteY, DeltaTime, Salida[i]);
+		}
+	});
+}
+
+bool FEnemyKernel::UsarParalelo(int32 NumNaves)
+{
+	return CVarEnemyParalelo.GetValueOnGameThread() != 0 && NumNaves >= CVarEnemyMinParalelo.GetValueOnGameThread();
+}
+
+// Galaga.Enemy.Bench [Naves] [Cuadros]: costo del paso de la formacion (AFormationManager::Tick:
+// AvanzarFormacion + Calcular, serial y con ParallelFor) contra el de cada nave con su propio
+// Tick (Mover con MoverRecto + ActualizarDisparo). Que den lo mismo lo comprueba la prueba
+// Galaga.EnemyKernel.Determinismo
+static void BenchNaves(const TArray<FString>& Args)
+{
+	const int32 Naves = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 2000;
+	const int32 Cuadros = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 600;
+	const float LimiteY = 1000.0f;
+	const float VelocidadY = 400.0f;
+
+	FRandomStream Azar(1234);
+	TArray<FEnemyEstado> Estados;
+	TArray<FVector> Posiciones;
+	TArray<float> Temporizadores;
+	for (int32 i = 0; i < Naves; ++i)
+	{
+		FEnemyEstado& Estado = Estados.AddDefaulted_GetRef();
+		Estado.Offset = FVector(Azar.FRandRange(-400.0f, 600.0f), Azar.FRandRange(-1000.0f, 1000.0f), 200.0f);
+		Estado.Temporizador = Azar.FRandRange(0.0f, 1.0f);
+		Estado.Intervalo = (float)Azar.RandRange(0, 3);
+		Posiciones.Add(Estado.Offset);
+		Temporizadores.Add(Estado.Temporizador);
+	}
+	TArray<FEnemyEstado> EstadosParalelo = Estados;
+
+	TArray<FEnemyResultado> ResultadoSerial;
+	TArray<FEnemyResultado> ResultadoParalelo;
+	FVector Desplazamiento = FVector::ZeroVector;
+	int32 Disparos = 0;
+	double TotalSerial = 0.0;
+	double TotalParalelo = 0.0;
+	double TotalPorNave = 0.0;
+	for (int32 Cuadro = 0; Cuadro < Cuadros; ++Cuadro)
+	{
+		// Cuadros irregulares como en juego
+		const float DeltaTime = Azar.FRandRange(1.0f / 120.0f, 1.0f / 20.0f);
+
+		double Inicio = FPlatformTime::Seconds();
+		FEnemyKernel::AvanzarFormacion(Desplazamiento, VelocidadY, DeltaTime, LimiteY);
+		FEnemyKernel::Calcular(Estados, Desplazamiento, LimiteY, DeltaTime, ResultadoSerial, false);
+		TotalSerial += FPlatformTime::Seconds() - Inicio;
+
+		Inicio = FPlatformTime::Seconds();
+		FEnemyKernel::Calcular(EstadosParalelo, Desplazamiento, LimiteY, DeltaTime, ResultadoParalelo, true);
+		TotalParalelo += FPlatformTime::Seconds() - Inicio;
+
+		for (int32 i = 0; i < Naves; ++i)
+		{
+			Estados[i].Temporizador = ResultadoSerial[i].Temporizador;
+			EstadosParalelo[i].Temporizador = ResultadoParalelo[i].Temporizador;
+			Disparos += ResultadoSerial[i].bDispara;
+		}
+
+		Inicio = FPlatformTime::Seconds();
+		for (int32 i = 0; i < Naves; ++i)
+		{
+			Posiciones[i] = FEnemyKernel::MoverRecto(Posiciones[i], VelocidadY, DeltaTime, LimiteY);
+			Disparos += FEnemyKernel::AvanzarDisparo(Temporizadores[i], Estados[i].Intervalo, DeltaTime);
+		}
+		TotalPorNave += FPlatformTime::Seconds() - Inicio;
+	}
+
+	// Disparos depende de los resultados, asi el compilador no quita los bucles
+	UE_LOG(LogGalaga_USFX, Display, TEXT("Enemy bench: %d naves, %d cuadros, %d disparos; formacion %.3f ms, paralelo %.3f ms, por nave %.3f ms por cuadro"),
+		Naves, Cuadros, Disparos,
+		TotalSerial * 1000.0 / FMath::Max(Cuadros, 1), TotalParalelo * 1000.0 / FMath::Max(Cuadros, 1), TotalPorNave * 1000.0 / FMath::Max(Cuadros, 1));
+}
+
+static FAutoConsoleCommand CmdBenchNaves(
+	TEXT("Galaga.Enemy.Bench"),
+	TEXT("Galaga.Enemy.Bench [Naves=2000] [Cuadros=600]: mide el paso de la formacion (serial y ParallelFor) y el Tick de cada nave"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchNaves));
@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Lo que necesita el paso de calculo de una nave en formacion; se copia del actor antes de calcular
+struct FEnemyEstado
+{
+	FVector Offset;       // lugar de la nave en la formacion
+	float Temporizador;   // FireRate acumulado
+	float Intervalo;      // IntervaloDisparo (0: no dispara)
+};
+
+// Resultado del paso; lo aplica el hilo de juego (SetActorLocation, Disparar)
+struct FEnemyResultado
+{
+	FVector Posicion;
+	float Temporizador;
+	bool bDispara;
+};
+
+/**
+ * Logica de las naves enemigas separada del motor: movimiento y temporizador de disparo
+ * como funciones puras de posiciones y tiempos. El Tick de cada nave y la formacion usan las
+ * mismas funciones, asi que el paso en paralelo da exactamente lo mismo que el serial.
+ * Calcular no toca actores: escribe en un buffer de resultados que se aplica despues.
+ */
+struct GALAGA_USFX_API FEnemyKernel
+{
+	// Y envuelto en [-LimiteY, LimiteY) sin perder el resto; es el que usa la formacion
+	static FORCEINLINE float Envolver(float Y, float LimiteY)
+	{
+		const float Periodo = 2.0f * LimiteY;
+		float Resto = FMath::Fmod(Y + LimiteY, Periodo);
+		if (Resto < 0.0f)
+		{
+			Resto += Periodo;
+		}
+		return Resto - LimiteY;
+	}
+
+	// Paso de una nave con su propio Tick: Y -= VelocidadY*dt y al pasar un limite reaparece en
+	// el otro. Envuelve igual que la formacion, asi una nave da el mismo recorrido dentro o fuera
+	static FORCEINLINE FVector MoverRecto(const FVector& Posicion, float VelocidadY, float DeltaTime, float LimiteY)
+	{
+		return FVector(Posicion.X, Envolver(Posicion.Y - VelocidadY * DeltaTime, LimiteY), Posicion.Z);
+	}
+
+	// Avance del origen de una formacion en un cuadro (AFormationManager::Tick)
+	static FORCEINLINE void AvanzarFormacion(FVector& Desplazamiento, float VelocidadY, float DeltaTime, float LimiteY)
+	{
+		Desplazamiento.Y = Envolver(Desplazamiento.Y - VelocidadY * DeltaTime, LimiteY);
+	}
+
+	// Desplazamiento del circulo de ANaveEnemigaCazaAlfa segun el tiempo del mundo. Radio es el paso
+	// de un cuadro a 60 FPS; se escala por DeltaTime para que una nave que se actualiza cada 2 o 4
+	// cuadros recorra lo mismo
+	static FORCEINLINE FVector OffsetCircular(float TiempoMundo, float DeltaTime, float Radio = 10.0f)
+	{
+		const float Angulo = FMath::Fmod(TiempoMundo * 0.1f, 6.0f) * 10.0f;
+		const float Paso = Radio * DeltaTime * 60.0f;
+		return FVector(FMath::Cos(Angulo) * Paso, FMath::Sin(Angulo) * Paso, 0.0f);
+	}
+
+	// Suma DeltaTime y devuelve verdadero si toca disparar. Se descuenta el intervalo en lugar de
+	// volver a 0, asi el sobrante del cuadro no se pierde y la cadencia no se atrasa con el tiempo
+	static FORCEINLINE bool AvanzarDisparo(float& Temporizador, float Intervalo, float DeltaTime)
+	{
+		if (Intervalo <= 0.0f)
+		{
+			return false;
+		}
+
+		Temporizador += DeltaTime;
+		if (Temporizador >= Intervalo)
+		{
+			// Despues de una pausa larga no se acumulan varios disparos
+			Temporizador = FMath::Fmod(Temporizador - Intervalo, Intervalo);
+			return true;
+		}
+		return false;
+	}
+
+	// Paso de todas las naves de una formacion desplazada Desplazamiento. Con bParalelo reparte
+	// lotes con ParallelFor; cada nave solo escribe su resultado, asi que el orden no importa
+	static void Calcular(const TArray<FEnemyEstado>& Estados, const FVector& Desplazamiento, float LimiteY, float DeltaTime,
+		TArray<FEnemyResultado>& OutResultados, bool bParalelo);
+
+	// Galaga.Enemy.Paralelo y tamano minimo para que valga la pena repartir
+	static bool UsarParalelo(int32 NumNaves);
+};
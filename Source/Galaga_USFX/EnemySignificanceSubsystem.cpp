@@ -0,0 +1,293 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "EnemySignificanceSubsystem.h"
+#include "NaveEnemiga.h"
+#include "FormationManager.h"
+#include "ShipRegistrySubsystem.h"
+#include "Galaga_USFX.h"
+#include "ConvexVolume.h"
+#include "SceneManagement.h"
+#include "SceneView.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+
+DECLARE_CYCLE_STAT(TEXT("Significancia"), STAT_Significancia_Evaluar, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Naves cada cuadro"), STAT_Significancia_Cada1, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Naves cada 2 cuadros"), STAT_Significancia_Cada2, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Naves cada 4 cuadros"), STAT_Significancia_Cada4, STATGROUP_Game);
+
+static TAutoConsoleVariable<int32> CVarSignificanciaActiva(
+	TEXT("Galaga.Significance.Activa"),
+	1,
+	TEXT("1: las naves lejanas o fuera de pantalla tickean cada 2 o 4 cuadros. 0: todas cada cuadro."));
+
+// Galaga.Significance.Bench [Naves] [Cuadros]
+static void BenchSignificancia(const TArray<FString>& Args, UWorld* World)
+{
+	UEnemySignificanceSubsystem* Significancia = World ? World->GetSubsystem<UEnemySignificanceSubsystem>() : nullptr;
+	if (Significancia)
+	{
+		const int32 Naves = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 2000;
+		const int32 Cuadros = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 300;
+		Significancia->IniciarBench(Naves, Cuadros);
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CmdBenchSignificancia(
+	TEXT("Galaga.Significance.Bench"),
+	TEXT("Galaga.Significance.Bench [Naves=2000] [Cuadros=300]: arma una formacion de naves del registro lejos del jugador y compara su costo de escritura con la significancia prendida y apagada"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&BenchSignificancia));
+
+bool UEnemySignificanceSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World != nullptr && World->IsGameWorld();
+}
+
+void UEnemySignificanceSubsystem::Deinitialize()
+{
+	Naves.Reset();
+
+	Super::Deinitialize();
+}
+
+void UEnemySignificanceSubsystem::RegisterNave(ANaveEnemiga* Nave)
+{
+	if (Nave)
+	{
+		FNave& Entrada = Naves.AddDefaulted_GetRef();
+		Entrada.Nave = Nave;
+		Entrada.Cuadros = 1;
+
+		// Una nave que vuelve del registro no conserva la frecuencia de su vida anterior
+		Nave->SetCuadrosActualizacion(1, 0.0f);
+	}
+}
+
+void UEnemySignificanceSubsystem::UnregisterNave(ANaveEnemiga* Nave)
+{
+	const int32 Indice = Naves.IndexOfByPredicate([Nave](const FNave& Entrada) { return Entrada.Nave.Get() == Nave; });
+	if (Indice != INDEX_NONE)
+	{
+		Naves.RemoveAtSwap(Indice, 1, false);
+	}
+}
+
+void UEnemySignificanceSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_Significancia_Evaluar);
+
+	DeltaPromedio = FMath::Lerp(DeltaPromedio, DeltaTime, 0.1f);
+	AvanzarBench(DeltaTime);
+
+	// La segunda fase del bench mide con la significancia apagada
+	const bool bQuiereActiva = CVarSignificanciaActiva.GetValueOnGameThread() != 0 && Bench.Fase != 1;
+
+	HastaEvaluar -= DeltaTime;
+	if (HastaEvaluar <= 0.0f || bQuiereActiva != bActiva)
+	{
+		HastaEvaluar = ReevaluarCada;
+		bActiva = bQuiereActiva;
+		Evaluar(!bActiva);
+	}
+}
+
+ETickableTickType UEnemySignificanceSubsystem::GetTickableTickType() const
+{
+	return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UEnemySignificanceSubsystem::IsTickable() const
+{
+	return Naves.Num() > 0 || Bench.Fase != INDEX_NONE;
+}
+
+TStatId UEnemySignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemySignificanceSubsystem, STATGROUP_Tickables);
+}
+
+int32 UEnemySignificanceSubsystem::CalcularCuadros(float Distancia, bool bEnPantalla, bool bAtacando) const
+{
+	if (Distancia <= DistanciaCercana)
+	{
+		return 1;
+	}
+
+	const float Cercania = 1.0f - FMath::Clamp((Distancia - DistanciaCercana) / FMath::Max(DistanciaLejana - DistanciaCercana, 1.0f), 0.0f, 1.0f);
+	const float Puntaje = 0.4f * Cercania + (bEnPantalla ? 0.4f : 0.0f) + (bAtacando ? 0.2f : 0.0f);
+	if (Puntaje >= UmbralCadaCuadro)
+	{
+		return 1;
+	}
+	return Puntaje >= UmbralCadaDos ? 2 : 4;
+}
+
+bool UEnemySignificanceSubsystem::CalcularFrustum(FConvexVolume& OutFrustum) const
+{
+	const APlayerController* Controlador = GetWorld()->GetFirstPlayerController();
+	const ULocalPlayer* Local = Controlador ? Controlador->GetLocalPlayer() : nullptr;
+	if (Local == nullptr || Local->ViewportClient == nullptr || Local->ViewportClient->Viewport == nullptr)
+	{
+		return false;
+	}
+
+	FSceneViewProjectionData Proyeccion;
+	if (!Local->GetProjectionData(Local->ViewportClient->Viewport, eSSP_FULL, Proyeccion))
+	{
+		return false;
+	}
+
+	GetViewFrustumBounds(OutFrustum, Proyeccion.ComputeViewProjectionMatrix(), false);
+	return true;
+}
+
+void UEnemySignificanceSubsystem::Evaluar(bool bCompleto)
+{
+	Naves.RemoveAllSwap([](const FNave& Entrada) { return !Entrada.Nave.IsValid(); });
+
+	const APawn* Jugador = UGameplayStatics::GetPlayerPawn(GetWorld(), 0);
+	FConvexVolume Frustum;
+	const bool bHayVista = !bCompleto && CalcularFrustum(Frustum);
+
+	PorNivel[0] = PorNivel[1] = PorNivel[2] = 0;
+	for (FNave& Entrada : Naves)
+	{
+		ANaveEnemiga* Nave = Entrada.Nave.Get();
+
+		// En picada no tiene Tick ni formacion: la mueve UDiveSubsystem cada cuadro y se deja asi
+		const bool bEnPicada = !Nave->EnFormacion() && !Nave->IsActorTickEnabled();
+
+		int32 Cuadros = 1;
+		if (!bCompleto && Jugador && !bEnPicada)
+		{
+			const FVector Posicion = Nave->GetActorLocation();
+			const float Radio = Nave->mallaNaveEnemiga ? Nave->mallaNaveEnemiga->Bounds.SphereRadius : 0.0f;
+			// Sin vista (servidor dedicado) se trata todo como en pantalla
+			const bool bEnPantalla = !bHayVista || Frustum.IntersectSphere(Posicion, Radio);
+			Cuadros = CalcularCuadros(FVector::Dist(Posicion, Jugador->GetActorLocation()), bEnPantalla, !Nave->EnFormacion());
+		}
+
+		// El intervalo del motor va en segundos; medio cuadro menos para no saltar uno de mas
+		if (Cuadros != Entrada.Cuadros)
+		{
+			Entrada.Cuadros = Cuadros;
+			Nave->SetCuadrosActualizacion(Cuadros, Cuadros > 1 ? (Cuadros - 0.5f) * DeltaPromedio : 0.0f);
+		}
+		++PorNivel[Cuadros == 1 ? 0 : (Cuadros == 2 ? 1 : 2)];
+	}
+
+	SET_DWORD_STAT(STAT_Significancia_Cada1, PorNivel[0]);
+	SET_DWORD_STAT(STAT_Significancia_Cada2, PorNivel[1]);
+	SET_DWORD_STAT(STAT_Significancia_Cada4, PorNivel[2]);
+}
+
+void UEnemySignificanceSubsystem::IniciarBench(int32 Cantidad, int32 Cuadros)
+{
+	if (Bench.Fase != INDEX_NONE)
+	{
+		UE_LOG(LogGalaga_USFX, Warning, TEXT("Significance bench: ya hay uno corriendo"));
+		return;
+	}
+
+	UShipRegistrySubsystem* Registro = GetWorld()->GetSubsystem<UShipRegistrySubsystem>();
+	if (Registro == nullptr || !Registro->Existe(TEXT("EnemigaTransporte")))
+	{
+		UE_LOG(LogGalaga_USFX, Warning, TEXT("Significance bench: no hay tipo EnemigaTransporte en el registro"));
+		return;
+	}
+
+	// Como los refuerzos: muy por detras de la formacion, fuera de pantalla
+	const APawn* Jugador = UGameplayStatics::GetPlayerPawn(GetWorld(), 0);
+	const FVector Origen = (Jugador ? Jugador->GetActorLocation() : FVector::ZeroVector) + FVector(3000.0f, 0.0f, 0.0f);
+
+	// Las naves de una oleada se mueven en formacion, que es donde se gasta el tiempo por nave
+	FActorSpawnParameters Parametros;
+	Parametros.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	AFormationManager* Formacion = GetWorld()->SpawnActor<AFormationManager>(Origen, FRotator::ZeroRotator, Parametros);
+	Formacion->IntervaloPicadas = 0.0f;
+	Bench.Formacion = Formacion;
+
+	for (int32 i = 0; i < Cantidad; ++i)
+	{
+		const FVector Posicion = Origen + FVector((i / 50) * 150.0f, -1000.0f + (i % 50) * 40.0f, 0.0f);
+		if (ANaveEnemiga* Nave = Registro->Crear(TEXT("EnemigaTransporte"), FTransform(Posicion)))
+		{
+			Formacion->AgregarNave(Nave);
+			Bench.Naves.Add(Nave);
+		}
+	}
+
+	Bench.Cuadros = FMath::Max(Cuadros, 1);
+	Bench.Fase = 0;
+	Bench.Contados = INDEX_NONE;
+	Bench.Total = 0.0;
+}
+
+void UEnemySignificanceSubsystem::AvanzarBench(float DeltaTime)
+{
+	if (Bench.Fase == INDEX_NONE)
+	{
+		return;
+	}
+
+	AFormationManager* Formacion = Bench.Formacion.Get();
+	if (Formacion == nullptr)
+	{
+		Bench.Naves.Reset();
+		Bench.Fase = INDEX_NONE;
+		return;
+	}
+
+	// Solo la escritura de transforms de la formacion: es lo que la significancia ahorra. El
+	// primer cuadro de cada fase se descarta porque la formacion lo midio con la fase anterior
+	if (Bench.Contados >= 0)
+	{
+		Bench.Total += Formacion->GetCostoEscrituraMs();
+	}
+	++Bench.Contados;
+
+	if (Bench.Contados < Bench.Cuadros)
+	{
+		return;
+	}
+
+	Bench.Resultado[Bench.Fase] = Bench.Total / Bench.Contados;
+	Bench.Total = 0.0;
+	Bench.Contados = INDEX_NONE;
+	if (Bench.Fase == 0)
+	{
+		UE_LOG(LogGalaga_USFX, Display, TEXT("Significance bench: con significancia %d naves cada cuadro, %d cada 2, %d cada 4"),
+			PorNivel[0], PorNivel[1], PorNivel[2]);
+		Bench.Fase = 1;
+		return;
+	}
+
+	UE_LOG(LogGalaga_USFX, Display, TEXT("Significance bench: %d naves, escritura de la formacion %.3f ms por cuadro con significancia, %.3f ms sin"),
+		Bench.Naves.Num(), Bench.Resultado[0], Bench.Resultado[1]);
+
+	// La formacion suelta las naves al irse y vuelven dormidas al registro
+	Formacion->Destroy();
+	UShipRegistrySubsystem* Registro = GetWorld()->GetSubsystem<UShipRegistrySubsystem>();
+	for (const TWeakObjectPtr<ANaveEnemiga>& Nave : Bench.Naves)
+	{
+		if (Nave.IsValid() && !Nave->EstaDormida())
+		{
+			if (Registro)
+			{
+				Registro->Guardar(Nave.Get());
+			}
+			else
+			{
+				Nave->Destroy();
+			}
+		}
+	}
+	Bench.Naves.Reset();
+	Bench.Fase = INDEX_NONE;
+}
@@ -0,0 +1,118 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "EnemySignificanceSubsystem.generated.h"
+
+class ANaveEnemiga;
+struct FConvexVolume;
+
+/**
+ * Reparte la frecuencia de actualizacion de las naves enemigas segun su importancia: cercania
+ * al jugador, si estan en pantalla y si atacan (fuera de formacion). Las importantes se
+ * actualizan cada cuadro, las demas cada 2 o cada 4 (ANaveEnemiga::SetCuadrosActualizacion).
+ *
+ * Una nave con Tick propio recibe el intervalo de Tick; el motor le pasa el tiempo acumulado,
+ * asi que Mover y el temporizador de disparo avanzan lo mismo en total. Las naves en formacion
+ * no tickean: AFormationManager calcula todas cada cuadro y solo escribe la posicion de las
+ * poco importantes en los cuadros que les tocan. Las naves en picada quedan en cada cuadro.
+ *
+ * Las naves a menos de DistanciaCercana del jugador tickean siempre cada cuadro; el campo
+ * de balas barre el movimiento de cada objetivo entre cuadros, asi que un paso largo de una
+ * nave lejana no deja pasar balas.
+ */
+UCLASS(config = Game)
+class GALAGA_USFX_API UEnemySignificanceSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+public:
+	void RegisterNave(ANaveEnemiga* Nave);
+	void UnregisterNave(ANaveEnemiga* Nave);
+
+	FORCEINLINE int32 GetNumNaves() const { return Naves.Num(); }
+
+	// Naves que tickean cada 1, 2 y 4 cuadros en la ultima evaluacion
+	FORCEINLINE int32 GetNumEnNivel(int32 Nivel) const { return PorNivel[Nivel]; }
+
+	// Galaga.Significance.Bench: arma una formacion de Cantidad naves del registro lejos del
+	// jugador y compara su costo de escritura con la significancia prendida y apagada durante
+	// Cuadros cuadros cada una
+	void IniciarBench(int32 Cantidad, int32 Cuadros);
+
+	// Cuadros entre Ticks (1, 2 o 4) para una nave con esta distancia al jugador
+	int32 CalcularCuadros(float Distancia, bool bEnPantalla, bool bAtacando) const;
+
+protected:
+	// Mas cerca que esto la nave tickea cada cuadro sin importar lo demas
+	UPROPERTY(Config)
+	float DistanciaCercana = 600.0f;
+
+	// Desde esta distancia la cercania no suma
+	UPROPERTY(Config)
+	float DistanciaLejana = 3000.0f;
+
+	// Puntaje minimo para tickear cada cuadro y cada 2 cuadros; por debajo, cada 4
+	UPROPERTY(Config)
+	float UmbralCadaCuadro = 0.6f;
+
+	UPROPERTY(Config)
+	float UmbralCadaDos = 0.3f;
+
+	// Segundos entre evaluaciones; la frecuencia de una nave no cambia mas rapido que esto
+	UPROPERTY(Config)
+	float ReevaluarCada = 0.1f;
+
+private:
+	// Asigna a cada nave su frecuencia. Con bCompleto todas vuelven a cada cuadro
+	void Evaluar(bool bCompleto);
+
+	// Frustum de la camara del jugador; falso si no hay vista (servidor, sin viewport)
+	bool CalcularFrustum(FConvexVolume& OutFrustum) const;
+
+	void AvanzarBench(float DeltaTime);
+
+	struct FNave
+	{
+		TWeakObjectPtr<ANaveEnemiga> Nave;
+		int32 Cuadros;
+	};
+
+	TArray<FNave> Naves;
+	int32 PorNivel[3] = { 0, 0, 0 };
+
+	float HastaEvaluar = 0.0f;
+
+	// Promedio del tiempo de cuadro; el intervalo de Tick del motor va en segundos
+	float DeltaPromedio = 1.0f / 60.0f;
+
+	// Si la ultima evaluacion uso la significancia o dejo todo en cada cuadro
+	bool bActiva = false;
+
+	struct FBench
+	{
+		TWeakObjectPtr<class AFormationManager> Formacion;
+		TArray<TWeakObjectPtr<ANaveEnemiga>> Naves;
+		int32 Cuadros = 0;
+		int32 Fase = INDEX_NONE;
+		int32 Contados = 0;
+		double Total = 0.0;
+		double Resultado[2] = { 0.0, 0.0 };
+	};
+
+	FBench Bench;
+};
@@ -0,0 +1,120 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "EscudoComponent.h"
+#include "BulletFieldSubsystem.h"
+#include "Galaga_USFX.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "UObject/ConstructorHelpers.h"
+
+UEscudoComponent::UEscudoComponent()
+{
+	// Solo cuenta la duracion mientras esta prendido
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+
+	// La malla y colocacion del escudo que antes era un actor aparte
+	static ConstructorHelpers::FObjectFinder<UStaticMesh> Mesh(TEXT("StaticMesh'/Game/Meshes/Shapes/Shape_Trim.Shape_Trim'"));
+	SetStaticMesh(Mesh.Object);
+	SetRelativeLocation(FVector(0.0f, 10.0f, 180.0f));
+	SetRelativeScale3D(FVector(2.0f, 0.6f, 1.0f));
+	SetCollisionProfileName(TEXT("Escudo"));
+	SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	SetVisibility(false);
+	SetCastShadow(false);
+
+	RadioX = 220.0f;
+	RadioY = 160.0f;
+	ResistenciaMaxima = 100.0f;
+	bActivo = false;
+	Restante = 0.0f;
+	Resistencia = 0.0f;
+	Absorbidas = 0;
+}
+
+void UEscudoComponent::Activar(float Duracion)
+{
+	Restante = Duracion;
+	Resistencia = ResistenciaMaxima;
+	if (bActivo)
+	{
+		return;
+	}
+
+	bActivo = true;
+	Absorbidas = 0;
+	SetVisibility(true);
+	// Los proyectiles actor (campo de balas apagado) chocan con el perfil "Escudo" y se
+	// descartan con AbsorberImpacto en su NotifyHit
+	SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	SetComponentTickEnabled(true);
+
+	if (UBulletFieldSubsystem* Campo = GetWorld()->GetSubsystem<UBulletFieldSubsystem>())
+	{
+		Campo->RegisterShield(this);
+	}
+}
+
+void UEscudoComponent::Desactivar()
+{
+	if (!bActivo)
+	{
+		return;
+	}
+
+	bActivo = false;
+	Restante = 0.0f;
+	SetVisibility(false);
+	SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	SetComponentTickEnabled(false);
+
+	if (UBulletFieldSubsystem* Campo = GetWorld()->GetSubsystem<UBulletFieldSubsystem>())
+	{
+		Campo->UnregisterShield(this);
+	}
+}
+
+void UEscudoComponent::Absorber(int32 Cantidad, float Dano)
+{
+	Absorbidas += Cantidad;
+	Resistencia -= Dano;
+	if (Resistencia <= 0.0f)
+	{
+		UE_LOG(LogGalaga_USFX, Verbose, TEXT("Escudo roto despues de absorber %d balas"), Absorbidas);
+		Desactivar();
+	}
+}
+
+bool UEscudoComponent::AbsorberImpacto(UPrimitiveComponent* Componente, float Dano)
+{
+	UEscudoComponent* Escudo = Cast<UEscudoComponent>(Componente);
+	if (Escudo == nullptr)
+	{
+		return false;
+	}
+
+	if (Escudo->EstaActivo())
+	{
+		Escudo->Absorber(1, Dano);
+	}
+	return true;
+}
+
+void UEscudoComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	Restante -= DeltaTime;
+	if (Restante <= 0.0f)
+	{
+		Desactivar();
+	}
+}
+
+void UEscudoComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	Desactivar();
+
+	Super::EndPlay(EndPlayReason);
+}
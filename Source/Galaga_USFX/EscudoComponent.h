@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/StaticMeshComponent.h"
+#include "EscudoComponent.generated.h"
+
+/**
+ * Escudo del jugador. Vive siempre en la nave y se prende y apaga en lugar de crear un
+ * actor cada vez. Mientras esta activo el UBulletFieldSubsystem prueba las balas
+ * enemigas contra una elipse de RadioX por RadioY centrada en la nave; cada bala absorbida
+ * descuenta su dano de la resistencia y el escudo se apaga al romperse o al vencer.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class GALAGA_USFX_API UEscudoComponent : public UStaticMeshComponent
+{
+	GENERATED_BODY()
+
+public:
+	UEscudoComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	// Prende el escudo con la resistencia completa; si ya estaba prendido lo recarga
+	UFUNCTION(BlueprintCallable, Category = "Escudo")
+	void Activar(float Duracion);
+
+	UFUNCTION(BlueprintCallable, Category = "Escudo")
+	void Desactivar();
+
+	// Lo llama el campo de balas con lo que absorbio el escudo en el cuadro
+	void Absorber(int32 Cantidad, float Dano);
+
+	// Para los NotifyHit de los proyectiles actor: verdadero si Componente es un escudo, que
+	// entonces se lleva el dano; el proyectil no debe danar a la nave que lo lleva
+	static bool AbsorberImpacto(UPrimitiveComponent* Componente, float Dano);
+
+	FORCEINLINE bool EstaActivo() const { return bActivo; }
+	FORCEINLINE float GetResistencia() const { return Resistencia; }
+	FORCEINLINE int32 GetAbsorbidas() const { return Absorbidas; }
+
+	// Semiejes de la elipse en X (hacia adelante) y en Y
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Escudo")
+	float RadioX;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Escudo")
+	float RadioY;
+
+	// Dano que aguanta antes de romperse
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Escudo")
+	float ResistenciaMaxima;
+
+protected:
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	bool bActivo;
+	float Restante;
+	float Resistencia;
+
+	// Balas absorbidas desde la ultima vez que se activo
+	int32 Absorbidas;
+};
@@ -32,6 +32,8 @@
 //#include "Bonus.h"
 #include "Puntaje.h"
 #include "ShipFactory.h"
+#include "FormationManager.h"
+#include "ShipSpawnSubsystem.h"
 
 // Sets default values
 AFacadeNivel1::AFacadeNivel1()
@@ -89,7 +91,7 @@ void AFacadeNivel1::NivelAvanzado()
 	FRotator RotacionNave = FRotator(180.0f, 0.0f, 0.0f);
 	FVector SpawnNaveLocation2 = FVector(100.f, -500.f, 200.f);
 	UWorld* const World = GetWorld();
-	NaveCazaAlfa = GetWorld()->SpawnActor<ANaveEnemigaCazaAlfa>(SpawnNaveLocation2, RotacionNave);
+	NaveCazaAlfa = Cast<ANaveEnemigaCazaAlfa>(AShipFactory::CrearNaveEnemiga("EnemigaCazaAlfa", GetWorld(), SpawnNaveLocation2, RotacionNave));
 
 
 	FVector SpawnNaveLocation = FVector(500.f, -500.f, 200.f);
@@ -102,44 +104,103 @@ void AFacadeNivel1::NivelAvanzado()
 	{
 		CrearCapsulas();
 
+		// Una sola formacion para todas las oleadas; cada nave entra en su lugar cuando se crea
+		Formacion = World->SpawnActor<AFormationManager>(SpawnNaveLocation, FRotator::ZeroRotator);
 
-		for (int i = 0; i < 6; i++)
-
-		{
+		CrearOleada();
+	}
+}
 
-			FVector PosicionNaveActual = FVector(SpawnNaveLocation.X, SpawnNaveLocation.Y + i * 200, SpawnNaveLocation.Z);
-			ANaveEnemiga* NuevaNaveEnemigaCaza = AShipFactory::CrearNaveEnemiga("EnemigaCaza", World, PosicionNaveActual, RotacionNave);
-			TANavesEnemigas.Push(NuevaNaveEnemigaCaza);
-		}
+void AFacadeNivel1::CrearOleada()
+{
+	FRotator RotacionNave = FRotator(180.0f, 0.0f, 0.0f);
+	FVector SpawnNaveLocation = FVector(500.f, -500.f, 200.f);
 
-		for (int i = 0; i < 6; i++)
+	// Las naves se piden todas juntas pero se crean repartidas en varios cuadros; las de
+	// oleadas anteriores que murieron vuelven despertadas desde el registro
+	TWeakObjectPtr<AFacadeNivel1> Nivel = this;
+	UShipSpawnSubsystem* Creador = GetWorld()->GetSubsystem<UShipSpawnSubsystem>();
+	const int32 Oleada = Creador ? Creador->IniciarOleada([Nivel](ANaveEnemiga* Nave)
+	{
+		if (Nivel.IsValid())
 		{
-			FVector PosicionNaveActual = FVector(SpawnNaveLocation.X + 200, SpawnNaveLocation.Y + i * 200, SpawnNaveLocation.Z);
-			ANaveEnemiga* NuevaNaveEnemigaEspia = AShipFactory::CrearNaveEnemiga("EnemigaEspia", World, PosicionNaveActual, RotacionNave);
-			TANavesEnemigas.Push(NuevaNaveEnemigaEspia);
+			Nivel->AgregarNave(Nave);
 		}
-
-		for (int i = 0; i < 6; i++)
+	},
+	[Nivel](int32 Numero)
+	{
+		if (Nivel.IsValid())
 		{
-			FVector PosicionNaveActual = FVector(SpawnNaveLocation.X + 400, SpawnNaveLocation.Y + i * 200, SpawnNaveLocation.Z);
-			ANaveEnemiga* NuevaNaveEnemigaNodriza = AShipFactory::CrearNaveEnemiga("EnemigaNodriza", World, PosicionNaveActual, RotacionNave);
-			TANavesEnemigas.Push(NuevaNaveEnemigaNodriza);
+			Nivel->bCreandoOleada = false;
 		}
+	}) : INDEX_NONE;
+	bCreandoOleada = Oleada != INDEX_NONE;
 
-		for (int i = 0; i < 6; i++)
-		{
-			FVector PosicionNaveActual = FVector(SpawnNaveLocation.X - 200, SpawnNaveLocation.Y + i * 200, SpawnNaveLocation.Z);
-			ANaveEnemiga* NuevaNaveEnemigaReabastecimiento = AShipFactory::CrearNaveEnemiga("EnemigaReabastecimiento", World, PosicionNaveActual, RotacionNave);
-			TANavesEnemigas.Push(NuevaNaveEnemigaReabastecimiento);
-		}
+	for (int i = 0; i < 6; i++)
+	{
+		FVector PosicionNaveActual = FVector(SpawnNaveLocation.X, SpawnNaveLocation.Y + i * 200, SpawnNaveLocation.Z);
+		PedirNave("EnemigaCaza", Oleada, PosicionNaveActual, RotacionNave);
+	}
 
-		for (int i = 0; i < 6; i++)
-		{
-			FVector PosicionNaveActual = FVector(SpawnNaveLocation.X - 400, SpawnNaveLocation.Y + i * 200, SpawnNaveLocation.Z);
-			ANaveEnemiga* NuevaNaveEnemigaTransporte = AShipFactory::CrearNaveEnemiga("EnemigaTransporte", World, PosicionNaveActual, RotacionNave);
-			TANavesEnemigas.Push(NuevaNaveEnemigaTransporte);
-		}
+	for (int i = 0; i < 6; i++)
+	{
+		FVector PosicionNaveActual = FVector(SpawnNaveLocation.X + 200, SpawnNaveLocation.Y + i * 200, SpawnNaveLocation.Z);
+		PedirNave("EnemigaEspia", Oleada, PosicionNaveActual, RotacionNave);
+	}
 
+	for (int i = 0; i < 6; i++)
+	{
+		FVector PosicionNaveActual = FVector(SpawnNaveLocation.X + 400, SpawnNaveLocation.Y + i * 200, SpawnNaveLocation.Z);
+		PedirNave("EnemigaNodriza", Oleada, PosicionNaveActual, RotacionNave);
+	}
+
+	for (int i = 0; i < 6; i++)
+	{
+		FVector PosicionNaveActual = FVector(SpawnNaveLocation.X - 200, SpawnNaveLocation.Y + i * 200, SpawnNaveLocation.Z);
+		PedirNave("EnemigaReabastecimiento", Oleada, PosicionNaveActual, RotacionNave);
+	}
+
+	for (int i = 0; i < 6; i++)
+	{
+		FVector PosicionNaveActual = FVector(SpawnNaveLocation.X - 400, SpawnNaveLocation.Y + i * 200, SpawnNaveLocation.Z);
+		PedirNave("EnemigaTransporte", Oleada, PosicionNaveActual, RotacionNave);
+	}
+}
+
+void AFacadeNivel1::PedirNave(const FString& TipoNave, int32 Oleada, const FVector& Posicion, const FRotator& Rotacion)
+{
+	// Sin cola (Oleada INDEX_NONE) se crea en el momento, como antes
+	if (Oleada == INDEX_NONE || !AShipFactory::EncolarNaveEnemiga(TipoNave, GetWorld(), Oleada, Posicion, Rotacion))
+	{
+		AgregarNave(AShipFactory::CrearNaveEnemiga(TipoNave, GetWorld(), Posicion, Rotacion));
+	}
+}
+
+void AFacadeNivel1::AgregarNave(ANaveEnemiga* Nave)
+{
+	if (Nave == nullptr)
+	{
+		return;
+	}
+
+	TANavesEnemigas.Push(Nave);
+	Nave->AlDestruirse.AddUObject(this, &AFacadeNivel1::QuitarNave);
+	if (Formacion)
+	{
+		// La formacion ya se movio desde que se pidio la nave: nace donde esta su lugar ahora
+		Nave->SetActorLocation(Formacion->GetPosicionSlot(Nave->GetActorLocation()));
+		Formacion->AgregarNave(Nave);
+	}
+}
+
+void AFacadeNivel1::QuitarNave(ANaveEnemiga* Nave)
+{
+	TANavesEnemigas.Remove(Nave);
+
+	// Oleada despejada: la siguiente sale de las naves que acaban de morir
+	if (TANavesEnemigas.Num() == 0 && !bCreandoOleada && Formacion)
+	{
+		CrearOleada();
 	}
 }
 
@@ -23,6 +23,10 @@ public:
 	FTimerHandle Spawn;
 	class ANaveEnemigaCazaAlfa* NaveCazaAlfa;
 
+	// Mueve en lote las naves de la oleada mientras estan en formacion
+	UPROPERTY()
+	class AFormationManager* Formacion;
+
 public:
 	TArray<class ANaveEnemiga*> TANavesEnemigas;
 	TArray<class ANaveEnemigaCaza*> TANavesEnemigasCaza;
@@ -44,4 +48,20 @@ public:
 	void NivelAvanzado();
 	void CrearCapsulas();
 
+	// Pide la nave a la cola de la oleada; sin cola la crea enseguida
+	void PedirNave(const FString& TipoNave, int32 Oleada, const FVector& Posicion, const FRotator& Rotacion);
+
+	// Guarda la nave recien creada y la mete en la formacion
+	void AgregarNave(class ANaveEnemiga* Nave);
+
+	// Pide las naves de una oleada; sale otra cuando mueren todas las de la anterior
+	void CrearOleada();
+
+	// La nave murio y volvio dormida al registro
+	void QuitarNave(class ANaveEnemiga* Nave);
+
+private:
+	// Hay una oleada en la cola del UShipSpawnSubsystem que todavia no termino de crearse
+	bool bCreandoOleada = false;
+
 };
@@ -14,12 +14,13 @@
 #include "NaveEnemigaCaza.h"
 #include "NaveEnemigaEspia.h"
 #include "NaveEnemigaTransporte.h"
+#include "WeaponsSubsystem.h"
 
 // Sets default values
 AFacadeTipoDisparo::AFacadeTipoDisparo()
 {
- 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+ 	// Solo reenvia al UWeaponsSubsystem, no necesita Tick
+	PrimaryActorTick.bCanEverTick = false;
 
 }
 
@@ -27,6 +28,7 @@ AFacadeTipoDisparo::AFacadeTipoDisparo()
 void AFacadeTipoDisparo::BeginPlay()
 {
 	Super::BeginPlay();
+	Armas = GetWorld()->GetSubsystem<UWeaponsSubsystem>();
 	//recargar = GetWorld()->SpawnActor<AFacadeRecargar>(AFacadeRecargar::StaticClass());
 	
 }
@@ -39,29 +41,12 @@ void AFacadeTipoDisparo::Tick(float DeltaTime)
 }
 
 
-void AFacadeTipoDisparo::Launch(FString TipoDisparo,FVector SpawnLocation,FVector SpawnDirection)
+void AFacadeTipoDisparo::Launch(FProjectileArchetypeHandle Arquetipo, FVector SpawnLocation, FVector Velocity)
 {
-
-	if (TipoDisparo == "Misile")
-	{
-		misil = GetWorld()->SpawnActor<ADisparoMisil>(ADisparoMisil::StaticClass(), SpawnLocation, FRotator::ZeroRotator);
-	}
-	else if (TipoDisparo == "Foton")
-	{	
-		foton = GetWorld()->SpawnActor<AFoton>(AFoton::StaticClass(), SpawnLocation, FRotator::ZeroRotator);
-	}
-	else if (TipoDisparo == "Laser")
+	// Las naves ya no tienen facade propio; se conserva para quien lo siga usando
+	if (Armas)
 	{
-		laser = GetWorld()->SpawnActor<ALaser>(ALaser::StaticClass(), SpawnLocation, FRotator::ZeroRotator);
-	}
-	else if (TipoDisparo == "Bomba")
-	{
-		bomba = GetWorld()->SpawnActor<ABomba>(ABomba::StaticClass(), SpawnLocation, FRotator::ZeroRotator);
-	}
-	else if (TipoDisparo == "Basico")
-	{
-		Basic = GetWorld()->SpawnActor<ADisparoBasic>(ADisparoBasic::StaticClass(), SpawnLocation, FRotator::ZeroRotator);
-
+		Armas->Launch(Arquetipo, SpawnLocation, Velocity, EBulletOwner::Enemigo);
 	}
 
 	
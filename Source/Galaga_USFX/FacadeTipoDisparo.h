@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "ProjectileArchetype.h"
 #include "FacadeTipoDisparo.generated.h"
 
 UCLASS()
@@ -29,12 +30,15 @@ private:
 	class AFoton* foton;
 	class ADisparoMisil* misil;
 	class ADisparoBasic * Basic;
+	UPROPERTY()
+	class UWeaponsSubsystem* Armas;
 	//class AFacadeRecargar* recargar; 
 
 public:
 	void AsignarDisparo(FString TipoDisparo);
 	//void Laser();
-	 void Launch(FString TipoDisparo,FVector SpawnLocation,FVector SpawnDirection);
+	 // Velocity ya trae la direccion y la rapidez; ver UProjectileArchetypeSubsystem::GetVelocidad
+	 void Launch(FProjectileArchetypeHandle Arquetipo, FVector SpawnLocation, FVector Velocity);
 	// void Recargar();
 	 void DisparoLaser();
 	 void DisparoFoton();
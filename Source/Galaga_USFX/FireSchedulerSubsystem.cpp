@@ -0,0 +1,205 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FireSchedulerSubsystem.h"
+#include "NaveEnemiga.h"
+#include "Galaga_USFX.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Disparos programados"), STAT_FireScheduler_Tick, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Disparos en espera"), STAT_FireScheduler_Pendientes, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Disparos de naves"), STAT_FireScheduler_Disparos, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Disparos acumulados en una nave"), STAT_FireScheduler_Acumulados, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Disparos descartados"), STAT_FireScheduler_Descartados, STATGROUP_Game);
+
+static TAutoConsoleVariable<int32> CVarFireScheduler(
+	TEXT("Galaga.Fire.Scheduler"),
+	1,
+	TEXT("1: los disparos de las naves se desfasan y se limitan por cuadro. 0: cada nave dispara en cuanto vence su temporizador."));
+
+// Galaga.Fire.Histogram [reset]
+static void HistogramaDisparos(const TArray<FString>& Args, UWorld* World)
+{
+	if (UFireSchedulerSubsystem* Programador = World ? World->GetSubsystem<UFireSchedulerSubsystem>() : nullptr)
+	{
+		Programador->LogHistogramas();
+		if (Args.Num() > 0 && Args[0] == TEXT("reset"))
+		{
+			Programador->ReiniciarHistogramas();
+		}
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CmdHistogramaDisparos(
+	TEXT("Galaga.Fire.Histogram"),
+	TEXT("Galaga.Fire.Histogram [reset]: cuadros por cantidad de disparos pedidos y hechos; con reset empieza de cero"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&HistogramaDisparos));
+
+bool UFireSchedulerSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World != nullptr && World->IsGameWorld();
+}
+
+void UFireSchedulerSubsystem::Deinitialize()
+{
+	Cola.Reset();
+	EnCola.Reset();
+	Cabeza = 0;
+	Pendientes = 0;
+
+	Super::Deinitialize();
+}
+
+bool UFireSchedulerSubsystem::IsEnabled()
+{
+	return CVarFireScheduler.GetValueOnGameThread() != 0;
+}
+
+void UFireSchedulerSubsystem::RegisterNave(ANaveEnemiga* Nave)
+{
+	if (Nave == nullptr)
+	{
+		return;
+	}
+
+	++NumNaves;
+
+	// Razon aurea: cada nave nueva cae en el hueco mas grande entre las anteriores
+	const float Fase = FMath::Frac(Registradas++ * 0.6180339887f);
+	if (IsEnabled())
+	{
+		Nave->SetFireRate(Fase * Nave->GetIntervaloDisparo());
+	}
+}
+
+void UFireSchedulerSubsystem::UnregisterNave(ANaveEnemiga* Nave)
+{
+	// Una nave dormida o muerta no deja sus disparos en espera para la proxima vida
+	int32 Quitados = 0;
+	if (EnCola.RemoveAndCopyValue(Nave, Quitados))
+	{
+		Cola.RemoveSingle(Nave);
+		Pendientes -= Quitados;
+		Descartados += Quitados;
+		INC_DWORD_STAT_BY(STAT_FireScheduler_Descartados, Quitados);
+	}
+	NumNaves = FMath::Max(NumNaves - 1, 0);
+}
+
+void UFireSchedulerSubsystem::Encolar(ANaveEnemiga* Nave)
+{
+	++PedidosCuadro;
+	if (!IsEnabled())
+	{
+		Nave->Disparar();
+		++DirectosCuadro;
+		return;
+	}
+
+	++Pendientes;
+	int32& DeLaNave = EnCola.FindOrAdd(Nave);
+	if (DeLaNave++ > 0)
+	{
+		// Ya tiene su lugar en la cola; el disparo sale despues del que espera
+		INC_DWORD_STAT(STAT_FireScheduler_Acumulados);
+		return;
+	}
+	Cola.Add(Nave);
+}
+
+void UFireSchedulerSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_FireScheduler_Tick);
+
+	// Primero lo atrasado, en el orden en que se pidio. Una nave con mas disparos en espera vuelve
+	// al final y sigue en otro cuadro, asi no dispara dos veces en el mismo lugar
+	int32 Disparos = DirectosCuadro;
+	DirectosCuadro = 0;
+	const int32 Fin = Cola.Num();
+	while (Cabeza < Fin && Disparos < MaxDisparosPorCuadro)
+	{
+		const TWeakObjectPtr<ANaveEnemiga> Entrada = Cola[Cabeza++];
+		ANaveEnemiga* Nave = Entrada.Get();
+		if (Nave && !Nave->EstaDormida())
+		{
+			Nave->Disparar();
+			++Disparos;
+			--Pendientes;
+
+			// Se busca despues de Disparar, que puede cambiar la cola
+			int32* DeLaNave = EnCola.Find(Entrada);
+			if (DeLaNave && --*DeLaNave > 0)
+			{
+				Cola.Add(Entrada);
+				continue;
+			}
+		}
+		else if (const int32* DeLaNave = EnCola.Find(Entrada))
+		{
+			Pendientes -= *DeLaNave;
+			Descartados += *DeLaNave;
+			INC_DWORD_STAT_BY(STAT_FireScheduler_Descartados, *DeLaNave);
+		}
+		EnCola.Remove(Entrada);
+	}
+	if (Cabeza > 0)
+	{
+		Cola.RemoveAt(0, Cabeza, false);
+		Cabeza = 0;
+	}
+
+	++HistogramaPedidos[FMath::Min(PedidosCuadro, NumCasillas - 1)];
+	++HistogramaDisparos[FMath::Min(Disparos, NumCasillas - 1)];
+	PedidosCuadro = 0;
+
+	INC_DWORD_STAT_BY(STAT_FireScheduler_Disparos, Disparos);
+	SET_DWORD_STAT(STAT_FireScheduler_Pendientes, Pendientes);
+}
+
+ETickableTickType UFireSchedulerSubsystem::GetTickableTickType() const
+{
+	return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UFireSchedulerSubsystem::IsTickable() const
+{
+	return NumNaves > 0 || Cola.Num() > 0;
+}
+
+TStatId UFireSchedulerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFireSchedulerSubsystem, STATGROUP_Tickables);
+}
+
+void UFireSchedulerSubsystem::ReiniciarHistogramas()
+{
+	FMemory::Memzero(HistogramaPedidos);
+	FMemory::Memzero(HistogramaDisparos);
+	Descartados = 0;
+}
+
+void UFireSchedulerSubsystem::LogHistogramas() const
+{
+	int32 Cuadros = 0;
+	int32 PeorPedido = 0;
+	int32 PeorDisparo = 0;
+	for (int32 Casilla = 0; Casilla < NumCasillas; ++Casilla)
+	{
+		Cuadros += HistogramaPedidos[Casilla];
+		PeorPedido = HistogramaPedidos[Casilla] > 0 ? Casilla : PeorPedido;
+		PeorDisparo = HistogramaDisparos[Casilla] > 0 ? Casilla : PeorDisparo;
+	}
+
+	UE_LOG(LogGalaga_USFX, Display, TEXT("Fire histogram: %d cuadros, %d naves, tope %d por cuadro, %d en espera de %d naves, %d descartados; peor cuadro %d pedidos, %d disparos"),
+		Cuadros, NumNaves, MaxDisparosPorCuadro, Pendientes, EnCola.Num(), Descartados, PeorPedido, PeorDisparo);
+	for (int32 Casilla = 0; Casilla < NumCasillas; ++Casilla)
+	{
+		if (HistogramaPedidos[Casilla] > 0 || HistogramaDisparos[Casilla] > 0)
+		{
+			UE_LOG(LogGalaga_USFX, Display, TEXT("  %2d%s disparos: %6d cuadros pedidos, %6d cuadros hechos"),
+				Casilla, Casilla == NumCasillas - 1 ? TEXT("+") : TEXT(" "), HistogramaPedidos[Casilla], HistogramaDisparos[Casilla]);
+		}
+	}
+}
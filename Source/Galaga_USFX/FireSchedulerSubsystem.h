@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "FireSchedulerSubsystem.generated.h"
+
+class ANaveEnemiga;
+
+/**
+ * Reparte los disparos de las naves enemigas entre cuadros. Cada nave recibe al nacer un
+ * desfase de su temporizador (secuencia de la razon aurea), asi las naves de una oleada no
+ * disparan todas en el mismo cuadro. Ademas hay un tope de disparos por cuadro: los que no
+ * entran se guardan en orden para el cuadro siguiente. El temporizador de la nave no espera
+ * al disparo, asi que la cadencia media no cambia.
+ *
+ * Cada nave ocupa a lo sumo un lugar en la cola y lleva la cuenta de sus disparos en espera:
+ * si vuelve a pedir antes de disparar se suma a la cuenta, y despues de cada disparo vuelve al
+ * final de la cola si le quedan. Ningun pedido se pierde aunque el tope quede corto muchos
+ * cuadros; solo se descartan los de una nave que se duerme o muere, y se cuentan aparte.
+ */
+UCLASS(config = Game)
+class GALAGA_USFX_API UFireSchedulerSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+public:
+	static bool IsEnabled();
+
+	// Le da a la nave su desfase; llamar en BeginPlay despues de fijar IntervaloDisparo
+	void RegisterNave(ANaveEnemiga* Nave);
+	void UnregisterNave(ANaveEnemiga* Nave);
+
+	// La nave debe disparar; sale este cuadro o el siguiente con lugar, despues de los que ya tenga
+	// en espera. Con Galaga.Fire.Scheduler en 0 dispara enseguida, pero igual cuenta para los histogramas
+	void Encolar(ANaveEnemiga* Nave);
+
+	// Disparos en espera de todas las naves
+	FORCEINLINE int32 GetPendientes() const { return Pendientes; }
+
+	// Disparos pedidos que no salieron porque la nave se durmio o murio antes de su turno
+	FORCEINLINE int32 GetDescartados() const { return Descartados; }
+
+	// Cuadros en que se pidieron o se hicieron N disparos; la ultima casilla junta N o mas
+	static constexpr int32 NumCasillas = 17;
+	FORCEINLINE const int32* GetHistogramaPedidos() const { return HistogramaPedidos; }
+	FORCEINLINE const int32* GetHistogramaDisparos() const { return HistogramaDisparos; }
+
+	void ReiniciarHistogramas();
+	void LogHistogramas() const;
+
+protected:
+	UPROPERTY(Config)
+	int32 MaxDisparosPorCuadro = 8;
+
+private:
+	TArray<TWeakObjectPtr<ANaveEnemiga>> Cola;
+	int32 Cabeza = 0;
+
+	// Disparos en espera de cada nave que esta en Cola; una nave entra a Cola una sola vez
+	TMap<TWeakObjectPtr<ANaveEnemiga>, int32> EnCola;
+	int32 Pendientes = 0;
+	int32 Descartados = 0;
+
+	int32 NumNaves = 0;
+	int32 Registradas = 0;
+	int32 PedidosCuadro = 0;
+
+	// Disparos hechos en Encolar con el programador apagado
+	int32 DirectosCuadro = 0;
+
+	int32 HistogramaPedidos[NumCasillas] = {};
+	int32 HistogramaDisparos[NumCasillas] = {};
+};
@@ -0,0 +1,340 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FormationManager.h"
+#include "NaveEnemiga.h"
+#include "DiveSubsystem.h"
+#include "Galaga_USFX.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Formacion"), STAT_Formacion_Tick, STATGROUP_Game);
+DECLARE_CYCLE_STAT(TEXT("Formacion calculo"), STAT_Formacion_Calculo, STATGROUP_Game);
+DECLARE_CYCLE_STAT(TEXT("Formacion instancias"), STAT_Formacion_Instancias, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Naves instanciadas"), STAT_Formacion_Instanciadas, STATGROUP_Game);
+
+static TAutoConsoleVariable<int32> CVarFormacionInstancias(
+	TEXT("Galaga.Formation.Instancias"),
+	1,
+	TEXT("1: las naves en formacion se dibujan con instancias por malla. 0: cada nave con su propia malla."));
+
+// Galaga.Formation.Report: primitivas y costo de escritura de cada formacion del mundo
+static void ReportarFormaciones(const TArray<FString>& Args, UWorld* World)
+{
+	if (World == nullptr)
+	{
+		return;
+	}
+
+	for (TActorIterator<AFormationManager> It(World); It; ++It)
+	{
+		const AFormationManager* Formacion = *It;
+		UE_LOG(LogGalaga_USFX, Display, TEXT("%s: %d naves, %d instanciadas, %d primitivas, escritura %.3f ms"),
+			*Formacion->GetName(), Formacion->GetNumNaves(), Formacion->GetNumInstancias(),
+			Formacion->ContarPrimitivas(), Formacion->GetCostoEscrituraMs());
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CmdReportarFormaciones(
+	TEXT("Galaga.Formation.Report"),
+	TEXT("Galaga.Formation.Report: naves, primitivas y costo de escritura de transforms por formacion; comparar con Galaga.Formation.Instancias 0 y 1"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&ReportarFormaciones));
+
+AFormationManager::AFormationManager()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Raiz"));
+
+	Velocidad = 400.0f;
+	LimiteY = 1000.0f;
+	IntervaloPicadas = 4.0f;
+	HastaPicada = IntervaloPicadas;
+	Desplazamiento = FVector::ZeroVector;
+	bInstanciada = false;
+	NumInstancias = 0;
+	CostoEscrituraMs = 0.0;
+}
+
+void AFormationManager::AgregarNave(ANaveEnemiga* Nave)
+{
+	if (Nave == nullptr || Nave->EnFormacion())
+	{
+		return;
+	}
+
+	if (Slots.Num() == 0)
+	{
+		Velocidad = Nave->GetVelocidad() * 100.0f;
+		bInstanciada = CVarFormacionInstancias.GetValueOnGameThread() != 0;
+	}
+
+	FSlot& Slot = Slots.AddDefaulted_GetRef();
+	Slot.Nave = Nave;
+	Slot.Offset = Nave->GetActorLocation() - Desplazamiento;
+	Slot.Grupo = Nave->mallaNaveEnemiga ? BuscarGrupo(Nave->mallaNaveEnemiga->GetStaticMesh()) : INDEX_NONE;
+	Slot.bActor = Slot.Grupo == INDEX_NONE;
+
+	Nave->SetFormacion(this);
+	Nave->SetActorTickEnabled(false);
+	Preparar(Nave, bInstanciada && !Slot.bActor);
+}
+
+void AFormationManager::QuitarNave(ANaveEnemiga* Nave)
+{
+	Slots.RemoveAll([Nave](const FSlot& Slot) { return Slot.Nave.Get() == Nave; });
+	Soltar(Nave);
+}
+
+void AFormationManager::MostrarComoActor(ANaveEnemiga* Nave, bool bActor)
+{
+	for (FSlot& Slot : Slots)
+	{
+		if (Slot.Nave.Get() == Nave && Slot.Grupo != INDEX_NONE)
+		{
+			Slot.bActor = bActor;
+			Preparar(Nave, bInstanciada && !bActor);
+		}
+	}
+}
+
+void AFormationManager::Preparar(ANaveEnemiga* Nave, bool bEnInstancia) const
+{
+	// Oculta no entra en la escena, asi que no cuesta primitiva ni render state; la colision sigue igual
+	if (Nave && Nave->mallaNaveEnemiga)
+	{
+		Nave->mallaNaveEnemiga->SetVisibility(!bEnInstancia);
+	}
+}
+
+void AFormationManager::Soltar(ANaveEnemiga* Nave) const
+{
+	if (Nave)
+	{
+		Preparar(Nave, false);
+		Nave->SetFormacion(nullptr);
+		Nave->SetActorTickEnabled(true);
+	}
+}
+
+int32 AFormationManager::BuscarGrupo(UStaticMesh* Malla)
+{
+	if (Malla == nullptr)
+	{
+		return INDEX_NONE;
+	}
+
+	int32 Grupo = MallaGrupo.Find(Malla);
+	if (Grupo != INDEX_NONE)
+	{
+		return Grupo;
+	}
+
+	UHierarchicalInstancedStaticMeshComponent* Instancias = NewObject<UHierarchicalInstancedStaticMeshComponent>(this);
+	Instancias->SetStaticMesh(Malla);
+	Instancias->SetMobility(EComponentMobility::Movable);
+	Instancias->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Instancias->SetupAttachment(RootComponent);
+	Instancias->SetUsingAbsoluteLocation(true);
+	Instancias->SetUsingAbsoluteRotation(true);
+	Instancias->SetUsingAbsoluteScale(true);
+	Instancias->RegisterComponent();
+
+	Grupo = Grupos.Add(Instancias);
+	MallaGrupo.Add(Malla);
+	TransformsPorGrupo.AddDefaulted();
+	return Grupo;
+}
+
+void AFormationManager::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	SCOPE_CYCLE_COUNTER(STAT_Formacion_Tick);
+
+	Slots.RemoveAll([](const FSlot& Slot) { return !Slot.Nave.IsValid(); });
+
+	// Cambiar la variable en juego pasa todas las naves de un modo al otro
+	const bool bInstanciar = CVarFormacionInstancias.GetValueOnGameThread() != 0;
+	if (bInstanciar != bInstanciada)
+	{
+		bInstanciada = bInstanciar;
+		for (const FSlot& Slot : Slots)
+		{
+			Preparar(Slot.Nave.Get(), bInstanciada && !Slot.bActor);
+		}
+	}
+
+	// Un solo avance del origen para toda la oleada
+	FEnemyKernel::AvanzarFormacion(Desplazamiento, Velocidad, DeltaTime, LimiteY);
+
+	// Fase de calculo: solo lee Estados y escribe Resultados, puede correr en otros hilos
+	Estados.Reset(Slots.Num());
+	for (const FSlot& Slot : Slots)
+	{
+		const ANaveEnemiga* Nave = Slot.Nave.Get();
+		FEnemyEstado& Estado = Estados.AddDefaulted_GetRef();
+		Estado.Offset = Slot.Offset;
+		Estado.Temporizador = Nave->GetFireRate();
+		Estado.Intervalo = Nave->GetIntervaloDisparo();
+	}
+	{
+		SCOPE_CYCLE_COUNTER(STAT_Formacion_Calculo);
+		FEnemyKernel::Calcular(Estados, Desplazamiento, LimiteY, DeltaTime, Resultados, FEnemyKernel::UsarParalelo(Estados.Num()));
+	}
+
+	// Fase de aplicar, en el hilo de juego: las transformaciones se escriben juntas, despues el disparo de cada nave.
+	// Las naves poco importantes se escriben cada 2 o 4 cuadros, repartidas por slot; la posicion
+	// calculada es absoluta, asi que al tocarle la nave queda justo donde debe
+	const double Inicio = FPlatformTime::Seconds();
+	for (int32 i = 0; i < Slots.Num(); ++i)
+	{
+		ANaveEnemiga* Nave = Slots[i].Nave.Get();
+		const int32 Cada = Nave->GetCuadrosActualizacion();
+		if (Cada <= 1 || (GFrameCounter + i) % Cada == 0)
+		{
+			Nave->SetActorLocation(Resultados[i].Posicion);
+		}
+	}
+	ActualizarInstancias();
+	CostoEscrituraMs = (FPlatformTime::Seconds() - Inicio) * 1000.0;
+
+	// Disparar puede sacar naves de la formacion (y de Slots), asi que se guardan antes
+	Disparan.Reset(Slots.Num());
+	for (const FSlot& Slot : Slots)
+	{
+		Disparan.Add(Slot.Nave);
+	}
+	for (int32 i = 0; i < Disparan.Num(); ++i)
+	{
+		if (ANaveEnemiga* Nave = Disparan[i].Get())
+		{
+			Nave->AplicarDisparo(Resultados[i].Temporizador, Resultados[i].bDispara);
+		}
+	}
+
+	// Al final, asi la nave que sale ya no esta en los resultados de este cuadro
+	if (IntervaloPicadas > 0.0f)
+	{
+		HastaPicada -= DeltaTime;
+		if (HastaPicada <= 0.0f)
+		{
+			HastaPicada = IntervaloPicadas;
+			LanzarPicada();
+		}
+	}
+}
+
+bool AFormationManager::GetOffset(const ANaveEnemiga* Nave, FVector& OutOffset) const
+{
+	for (const FSlot& Slot : Slots)
+	{
+		if (Slot.Nave.Get() == Nave)
+		{
+			OutOffset = Slot.Offset;
+			return true;
+		}
+	}
+	return false;
+}
+
+FVector AFormationManager::GetPosicionSlot(const FVector& Offset) const
+{
+	FVector Posicion = Offset + Desplazamiento;
+	Posicion.Y = FEnemyKernel::Envolver(Posicion.Y, LimiteY);
+	return Posicion;
+}
+
+void AFormationManager::LanzarPicada()
+{
+	UDiveSubsystem* Picadas = GetWorld()->GetSubsystem<UDiveSubsystem>();
+	if (Picadas == nullptr || Slots.Num() == 0)
+	{
+		return;
+	}
+
+	const FSlot& Slot = Slots[FMath::RandHelper(Slots.Num())];
+	if (ANaveEnemiga* Nave = Slot.Nave.Get())
+	{
+		// Las del lado -Y bajan reflejadas, asi las dos mitades cruzan hacia el centro
+		Picadas->Lanzar(Nave, Picadas->GetRutaAlAzar(), Slot.Offset.Y < 0.0f);
+	}
+}
+
+void AFormationManager::ActualizarInstancias()
+{
+	SCOPE_CYCLE_COUNTER(STAT_Formacion_Instancias);
+
+	for (TArray<FTransform>& Transforms : TransformsPorGrupo)
+	{
+		Transforms.Reset();
+	}
+
+	NumInstancias = 0;
+	if (bInstanciada)
+	{
+		for (const FSlot& Slot : Slots)
+		{
+			if (!Slot.bActor)
+			{
+				TransformsPorGrupo[Slot.Grupo].Add(Slot.Nave->mallaNaveEnemiga->GetComponentTransform());
+				++NumInstancias;
+			}
+		}
+	}
+
+	for (int32 Grupo = 0; Grupo < Grupos.Num(); ++Grupo)
+	{
+		UHierarchicalInstancedStaticMeshComponent* Instancias = Grupos[Grupo];
+		const TArray<FTransform>& Transforms = TransformsPorGrupo[Grupo];
+
+		// Igual que el campo de balas: solo se agregan o quitan instancias del final y el resto se reescribe en lote
+		for (int32 Sobrante = Instancias->GetInstanceCount() - 1; Sobrante >= Transforms.Num(); --Sobrante)
+		{
+			Instancias->RemoveInstance(Sobrante);
+		}
+		while (Instancias->GetInstanceCount() < Transforms.Num())
+		{
+			Instancias->AddInstance(FTransform::Identity);
+		}
+		if (Transforms.Num() > 0)
+		{
+			Instancias->BatchUpdateInstancesTransforms(0, Transforms, true, true, true);
+		}
+	}
+	SET_DWORD_STAT(STAT_Formacion_Instanciadas, NumInstancias);
+}
+
+int32 AFormationManager::ContarPrimitivas() const
+{
+	int32 Primitivas = 0;
+	for (const FSlot& Slot : Slots)
+	{
+		const ANaveEnemiga* Nave = Slot.Nave.Get();
+		if (Nave && Nave->mallaNaveEnemiga && Nave->mallaNaveEnemiga->IsVisible())
+		{
+			++Primitivas;
+		}
+	}
+	for (const UHierarchicalInstancedStaticMeshComponent* Instancias : Grupos)
+	{
+		Primitivas += Instancias && Instancias->GetInstanceCount() > 0 ? 1 : 0;
+	}
+	return Primitivas;
+}
+
+void AFormationManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Las naves que quedan vuelven a su propio Tick y a su malla
+	while (Slots.Num() > 0)
+	{
+		ANaveEnemiga* Nave = Slots.Last().Nave.Get();
+		Slots.Pop(false);
+		Soltar(Nave);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
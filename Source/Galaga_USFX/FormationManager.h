@@ -0,0 +1,123 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "EnemyKernel.h"
+#include "FormationManager.generated.h"
+
+class ANaveEnemiga;
+class UStaticMesh;
+class UHierarchicalInstancedStaticMeshComponent;
+
+/**
+ * Mueve toda una oleada como una sola formacion. Guarda el offset de cada nave, avanza el
+ * origen de la formacion una vez por cuadro (el mismo Y -= velocidad*100*dt con vuelta en
+ * +-LimiteY que hacia el Mover de cada nave) y escribe todas las posiciones en un solo bucle.
+ * Las naves en formacion tienen el Tick apagado; su disparo lo avanza la formacion.
+ *
+ * El cuadro tiene dos fases: FEnemyKernel::Calcular saca posiciones y disparos de todas las
+ * naves (con ParallelFor en formaciones grandes, sin tocar actores) y despues el hilo de juego
+ * aplica los resultados: transforms en lote, instancias y por ultimo los disparos. Las naves
+ * que UEnemySignificanceSubsystem baja a cada 2 o 4 cuadros solo escriben su transform en esos
+ * cuadros; el disparo se sigue aplicando cada cuadro.
+ *
+ * Con Galaga.Formation.Instancias las naves en formacion ocultan su malla y se dibujan con
+ * un UHierarchicalInstancedStaticMeshComponent por malla de nave; la colision de cada actor
+ * no cambia. Una nave vuelve a dibujarse sola al salir de la formacion o con MostrarComoActor.
+ */
+UCLASS()
+class GALAGA_USFX_API AFormationManager : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AFormationManager();
+
+	virtual void Tick(float DeltaTime) override;
+
+	// Mete la nave en la formacion en el lugar donde esta y le apaga el Tick
+	void AgregarNave(ANaveEnemiga* Nave);
+
+	// La nave sale de la formacion (picada, escape...) y vuelve a moverse con su propio Tick
+	void QuitarNave(ANaveEnemiga* Nave);
+
+	// La nave sigue en formacion pero se dibuja con su propia malla (efectos, parpadeo de dano...)
+	void MostrarComoActor(ANaveEnemiga* Nave, bool bActor);
+
+	FORCEINLINE int32 GetNumNaves() const { return Slots.Num(); }
+
+	// Lugar de la nave relativo al origen de la formacion; falso si no esta en ella
+	bool GetOffset(const ANaveEnemiga* Nave, FVector& OutOffset) const;
+
+	// Donde esta ahora el lugar con ese offset, ya envuelto en +-LimiteY
+	FVector GetPosicionSlot(const FVector& Offset) const;
+
+	// Primitivas que dibujan la formacion: mallas de naves visibles mas componentes de instancias
+	int32 ContarPrimitivas() const;
+
+	FORCEINLINE int32 GetNumInstancias() const { return NumInstancias; }
+	FORCEINLINE double GetCostoEscrituraMs() const { return CostoEscrituraMs; }
+
+	// Unidades por segundo hacia -Y; la toma de la primera nave que entra
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Formacion")
+	float Velocidad;
+
+	// Al pasar de -LimiteY la nave reaparece en +LimiteY
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Formacion")
+	float LimiteY;
+
+	// Segundos entre naves que salen en picada (UDiveSubsystem); 0 no lanza ninguna
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Formacion")
+	float IntervaloPicadas;
+
+protected:
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	// Oculta o muestra la malla propia de la nave
+	void Preparar(ANaveEnemiga* Nave, bool bInstanciada) const;
+	void Soltar(ANaveEnemiga* Nave) const;
+
+	// Indice del grupo de instancias para la malla, creandolo si hace falta
+	int32 BuscarGrupo(UStaticMesh* Malla);
+
+	void ActualizarInstancias();
+
+	// Manda una nave al azar en picada, reflejando la ruta segun el lado de la formacion
+	void LanzarPicada();
+
+	struct FSlot
+	{
+		TWeakObjectPtr<ANaveEnemiga> Nave;
+		FVector Offset;
+		int32 Grupo;
+		bool bActor;
+	};
+
+	TArray<FSlot> Slots;
+
+	// Cuanto se movio el origen de la formacion, ya envuelto en el periodo 2*LimiteY
+	FVector Desplazamiento;
+
+	// Entrada y salida de la fase de calculo, una entrada por slot
+	TArray<FEnemyEstado> Estados;
+	TArray<FEnemyResultado> Resultados;
+
+	// Naves de cada resultado para la fase de disparos, en el orden de Slots
+	TArray<TWeakObjectPtr<ANaveEnemiga>> Disparan;
+
+	// Un componente de instancias por malla de nave
+	UPROPERTY()
+	TArray<UHierarchicalInstancedStaticMeshComponent*> Grupos;
+
+	TArray<UStaticMesh*> MallaGrupo;
+	TArray<TArray<FTransform>> TransformsPorGrupo;
+
+	float HastaPicada;
+
+	bool bInstanciada;
+	int32 NumInstancias;
+	double CostoEscrituraMs;
+};
@@ -5,6 +5,11 @@
 #include "Engine/StaticMeshActor.h"
 #include "Galaga_USFXProjectile.h"
 #include "Galaga_USFXPawn.h"
+#include "ProjectilePool.h"
+#include "DamageQueue.h"
+#include "EscudoComponent.h"
+#include "ProjectileArchetype.h"
+#include "Engine/World.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 
 // Sets default values
@@ -12,26 +17,18 @@ AFoton::AFoton()
 {
  	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
-	static ConstructorHelpers::FObjectFinder<UStaticMesh> BallMesh(TEXT("StaticMesh'/Game/Content/Meshes/BulletEnemyLevel1.BulletEnemyLevel1'"));
 	Fotonmalla = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("StaticMesh'/Game/Content/Meshes/BulletEnemyLevel1.BulletEnemyLevel1'"));
-	Fotonmalla->BodyInstance.SetCollisionProfileName("Projectile");
 	RootComponent = Fotonmalla;
-	Fotonmalla->SetStaticMesh(BallMesh.Object);
-	Fotonmalla->SetRelativeScale3D(FVector(2.5f, 2.5f, 2.5f));
 	Fotonmalla->SetupAttachment(RootComponent);
 
 	//Fotonmalla->SetCollisionProfileName(UCollisionProfile::Pawn_ProfileName);
 
 	ProjectileMovementComponent = CreateDefaultSubobject<UProjectileMovementComponent>(TEXT("ProjectileMovementComponent"));
 	ProjectileMovementComponent->UpdatedComponent = Fotonmalla;
-	ProjectileMovementComponent->InitialSpeed = 1000.0f;
-	ProjectileMovementComponent->MaxSpeed = 1000.0f;
 	ProjectileMovementComponent->bRotationFollowsVelocity = true;
 	ProjectileMovementComponent->bShouldBounce = false;
 	ProjectileMovementComponent->bShouldBounce = true;
 	//ProjectileMovementComponent->Bounciness = 0.6f;  // Ajusta la cantidad de energa que se conserva despus de un rebote
-	Damage = 10;
-	InitialLifeSpan = 2.0f;
 
 }
 
@@ -39,7 +36,17 @@ AFoton::AFoton()
 void AFoton::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	// Malla, velocidades, dano y vida util salen del arquetipo "Foton"
+	if (UProjectileArchetypeSubsystem* Arquetipos = GetWorld()->GetSubsystem<UProjectileArchetypeSubsystem>())
+	{
+		const FProjectileArchetypeHandle Arquetipo = Arquetipos->FindHandle(TEXT("Foton"));
+		Arquetipos->Aplicar(Arquetipo, this);
+		if (Arquetipo.IsValid())
+		{
+			Damage = Arquetipos->Get(Arquetipo).Dano;
+		}
+	}
 }
 
 // Called every frame
@@ -53,15 +60,19 @@ void AFoton::Tick(float DeltaTime)
 void AFoton::NotifyHit(UPrimitiveComponent* MyComp, AActor* Other, UPrimitiveComponent* OtherComp, bool bSelfMoved, FVector HitLocation, FVector HitNormal, FVector NormalImpulse, const FHitResult& Hit)
 {
 
+	// El escudo de la nave se lleva el impacto, no el jugador
+	if (UEscudoComponent::AbsorberImpacto(OtherComp, Damage))
+	{
+		UProjectilePoolSubsystem::ReleaseOrDestroy(this);
+		return;
+	}
+
 	AGalaga_USFXPawn* GalagaPawn = Cast<AGalaga_USFXPawn>(Other);
 	if (GalagaPawn)
 	{
-		Destroy();
-		vida = GalagaPawn->GetVida();
-		vida = vida - 10;
-		GalagaPawn->SetVida(vida);
-		FString Message = FString::Printf(TEXT("Vida Jugador: %d"), vida);
-		GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Green, Message);
+		UProjectilePoolSubsystem::ReleaseOrDestroy(this);
+		// El dano se suma en la cola y se aplica una sola vez al final del cuadro
+		UDamageQueueSubsystem::EncolarDano(GalagaPawn, Damage, TEXT("Foton"));
 	}
 }
 
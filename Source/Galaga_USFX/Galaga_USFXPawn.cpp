@@ -32,6 +32,9 @@
 #include "StateInterface.h"
 #include "StrategyPawnInterface.h"
 #include "ZigZagStrategy.h"
+#include "BulletFieldSubsystem.h"
+#include "WeaponPatternComponent.h"
+#include "EscudoComponent.h"
 
 #include "GameFramework/PlayerInput.h"
 #include "GameFramework/CharacterMovementComponent.h"
@@ -72,13 +75,16 @@ AGalaga_USFXPawn::AGalaga_USFXPawn()
 	// Weapon
 	GunOffset = FVector(90.f, 0.f, 0.f);
 	FireRate = 0.1f;
-	bCanFire = true;
 
 
 	NumProyectilesDisparados = 0;
 	MaxProyectilesDisparados = 50; //Establece el nmero mximo de proyectiles disparados
 	MyInventory =
 		CreateDefaultSubobject<UInventoryComponent>("MyInventory");
+	PatronDisparo = CreateDefaultSubobject<UWeaponPatternComponent>("PatronDisparo");
+	PatronDisparo->OffsetCanon = GunOffset;
+	Escudo = CreateDefaultSubobject<UEscudoComponent>(TEXT("Escudo"));
+	Escudo->SetupAttachment(RootComponent);
 	NumItems = 0;
 	Life = 1000;
 }
@@ -222,6 +228,8 @@ void AGalaga_USFXPawn::ReturnStart()
 
 void AGalaga_USFXPawn::Tick(float DeltaSeconds)
 {
+	// Los disparos del cuadro se reparten entre esta posicion y la final
+	const FVector OrigenAnterior = GetActorLocation();
 
 	// Ejecuta la estrategia de movimiento actual
 	if (CurrentMovementStrategy != nullptr)
@@ -259,7 +267,7 @@ void AGalaga_USFXPawn::Tick(float DeltaSeconds)
 	const FVector FireDirection = FVector(FireForwardValue, FireRightValue, 0.f);
 
 	// Try and fire a shot
-	FireShot(FireDirection);
+	FireShot(FireDirection, DeltaSeconds, OrigenAnterior);
 
 	if (velocity)
 	{
@@ -286,99 +294,50 @@ void AGalaga_USFXPawn::BeginPlay()
 	StateEnergiaFull = GetWorld()->SpawnActor<AStateEnergiaFull>(AStateEnergiaFull::StaticClass());
 	
 	InicializarEstados();
-}
-
-void AGalaga_USFXPawn::FireShot(FVector FireDirection)
-{
-	// If it's ok to fire again
-	if (bCanFire == true && NumProyectilesDisparados < MaxProyectilesDisparados)
-	{
-		// Incrementa el contador de proyectiles disparados
-
-		// If we are pressing fire stick in a direction
-		if (FireDirection.SizeSquared() > 0.0f)
-		{
-			const FRotator FireRotation = FireDirection.Rotation();
-			// Spawn projectile at an offset from this pawn
-			const FVector SpawnLocation = GetActorLocation() + FireRotation.RotateVector(GunOffset);
-
-			UWorld* const World = GetWorld();
-			if (World != nullptr)
-			{
-				// spawn the projectile
-				//World->SpawnActor<AGalaga_USFXProjectile>(SpawnLocation, FireRotation);
-			
-
-				// spawn the projectile
-				// Spawn the three projectiles
-				//float BulletSpacing = 100.0f; // Ajusta el valor segn sea necesario
-
-				for (int i = 0; i < 3; ++i)
-				{
-					//World->SpawnActor<AGalaga_USFX_L01Projectile>(SpawnLocation, FireRotation);
-					FRotator ModifiedRotation = FireRotation;
-					// Modify rotation for each projectile
-					ModifiedRotation.Yaw += (i - 1) * 20.0f; // Offset rotation by 10 degrees
-
-					// Calcular la ubicacin de spawn de la bala actual
-					//FVector BulletSpawnLocation = SpawnLocation + FireRotation.RotateVector(FVector(0.f, i * BulletSpacing, 0.f));
-
-					// Spawn the projectile
-					//World->SpawnActor<AGalaga_USFX_L01Projectile>(BulletSpawnLocation, FireRotation);
-
-
-					const FVector ModifiedSpawnLocation = GetActorLocation() + ModifiedRotation.RotateVector(GunOffset);
-
-					//// Spawn the projectile
-					World->SpawnActor<AGalaga_USFXProjectile>(ModifiedSpawnLocation, ModifiedRotation);
-				}
-			
-			
-			}
-			// Restablece el contador cuando se alcance el lmite mximo
-			if (NumProyectilesDisparados >= MaxProyectilesDisparados)
-			{
-				bCanFire = false;
-				GetWorld()->GetTimerManager().SetTimer(TimerHandle_ShotTimerExpired, this, &AGalaga_USFXPawn::ShotTimerExpired, FireRate);
-			}
-
-
-			bCanFire = false;
-			World->GetTimerManager().SetTimer(TimerHandle_ShotTimerExpired, this, &AGalaga_USFXPawn::ShotTimerExpired, FireRate);
 
-			// try and play the sound if specified
-			if (FireSound != nullptr)
-			{
-				UGameplayStatics::PlaySoundAtLocation(this, FireSound, GetActorLocation());
-			}
+	// GunOffset puede venir cambiado desde el Blueprint
+	PatronDisparo->SetOffsetCanon(GunOffset);
 
-			bCanFire = false;
-		}
+	// Las balas enemigas del campo de balas chocan contra el pawn
+	if (UBulletFieldSubsystem* Campo = GetWorld()->GetSubsystem<UBulletFieldSubsystem>())
+	{
+		Campo->RegisterTarget(this, EBulletOwner::Jugador);
 	}
 }
 
-void AGalaga_USFXPawn::ShotTimerExpired()
+void AGalaga_USFXPawn::FireShot(FVector FireDirection, float DeltaSeconds, const FVector& OrigenAnterior)
 {
+	const int32 Restantes = MaxProyectilesDisparados - NumProyectilesDisparados;
+	if (PatronDisparo == nullptr || Restantes <= 0)
+	{
+		return;
+	}
 
-	// Restablece el contador y permite disparar de nuevo
-	++NumProyectilesDisparados; // Incrementa el contador de proyectiles disparados en 1
+	// El patron lleva su propio acumulador; puede salir mas de una andanada por cuadro
+	const int32 Andanadas = PatronDisparo->Disparar(DeltaSeconds, FireDirection, OrigenAnterior, GetActorLocation(), FireRate, Restantes);
+	if (Andanadas == 0)
+	{
+		return;
+	}
 
+	// Cada andanada gasta una municion, como antes cada vez que vencia el timer
+	NumProyectilesDisparados += Andanadas;
 	if (NumProyectilesDisparados >= MaxProyectilesDisparados)
 	{
-		//NumProyectilesDisparados = 0;
 		if (GEngine)
 		{
 			GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, "No tienes municiones");
 			GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Green, "Presiona Shift para recargar");
-
-
 		}
 	}
 
-	bCanFire = true;
+	// try and play the sound if specified
+	if (FireSound != nullptr)
+	{
+		UGameplayStatics::PlaySoundAtLocation(this, FireSound, GetActorLocation());
+	}
 }
 
-
 void AGalaga_USFXPawn::DropItem()
 {
 	if (MyInventory->CurrentInventory.IsEmpty())//MyInventory->CurrentInventory.Num() == 0
@@ -529,7 +488,6 @@ void AGalaga_USFXPawn::ReloadAmmo()
 			MaxProyectilesDisparados = 50; // Establece el nmero mximo de proyectiles disparados
 			//MunicionRapidaItem= 0; // Restablece la velocidad de las municiones
 			VelocidadMunicionIncremento = 1000.0f; // Restablece la velocidad de las municiones
-			bCanFire = true; // Permite al jugador disparar nuevamente.
 
 
 			// Muestra un mensaje de depuracin
@@ -679,7 +637,11 @@ void AGalaga_USFXPawn::MoveFast()
 
 	MoveSpeed = 2000.0f;
 
-	GetWorld()->GetTimerManager().SetTimer(TimerHandle_ShotTimerExpired, this, &AGalaga_USFXPawn::VelocidadNormal, 5.0f);
+	// Tick llama a MoveFast cada cuadro mientras dure; reiniciar el timer aqui nunca lo dejaria vencer
+	if (!GetWorld()->GetTimerManager().IsTimerActive(TimerHandle_Velocidad))
+	{
+		GetWorld()->GetTimerManager().SetTimer(TimerHandle_Velocidad, this, &AGalaga_USFXPawn::VelocidadNormal, 5.0f);
+	}
 }
 
 void AGalaga_USFXPawn::VelocidadNormal()
@@ -691,7 +653,7 @@ void AGalaga_USFXPawn::VelocidadNormal()
 void AGalaga_USFXPawn::MoveFastExtreme()
 {
 	MoveSpeed = 4000.0f;
-	GetWorld()->GetTimerManager().SetTimer(TimerHandle_ShotTimerExpired, this, &AGalaga_USFXPawn::VelocidadNormal, 5.0f);
+	GetWorld()->GetTimerManager().SetTimer(TimerHandle_Velocidad, this, &AGalaga_USFXPawn::VelocidadNormal, 5.0f);
 }
 
 //void AGalaga_USFXPawn::SetState(IStateInterface* State)
@@ -30,6 +30,14 @@ public:
 
 	UPROPERTY()
 	UInventoryComponent* MyInventory;
+
+	/** Patron de disparo (abanico, rafaga...) y su acumulador de tiempo */
+	UPROPERTY(Category = Gameplay, VisibleAnywhere, BlueprintReadOnly)
+	class UWeaponPatternComponent* PatronDisparo;
+
+	/** Escudo persistente; el estado protegido lo prende y apaga */
+	UPROPERTY(Category = Gameplay, VisibleAnywhere, BlueprintReadOnly)
+	class UEscudoComponent* Escudo;
 	UFUNCTION()
 	void DropItem();
 	UFUNCTION()
@@ -93,11 +101,8 @@ protected:
     virtual void DoubleShot();
 	virtual void ReturnStart();
 
-	/* Fire a shot in the specified direction */
-	void FireShot(FVector FireDirection);
-
-	/* Handler for the fire timer expiry */
-	void ShotTimerExpired();
+	/* Fire the shots due this frame in the specified direction; OrigenAnterior is where the ship started the frame */
+	void FireShot(FVector FireDirection, float DeltaSeconds, const FVector& OrigenAnterior);
 
 	//Recargar energia
 	void ReloadEnergy();
@@ -114,15 +119,11 @@ protected:
 
 private:
 
-	/* Flag to control firing  */
-	uint32 bCanFire : 1;
-
-	/** Handle for efficient management of ShotTimerExpired timer */
-	FTimerHandle TimerHandle_ShotTimerExpired;
+	/** Duracion de MoveFast/MoveFastExtreme */
+	FTimerHandle TimerHandle_Velocidad;
 
 	int32 NumProyectilesDisparados;
 	int32 MaxProyectilesDisparados;
-
 	
 
 	public:
@@ -141,6 +142,8 @@ public:
 	FORCEINLINE class UCameraComponent* GetCameraComponent() const { return CameraComponent; }
 	/** Returns CameraBoom subobject **/
 	FORCEINLINE class USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
+	/** Returns Escudo subobject **/
+	FORCEINLINE class UEscudoComponent* GetEscudo() const { return Escudo; }
 
 
 //	patron state
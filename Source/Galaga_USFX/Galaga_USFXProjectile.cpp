@@ -6,31 +6,46 @@
 #include "Components/StaticMeshComponent.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Engine/StaticMesh.h"
+#include "ProjectilePool.h"
+#include "ProjectileArchetype.h"
+#include "DamageQueue.h"
+#include "EscudoComponent.h"
+#include "NaveEnemiga.h"
+#include "Engine/World.h"
 
 AGalaga_USFXProjectile::AGalaga_USFXProjectile() 
 {
 	// Static reference to the mesh to use for the projectile
-	static ConstructorHelpers::FObjectFinder<UStaticMesh> ProjectileMeshAsset(TEXT("/Game/TwinStick/Meshes/TwinStickProjectile.TwinStickProjectile"));
-
-	// Create mesh component for the projectile sphere
+	// Create mesh component for the projectile sphere; the mesh comes from the "Jugador" archetype
 	ProjectileMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("ProjectileMesh0"));
-	ProjectileMesh->SetStaticMesh(ProjectileMeshAsset.Object);
 	ProjectileMesh->SetupAttachment(RootComponent);
-	ProjectileMesh->BodyInstance.SetCollisionProfileName("Projectile");
 	ProjectileMesh->OnComponentHit.AddDynamic(this, &AGalaga_USFXProjectile::OnHit);		// set up a notification for when this component hits something
 	RootComponent = ProjectileMesh;
 
 	// Use a ProjectileMovementComponent to govern this projectile's movement
 	ProjectileMovement = CreateDefaultSubobject<UProjectileMovementComponent>(TEXT("ProjectileMovement0"));
 	ProjectileMovement->UpdatedComponent = ProjectileMesh;
-	ProjectileMovement->InitialSpeed = 3000.f;
-	ProjectileMovement->MaxSpeed = 3000.f;
 	ProjectileMovement->bRotationFollowsVelocity = true;
 	ProjectileMovement->bShouldBounce = false;
 	ProjectileMovement->ProjectileGravityScale = 0.f; // No gravity
 
-	// Die after 3 seconds by default
-	InitialLifeSpan = 3.0f;
+	Damage = FProjectileArchetypeRow().Dano;
+}
+
+void AGalaga_USFXProjectile::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Speed, lifespan, mesh and damage come from the "Jugador" archetype
+	if (UProjectileArchetypeSubsystem* Arquetipos = GetWorld()->GetSubsystem<UProjectileArchetypeSubsystem>())
+	{
+		const FProjectileArchetypeHandle Arquetipo = Arquetipos->FindHandle(TEXT("Jugador"));
+		Arquetipos->Aplicar(Arquetipo, this);
+		if (Arquetipo.IsValid())
+		{
+			Damage = Arquetipos->Get(Arquetipo).Dano;
+		}
+	}
 }
 
 void AGalaga_USFXProjectile::OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
@@ -41,5 +56,11 @@ void AGalaga_USFXProjectile::OnHit(UPrimitiveComponent* HitComp, AActor* OtherAc
 		OtherComp->AddImpulseAtLocation(GetVelocity() * 20.0f, GetActorLocation());
 	}
 
-	Destroy();
+	// Enemy ships take the hit through the damage queue, like the player does; a shield absorbs it instead
+	if (!UEscudoComponent::AbsorberImpacto(OtherComp, Damage) && Cast<ANaveEnemiga>(OtherActor))
+	{
+		UDamageQueueSubsystem::EncolarDano(OtherActor, Damage, TEXT("Jugador"));
+	}
+
+	UProjectilePoolSubsystem::ReleaseOrDestroy(this);
 }
\ No newline at end of file
@@ -22,9 +22,14 @@ class AGalaga_USFXProjectile : public AActor
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"))
 	UProjectileMovementComponent* ProjectileMovement;
 
+	/** Damage dealt to enemy ships, taken from the "Jugador" archetype */
+	float Damage;
+
 public:
 	AGalaga_USFXProjectile();
 
+	virtual void BeginPlay() override;
+
 	/** Function to handle the projectile hitting something */
 	UFUNCTION()
 	void OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
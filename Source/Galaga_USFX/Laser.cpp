@@ -3,6 +3,11 @@
 
 #include "Laser.h"
 #include "Galaga_USFXPawn.h"
+#include "ProjectilePool.h"
+#include "DamageQueue.h"
+#include "EscudoComponent.h"
+#include "ProjectileArchetype.h"
+#include "Engine/World.h"
 #include "GameFramework/ProjectileMovementComponent.h"  // Aade esta lnea
 
 // Sets default values
@@ -12,27 +17,19 @@ ALaser::ALaser()
 	PrimaryActorTick.bCanEverTick = true;
 
 	
-	static ConstructorHelpers::FObjectFinder<UStaticMesh> BallMesh(TEXT("StaticMesh'/Game/Content/Meshes/BulletLevel2.BulletLevel2'"));
 	lasermalla = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("StaticMesh'/Game/Content/Meshes/BulletLevel2.BulletLevel2'"));
-	lasermalla->BodyInstance.SetCollisionProfileName("Projectile");
 	RootComponent = lasermalla;
-	lasermalla->SetStaticMesh(BallMesh.Object);
-	lasermalla->SetRelativeScale3D(FVector(1.5f, 1.5f, 1.5f));
 	lasermalla->SetupAttachment(RootComponent);
 
 	//lasermalla->SetCollisionProfileName(UCollisionProfile::Pawn_ProfileName);
 
 	ProjectileMovementComponent = CreateDefaultSubobject<UProjectileMovementComponent>(TEXT("ProjectileMovementComponent"));
 	ProjectileMovementComponent->UpdatedComponent=lasermalla;
-	ProjectileMovementComponent->InitialSpeed = 2000.0f;
-	ProjectileMovementComponent->MaxSpeed = 2000.0f;
 	ProjectileMovementComponent->bRotationFollowsVelocity = true;
 	ProjectileMovementComponent->bShouldBounce = false;
 	ProjectileMovementComponent->ProjectileGravityScale=0.0f;
 	ProjectileMovementComponent->bShouldBounce = true;
 	//ProjectileMovementComponent->Bounciness = 0.6f;  // Ajusta la cantidad de energa que se conserva despus de un rebote
-	Damage = 10;
-	InitialLifeSpan = 3.0f;
 }
 
 
@@ -45,6 +42,17 @@ void ALaser::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// Malla, velocidades, dano y vida util salen del arquetipo "Laser"
+	if (UProjectileArchetypeSubsystem* Arquetipos = GetWorld()->GetSubsystem<UProjectileArchetypeSubsystem>())
+	{
+		const FProjectileArchetypeHandle Arquetipo = Arquetipos->FindHandle(TEXT("Laser"));
+		Arquetipos->Aplicar(Arquetipo, this);
+		if (Arquetipo.IsValid())
+		{
+			Damage = Arquetipos->Get(Arquetipo).Dano;
+		}
+	}
+
 	//GEngine -> AddOnScreenDebugMessage(-1, 5.f, FColor::Red, TEXT("Laser creado"));
 	
 }
@@ -53,15 +61,19 @@ void ALaser::NotifyHit(UPrimitiveComponent* MyComp, AActor* Other, UPrimitiveCom
 {
 
 
+	// El escudo de la nave se lleva el impacto, no el jugador
+	if (UEscudoComponent::AbsorberImpacto(OtherComp, Damage))
+	{
+		UProjectilePoolSubsystem::ReleaseOrDestroy(this);
+		return;
+	}
+
 	AGalaga_USFXPawn* GalagaPawn = Cast<AGalaga_USFXPawn>(Other);
 	if (GalagaPawn)
 	{
-		Destroy();
-		vida = GalagaPawn->GetVida();
-		vida = vida - 10;
-		GalagaPawn->SetVida(vida);
-		FString Message = FString::Printf(TEXT("Vida Jugador: %d"), vida);
-		GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Green, Message);
+		UProjectilePoolSubsystem::ReleaseOrDestroy(this);
+		// El dano se suma en la cola y se aplica una sola vez al final del cuadro
+		UDamageQueueSubsystem::EncolarDano(GalagaPawn, Damage, TEXT("Laser"));
 	}
 }
 
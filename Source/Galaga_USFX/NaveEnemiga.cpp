@@ -2,6 +2,15 @@
 #include "NaveEnemiga.h"
 
 #include "Kismet/GameplayStatics.h"
+#include "BulletFieldSubsystem.h"
+#include "BulletPatternSubsystem.h"
+#include "DiveSubsystem.h"
+#include "EnemyKernel.h"
+#include "EnemySignificanceSubsystem.h"
+#include "FireSchedulerSubsystem.h"
+#include "FormationManager.h"
+#include "ShipRegistrySubsystem.h"
+#include "WeaponsSubsystem.h"
 
 
 // Sets default values
@@ -17,9 +26,10 @@ ANaveEnemiga::ANaveEnemiga()
 	mallaNaveEnemiga->SetupAttachment(RootComponent);
 	RootComponent = mallaNaveEnemiga;
 
-	velocidad = 4;
-	limiteY = 1000;
-	limiteX = -1600.0f;
+	Arquetipo = nullptr;
+	resistencia = 0.0f;
+	IntervaloDisparo = 0.0f;
+	FireRate = 0.0f;
 
 	
 
@@ -30,7 +40,184 @@ void ANaveEnemiga::BeginPlay()
 {
 
 	Super::BeginPlay();
-	
+
+	resistencia = GetArquetipo()->Resistencia;
+
+	Armas = GetWorld()->GetSubsystem<UWeaponsSubsystem>();
+	if (Armas && !NombreArquetipo.IsNone())
+	{
+		ArquetipoDisparo = Armas->FindArchetype(NombreArquetipo);
+	}
+
+	Disparos = GetWorld()->GetSubsystem<UFireSchedulerSubsystem>();
+	if (bDormida)
+	{
+		// Se durmio antes de que empezara el mundo y BeginPlay le vuelve a prender el Tick
+		SetActorTickEnabled(false);
+	}
+	else
+	{
+		RegistrarEnSubsistemas();
+	}
+}
+
+void ANaveEnemiga::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	RomperFormacion();
+	if (!bDormida)
+	{
+		DesregistrarDeSubsistemas();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ANaveEnemiga::RegistrarEnSubsistemas()
+{
+	// Las balas del jugador en el campo de balas chocan contra la nave
+	if (UBulletFieldSubsystem* Campo = GetWorld()->GetSubsystem<UBulletFieldSubsystem>())
+	{
+		Campo->RegisterTarget(this, EBulletOwner::Enemigo);
+	}
+
+	// La frecuencia de Tick depende de la distancia al jugador y de si esta en pantalla
+	if (UEnemySignificanceSubsystem* Significancia = GetWorld()->GetSubsystem<UEnemySignificanceSubsystem>())
+	{
+		Significancia->RegisterNave(this);
+	}
+
+	// Desfasa el temporizador para que la oleada no dispare toda en el mismo cuadro
+	if (Disparos)
+	{
+		Disparos->RegisterNave(this);
+	}
+}
+
+void ANaveEnemiga::DesregistrarDeSubsistemas()
+{
+	if (UBulletFieldSubsystem* Campo = GetWorld()->GetSubsystem<UBulletFieldSubsystem>())
+	{
+		Campo->UnregisterTarget(this);
+	}
+	if (UEnemySignificanceSubsystem* Significancia = GetWorld()->GetSubsystem<UEnemySignificanceSubsystem>())
+	{
+		Significancia->UnregisterNave(this);
+	}
+	if (Disparos)
+	{
+		Disparos->UnregisterNave(this);
+	}
+}
+
+void ANaveEnemiga::Dormir()
+{
+	if (bDormida)
+	{
+		return;
+	}
+
+	RomperFormacion();
+	AlDormir();
+	if (HasActorBegunPlay())
+	{
+		DesregistrarDeSubsistemas();
+
+		// Lo que la nave tenia en curso no sigue mientras duerme
+		GetWorldTimerManager().ClearAllTimersForObject(this);
+		if (UBulletFieldSubsystem* Campo = GetWorld()->GetSubsystem<UBulletFieldSubsystem>())
+		{
+			Campo->StopBeams(this);
+		}
+		if (UBulletPatternSubsystem* Patrones = GetWorld()->GetSubsystem<UBulletPatternSubsystem>())
+		{
+			Patrones->Detener(this);
+		}
+		if (UDiveSubsystem* Picadas = GetWorld()->GetSubsystem<UDiveSubsystem>())
+		{
+			Picadas->Cancelar(this);
+		}
+	}
+	bDormida = true;
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+}
+
+void ANaveEnemiga::Despertar(const FTransform& Transform)
+{
+	if (!bDormida)
+	{
+		return;
+	}
+
+	bDormida = false;
+	SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+	Reiniciar();
+
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	SetActorTickEnabled(true);
+	RegistrarEnSubsistemas();
+}
+
+void ANaveEnemiga::Reiniciar()
+{
+	// El planificador le vuelve a dar su fase al registrarla
+	resistencia = GetArquetipo()->Resistencia;
+	FireRate = 0.0f;
+}
+
+float ANaveEnemiga::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
+{
+	const float Dano = Super::TakeDamage(DamageAmount, DamageEvent, EventInstigator, DamageCauser);
+	if (bDormida || Dano <= 0.0f)
+	{
+		return 0.0f;
+	}
+
+	resistencia -= Dano;
+	if (resistencia <= 0.0f)
+	{
+		Destruirse();
+	}
+	else if (AFormationManager* Manager = Formacion.Get())
+	{
+		// El golpe se ve en la nave: sale de la instancia mientras dura el efecto
+		Manager->MostrarComoActor(this, true);
+		GetWorldTimerManager().SetTimer(TimerParpadeo, this, &ANaveEnemiga::TerminarParpadeo, TiempoParpadeo, false);
+	}
+	return Dano;
+}
+
+void ANaveEnemiga::TerminarParpadeo()
+{
+	if (AFormationManager* Manager = Formacion.Get())
+	{
+		Manager->MostrarComoActor(this, false);
+	}
+}
+
+void ANaveEnemiga::Destruirse()
+{
+	if (bDormida)
+	{
+		return;
+	}
+
+	AlDestruirse.Broadcast(this);
+	AlDestruirse.Clear();
+
+	// Sin tipo del registro (creada con SpawnActor) no hay a donde devolverla
+	UShipRegistrySubsystem* Registro = GetWorld()->GetSubsystem<UShipRegistrySubsystem>();
+	if (Registro && !Tipo.IsNone())
+	{
+		Registro->Guardar(this);
+	}
+	else
+	{
+		Destroy();
+	}
 }
 
 // Called every frame
@@ -40,9 +227,70 @@ void ANaveEnemiga::Tick(float DeltaTime)
 
 }
 
+void ANaveEnemiga::ActualizarDisparo(float DeltaTime)
+{
+	const bool bDispara = FEnemyKernel::AvanzarDisparo(FireRate, IntervaloDisparo, DeltaTime);
+	AplicarDisparo(FireRate, bDispara);
+}
+
+void ANaveEnemiga::AplicarDisparo(float Temporizador, bool bDispara)
+{
+	FireRate = Temporizador;
+	if (!bDispara)
+	{
+		return;
+	}
+
+	if (Disparos)
+	{
+		Disparos->Encolar(this);
+	}
+	else
+	{
+		Disparar();
+	}
+}
+
+void ANaveEnemiga::RomperFormacion()
+{
+	if (AFormationManager* Manager = Formacion.Get())
+	{
+		Manager->QuitarNave(this);
+	}
+	Formacion = nullptr;
+}
+
+void ANaveEnemiga::SetCuadrosActualizacion(int32 Cuadros, float IntervaloTick)
+{
+	CuadrosActualizacion = FMath::Max(Cuadros, 1);
+	SetActorTickInterval(IntervaloTick);
+}
+
+FVector ANaveEnemiga::VelocidadDisparo(const FVector& Direccion) const
+{
+	return Armas ? Armas->GetVelocidad(ArquetipoDisparo, Direccion) : FVector::ZeroVector;
+}
+
+void ANaveEnemiga::LanzarDisparo(const FVector& SpawnLocation, const FVector& Direccion)
+{
+	if (Armas == nullptr || !ArquetipoDisparo.IsValid())
+	{
+		return;
+	}
+
+	if (Armas->GetArchetype(ArquetipoDisparo).EsRayo())
+	{
+		Armas->LaunchBeam(ArquetipoDisparo, this, SpawnLocation, Direccion, EBulletOwner::Enemigo);
+	}
+	else
+	{
+		Armas->Launch(ArquetipoDisparo, SpawnLocation, VelocidadDisparo(Direccion), EBulletOwner::Enemigo);
+	}
+}
+
 FString ANaveEnemiga::GetShipName()
 {
-	return ShipName;
+	return GetArquetipo()->Nombre;
 }
 
 
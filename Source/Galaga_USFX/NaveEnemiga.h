@@ -3,74 +3,59 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "ProjectileArchetype.h"
+#include "ShipArchetype.h"
 #include "NaveEnemiga.generated.h"
 //class UstaticMeshComponent;
 
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnNaveDestruida, class ANaveEnemiga*);
+
 UCLASS(abstract)
 class GALAGA_USFX_API ANaveEnemiga : public AActor
 {
 	GENERATED_BODY()
 
+	// Llama a Disparar cuando le toca el turno a la nave
+	friend class UFireSchedulerSubsystem;
+
 public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Projectile, meta = (AllowPrivateAccess = "true"));
 	UStaticMeshComponent* mallaNaveEnemiga; //malla nave enemigo
 
 protected:
-	float resistencia; //Numero de disparos que puede recibir antes de ser destruido
-	float velocidad;
-	float danoProducido; //potencia de cada proyectil que dispsra la nave
-	FString nombre;
-	float tiempoDisparo; //Tiempo que debe transcurrir entre cada disparo
-	FVector posicion; 
-	int trayectoria; //representa a una funcion que la nave debe asumir para moverse
-	int capacidadPasajeros; //numero de naves que puede transportar
-	int capacidadMunicion; //numero de disparos que puede realizar antes de recargar
-	int tipoNave; //
-	float experencia;
-	float energia;
-
-	float peso;
-	float volumen;
-	float limiteY;
-	float limiteX;
+	// Datos del tipo de nave, compartidos por todas las naves del tipo; sin asset se usa el
+	// objeto por defecto de UShipArchetype
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Nave")
+	UShipArchetype* Arquetipo;
+
+	float resistencia; //Puntos de vida que le quedan; empieza en la Resistencia del arquetipo y baja con el dano
 	float FireRate;
 public:
 	
+	FORCEINLINE const UShipArchetype* GetArquetipo() const { return Arquetipo ? Arquetipo : GetDefault<UShipArchetype>(); }
+
+	// Los pone UShipRegistrySubsystem antes de FinishSpawning, asi BeginPlay ya ve el arquetipo
+	FORCEINLINE void SetArquetipo(UShipArchetype* _Arquetipo) { Arquetipo = _Arquetipo; }
+	FORCEINLINE FName GetTipo() const { return Tipo; }
+	FORCEINLINE void SetTipo(FName _Tipo) { Tipo = _Tipo; }
 
 	FORCEINLINE float GetResistencia() const { return resistencia; }
-	FORCEINLINE float GetVelocidad() const { return velocidad; }
-	FORCEINLINE float GetDanoProducido() const { return danoProducido; }
-	FORCEINLINE FString GetNombre() const { return nombre; }
-	FORCEINLINE float GetTiempoDisparo() const { return tiempoDisparo; }
-	FORCEINLINE FVector GetPosicion() const { return posicion; }
-	FORCEINLINE int Gettrayectoria() const { return trayectoria; }
-	FORCEINLINE int GetcapacidadPasajeros() const { return capacidadPasajeros; }
-	FORCEINLINE int GetcapacidadMunicion() const { return capacidadMunicion; }
-	FORCEINLINE int GettipoNave() const { return tipoNave; }
-	FORCEINLINE float Getexperencia() const { return experencia; }
-	FORCEINLINE float Getenergia() const { return energia; }
-	FORCEINLINE float Getpeso() const { return peso; }
-	FORCEINLINE float Getvolumen() const { return volumen; }
-	//FORCEINLINE float GetlimiteZ() const { return limiteZ; }
-	//FORCEINLINE float GetlimiteX() const { return limiteX; }
+	FORCEINLINE float GetVelocidad() const { return GetArquetipo()->Velocidad; }
+	FORCEINLINE float GetDanoProducido() const { return GetArquetipo()->DanoProducido; }
+	FORCEINLINE FString GetNombre() const { return GetArquetipo()->Nombre; }
+	FORCEINLINE float GetTiempoDisparo() const { return GetArquetipo()->TiempoDisparo; }
+	FORCEINLINE int Gettrayectoria() const { return GetArquetipo()->Trayectoria; }
+	FORCEINLINE int GetcapacidadPasajeros() const { return GetArquetipo()->CapacidadPasajeros; }
+	FORCEINLINE int GetcapacidadMunicion() const { return GetArquetipo()->CapacidadMunicion; }
+	FORCEINLINE int GettipoNave() const { return GetArquetipo()->TipoNave; }
+	FORCEINLINE float Getexperencia() const { return GetArquetipo()->Experiencia; }
+	FORCEINLINE float Getenergia() const { return GetArquetipo()->Energia; }
+	FORCEINLINE float Getpeso() const { return GetArquetipo()->Peso; }
+	FORCEINLINE float Getvolumen() const { return GetArquetipo()->Volumen; }
+	FORCEINLINE float GetlimiteY() const { return GetArquetipo()->LimiteY; }
+	FORCEINLINE float GetlimiteX() const { return GetArquetipo()->LimiteX; }
 	
-
 	FORCEINLINE void SetResistencia(float _resistencia) { resistencia = _resistencia; }
-	FORCEINLINE void SetVelocidad(float _velocidad) { velocidad = _velocidad; }
-	FORCEINLINE void SetDanoProducido(float _danoProducido) { danoProducido = _danoProducido; }
-	FORCEINLINE void SetNombre(FString _nombre) { nombre = _nombre; }
-	FORCEINLINE void SetTiempoDisparo(float _tiempoDisparo) { tiempoDisparo = _tiempoDisparo; }
-	FORCEINLINE void SetPosicion(FVector _posicion) { posicion = _posicion; }
-	FORCEINLINE void Settrayectoria(int _trayectoria) { trayectoria = _trayectoria; }
-	FORCEINLINE void SetcapacidadPasajeros(int _capacidadPasajeros) { capacidadPasajeros = _capacidadPasajeros; }
-	FORCEINLINE void SetcapacidadMunicion(int _capacidadMunicion) { capacidadMunicion = _capacidadMunicion; }
-	FORCEINLINE void SettipoNave(int _tipoNave) { tipoNave = _tipoNave; }
-	FORCEINLINE void Setexperencia(float _experencia) { experencia = _experencia; }
-	FORCEINLINE void Setenergia(float _energia) { energia = _energia; }
-	FORCEINLINE void Setpeso(float _peso) { peso = _peso; }
-	FORCEINLINE void Setvolumen(float _volumen) { volumen = _volumen; }
-	//FORCEINLINE void SetlimiteZ(float _limiteZ) { limiteZ = _limiteZ; }
-	//FORCEINLINE void SetlimiteX(float _limiteX) { limiteX = _limiteX; }
 	
 	
 
@@ -82,22 +67,106 @@ public:
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
-	FString ShipName;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// Fila de la tabla de proyectiles que dispara la nave; el handle se resuelve en BeginPlay
+	FName NombreArquetipo;
+	FProjectileArchetypeHandle ArquetipoDisparo;
+
+	// Servicio de disparos del nivel, compartido por todas las naves
+	UPROPERTY()
+	class UWeaponsSubsystem* Armas;
+
+	// Reparte los disparos de todas las naves entre cuadros
+	UPROPERTY()
+	class UFireSchedulerSubsystem* Disparos;
+
+	// Velocidad del arquetipo de la nave en la direccion dada
+	FVector VelocidadDisparo(const FVector& Direccion) const;
+
+	// Dispara el arquetipo de la nave desde SpawnLocation hacia Direccion
+	void LanzarDisparo(const FVector& SpawnLocation, const FVector& Direccion);
+
+	// Segundos entre disparos (0: la nave no dispara sola); FireRate acumula el tiempo
+	float IntervaloDisparo;
+
+	// Llama a Disparar cada IntervaloDisparo segundos
+	void ActualizarDisparo(float DeltaTime);
+
+	// Formacion que mueve a la nave mientras su Tick esta apagado
+	TWeakObjectPtr<class AFormationManager> Formacion;
 
 public:	
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
 	FORCEINLINE float GetFireRate() const { return FireRate; }
 	FORCEINLINE void SetFireRate(float _FireRate) { FireRate = _FireRate; }
+	FORCEINLINE float GetIntervaloDisparo() const { return IntervaloDisparo; }
+
+	// Lo llama AFormationManager en la fase de aplicar: guarda el FireRate que calculo
+	// FEnemyKernel y, si le toco, pide el disparo al UFireSchedulerSubsystem
+	void AplicarDisparo(float Temporizador, bool bDispara);
+
+	// Sale de la formacion y vuelve a moverse con su propio Tick
+	void RomperFormacion();
+
+	FORCEINLINE bool EnFormacion() const { return Formacion.IsValid(); }
+	FORCEINLINE class AFormationManager* GetFormacion() const { return Formacion.Get(); }
+	FORCEINLINE void SetFormacion(class AFormationManager* _Formacion) { Formacion = _Formacion; }
+
+	// Cada cuantos cuadros se actualiza la nave (1, 2 o 4), lo decide UEnemySignificanceSubsystem.
+	// Con Tick propio es el intervalo de Tick; en formacion AFormationManager solo escribe su
+	// posicion en los cuadros que le tocan
+	void SetCuadrosActualizacion(int32 Cuadros, float IntervaloTick);
+	FORCEINLINE int32 GetCuadrosActualizacion() const { return CuadrosActualizacion; }
+
+	// Instancia creada de antemano o ya muerta: oculta, sin colision, sin Tick, sin timers ni
+	// disparos en curso y fuera de los subsistemas hasta que Despertar la pone en juego
+	void Dormir();
+	void Despertar(const FTransform& Transform);
+	FORCEINLINE bool EstaDormida() const { return bDormida; }
+
+	// Resta el dano a la resistencia y, al llegar a cero, llama a Destruirse. Si sobrevive en una
+	// formacion instanciada se dibuja con su propia malla durante TiempoParpadeo
+	virtual float TakeDamage(float DamageAmount, struct FDamageEvent const& DamageEvent, class AController* EventInstigator, AActor* DamageCauser) override;
+
+	// Avisa una vez por vida, al morir la nave. Se vacia despues de avisar: quien la vuelva a
+	// poner en juego se suscribe de nuevo
+	FOnNaveDestruida AlDestruirse;
+
+private:
+	// Alta y baja en el campo de balas, la significancia y el planificador de disparos
+	void RegistrarEnSubsistemas();
+	void DesregistrarDeSubsistemas();
+
+	// Nombre con el que la registro UShipRegistrySubsystem ("EnemigaCaza", ...)
+	FName Tipo;
+	bool bDormida = false;
+	int32 CuadrosActualizacion = 1;
+
+	// Vuelve a la instancia de la formacion despues del golpe
+	void TerminarParpadeo();
+	FTimerHandle TimerParpadeo;
+	static constexpr float TiempoParpadeo = 0.2f;
 
 
 protected:
 	//virtual void Mover() = 0;
 	FString GetShipName();
-	void Mover(float DeltaTime) PURE_VIRTUAL(ANaveEnemiga::Mover, );
-	void Disparar() PURE_VIRTUAL(ANaveEnemiga::Disparar, );
-	void Destruirse() PURE_VIRTUAL(ANaveEnemiga::Destruirse, );
-	void Escapar() PURE_VIRTUAL(ANaveEnemiga::Escapar, );
+	virtual void Mover(float DeltaTime) PURE_VIRTUAL(ANaveEnemiga::Mover, );
+	virtual void Disparar() PURE_VIRTUAL(ANaveEnemiga::Disparar, );
+	// Muerte de la nave: avisa AlDestruirse y la devuelve dormida al UShipRegistrySubsystem para
+	// la proxima oleada. Las clases hijas sueltan lo suyo y llaman a Super
+	virtual void Destruirse();
+
+	// Deja la nave como recien creada al despertarla; las clases hijas reinician lo suyo
+	// (suscripciones, estrategia) y llaman a Super
+	virtual void Reiniciar();
+
+	// Al dormirse, por muerte, por vencer como refuerzo o al precalentarse: las clases hijas
+	// sueltan aqui lo que Reiniciar vuelve a tomar (suscripciones)
+	virtual void AlDormir() {}
+	virtual void Escapar() PURE_VIRTUAL(ANaveEnemiga::Escapar, );
 
 public: 
 	
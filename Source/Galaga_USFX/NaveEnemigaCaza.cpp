@@ -2,14 +2,16 @@
 
 
 #include "NaveEnemigaCaza.h"
-#include "FacadeTipoDisparo.h"
+#include "EnemyKernel.h"
 #include "NaveEnemigaEspia.h"
 #include "Kismet/GameplayStatics.h"
+#include "EngineUtils.h"
 #include "Foton.h"
 #include "Laser.h"
 #include "Engine/CollisionProfile.h"
 #include "Galaga_USFXProjectile.h"
 #include "Galaga_USFXPawn.h"
+#include "ReinforcementSubsystem.h"
 
 
 
@@ -19,6 +21,8 @@ ANaveEnemigaCaza::ANaveEnemigaCaza()
     mallaNaveEnemiga->SetStaticMesh(ShipMesh.Object);
 
     FireRate= 0;
+    IntervaloDisparo = 2.0f;
+    NombreArquetipo = TEXT("Laser");
 
     ////velocidad = 0.8;
     //bCanFire = true;
@@ -27,7 +31,7 @@ ANaveEnemigaCaza::ANaveEnemigaCaza()
     //DireccionMovimientoHorizontal = 1;
     //LimiteInferiorX = -1000;
     //FacadeDisparo = nullptr;
-    //Espia = nullptr;
+    Espia = nullptr;
     //Caza = nullptr;
     ////ShipFactory = nullptr;
   
@@ -46,12 +50,7 @@ void ANaveEnemigaCaza::Tick(float DeltaTime)
 {
     Super::Tick(DeltaTime);
     Mover(DeltaTime);
-    FireRate += DeltaTime;
-    if (FireRate > 2.0f)
-	{
-		Disparar();
-		FireRate = 0;
-	}
+    ActualizarDisparo(DeltaTime);
 
 }
 
@@ -59,42 +58,62 @@ void ANaveEnemigaCaza::BeginPlay()
 {
     Super::BeginPlay();
 
-    FacadeDisparo = GetWorld()->SpawnActor<AFacadeTipoDisparo>(AFacadeTipoDisparo::StaticClass());
+    // Las precalentadas se suscriben al despertar
+    if (!EstaDormida())
+    {
+        Suscribirse();
+    }
+}
 
+void ANaveEnemigaCaza::Suscribirse()
+{
+    // Nunca dos veces: la suscripcion anterior se suelta antes de buscar el espia
+    Desuscribirse();
 
-   
-     Espia = Cast<ANaveEnemigaEspia>(UGameplayStatics::GetActorOfClass(GetWorld(), ANaveEnemigaEspia::StaticClass()));
+    // El espia en juego; los precalentados del registro estan dormidos y no avisan
+    Espia = nullptr;
+    for (TActorIterator<ANaveEnemigaEspia> It(GetWorld()); It; ++It)
+    {
+        if (!It->EstaDormida())
+        {
+            Espia = *It;
+            break;
+        }
+    }
         if (Espia)
         {   
-          
             Espia->SubscribirNave(this);
-            GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, TEXT("NaveEnemigaCaza: Suscribiendo a NaveEnemigaEspia"));
         }
-   
-
 }
-   
 
-void ANaveEnemigaCaza::Mover(float DeltaTime)
+void ANaveEnemigaCaza::Desuscribirse()
+{
+    if (Espia)
+    {
+        Espia->DesubscribirNave(this);
+        Espia = nullptr;
+    }
+}
 
+void ANaveEnemigaCaza::AlDormir()
 {
-    float LimiteDerechoF = 1000.0f;
-    float LimiteIzquierdoF = -1000.0f;
-     //float velocidad = 0.8;
+    // Dormida no recibe avisos del espia, llegue por Destruirse o vuelva del refuerzo
+    Desuscribirse();
+    Super::AlDormir();
+}
 
-    FVector NuevaPosicionF = FVector(GetActorLocation().X , GetActorLocation().Y - velocidad* 100*DeltaTime, GetActorLocation().Z); //calcula la nueva posicion de la nave
+void ANaveEnemigaCaza::Reiniciar()
+{
+    Super::Reiniciar();
+    Suscribirse();
+}
+   
 
-    // Verifica los lmites de la posicin en X
-    if (NuevaPosicionF.Y < LimiteIzquierdoF)
-    {
-        NuevaPosicionF.Y = LimiteDerechoF;
-    }
-    else if (NuevaPosicionF.Y > LimiteDerechoF)
-    {
-        NuevaPosicionF.Y = LimiteIzquierdoF;
-    }
+void ANaveEnemigaCaza::Mover(float DeltaTime)
 
-    SetActorLocation(NuevaPosicionF); //establece la nueva p
+{
+    // El mismo paso que usa la formacion (FEnemyKernel), con la nave fuera de ella
+    SetActorLocation(FEnemyKernel::MoverRecto(GetActorLocation(), GetVelocidad() * 100, DeltaTime, GetlimiteY()));
 
     
 
@@ -111,14 +130,10 @@ void ANaveEnemigaCaza::Disparar()
     FVector _SpawnDirection = FVector(-2.0f, 0.0f, 0.0f);
     FVector SpawnDirection = _SpawnDirection;
 
-    FacadeDisparo->Launch("Laser",SpawnLocation,SpawnDirection);
+    LanzarDisparo(SpawnLocation, SpawnDirection);
 
   
 
-}
-
-void ANaveEnemigaCaza::Destruirse()
-{
 }
 
 void ANaveEnemigaCaza::Escapar()
@@ -138,8 +153,12 @@ void ANaveEnemigaCaza::Escapar()
 
 void ANaveEnemigaCaza::OnNotify()
 {
-    GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Green, TEXT("NaveEnemigaCaza: Notificacion Recibida"));
-  
+    // Las precalentadas del registro todavia no estan en juego
+    if (EstaDormida())
+    {
+        return;
+    }
+
         // Llama al mtodo SpawnearNaves de la AShipFactory
     SpawnNaveEnemigaCaza();
     
@@ -147,16 +166,11 @@ void ANaveEnemigaCaza::OnNotify()
 }
 void ANaveEnemigaCaza::SpawnNaveEnemigaCaza()
 {
-   for (int i = 0; i < 2; ++i)
+    // Se corre dentro del aviso del espia: los refuerzos los crea el director despues, con
+    // topes y desde las naves dormidas del registro, sin tocar la lista que se esta recorriendo
+    if (UReinforcementSubsystem* Refuerzos = GetWorld()->GetSubsystem<UReinforcementSubsystem>())
     {
-        FVector SpawnLocationextra = GetActorLocation() + FVector(-800.0f + i * 200, 0.0f, 0.0f); // Ajusta la posicin segn tu lgica
-      
-        Caza= GetWorld()->SpawnActor<ANaveEnemigaCaza>(ANaveEnemigaCaza::StaticClass(), SpawnLocationextra, FRotator::ZeroRotator);
-        // Destruye la nave despus de 5 segundos
-        if (Caza)
-        {
-            Caza->SetLifeSpan(5.0f);
-        }
+        Refuerzos->Pedir(GetActorLocation());
     }
 }
 void ANaveEnemigaCaza::EndPlay(const EEndPlayReason::Type EndPlayReason)
@@ -164,10 +178,7 @@ void ANaveEnemigaCaza::EndPlay(const EEndPlayReason::Type EndPlayReason)
     Super::EndPlay(EndPlayReason);
 
     // Desuscribe la nave cuando se destruye
-    if (Espia)
-    {
-        Espia->DesubscribirNave(this);
-    }
+    Desuscribirse();
 }
 
 
@@ -17,7 +17,6 @@ class GALAGA_USFX_API ANaveEnemigaCaza : public ANaveEnemiga, public ISubscripto
 private:
 	int cantidadBombas;
 	//int LimiteInferiorX;
-	class AFacadeTipoDisparo* FacadeDisparo;
 	//float TiempoCambio;
 
 public:
@@ -34,8 +33,13 @@ public:
 protected:
 	virtual void Mover(float DeltaTime) ;
 	virtual void Disparar();
-	virtual void Destruirse();
 	virtual void Escapar();
+	virtual void Reiniciar() override;
+	virtual void AlDormir() override;
+
+	// Se suscribe a los avisos de la NaveEnemigaEspia despierta del nivel
+	void Suscribirse();
+	void Desuscribirse();
 
 
 public:
@@ -2,7 +2,7 @@
 
 
 #include "NaveEnemigaCazaAlfa.h"
-#include "FacadeTipoDisparo.h"
+#include "EnemyKernel.h"
 
 ANaveEnemigaCazaAlfa::ANaveEnemigaCazaAlfa()
 {
@@ -10,6 +10,8 @@ ANaveEnemigaCazaAlfa::ANaveEnemigaCazaAlfa()
 
 	mallaNaveEnemiga->SetStaticMesh(ShipMesh.Object);
 	FireRate = 0;
+	NombreArquetipo = TEXT("Basico");
+	IntervaloDisparo = 1.0f;
 
 
 }
@@ -19,44 +21,18 @@ void ANaveEnemigaCazaAlfa::Tick(float DeltaTime)
     Super::Tick(DeltaTime);
 
 	Mover(DeltaTime);
-
-	FireRate += DeltaTime;
-	if (FireRate > 1.0f)
-	{
-		Disparar();
-		FireRate = 0;
-	}
+	ActualizarDisparo(DeltaTime);
 }
 
 void ANaveEnemigaCazaAlfa::BeginPlay()
 {
 	Super::BeginPlay();
-	FacadeDisparo = GetWorld()->SpawnActor<AFacadeTipoDisparo>(AFacadeTipoDisparo::StaticClass());
 }
 
 void ANaveEnemigaCazaAlfa::Mover(float DeltaTime)
 {
-
-    // Define una velocidad de rotacin
-    float VelocidadRotacion = 10.0f; // Puedes ajustar este valor segn la velocidad deseada
-
-    // Obtiene el tiempo transcurrido desde el inicio del juego y lo escala para que avance ms lentamente
-    float TiempoTranscurrido = GetWorld()->TimeSeconds * 0.1f; // Escala de tiempo para que vaya ms lento (0.1f)
-
-    // Calcula el ngulo de rotacin basado en el tiempo
-    float Angulo = FMath::Fmod(TiempoTranscurrido, 6.0f) * VelocidadRotacion; // El ngulo cambia cada 6 segundos
-
-    // Calcula las coordenadas X e Y para el movimiento circular
-    float Radio = 10.0f; // Radio del crculo
-    float X = FMath::Cos(Angulo) * Radio; // Coordenada X del crculo
-    float Y = FMath::Sin(Angulo) * Radio; // Coordenada Y del crculo
-
-    // Calcula la nueva posicin sumando las coordenadas X e Y a la posicin del punto alrededor del cual quieres que la nave se mueva
-    FVector PuntoCentral = GetActorLocation(); // Cambia esto a la posicin inicial de la nave
-    FVector NuevaPosicion = PuntoCentral + FVector(X, Y, 0.0f);
-
-    // Establece la nueva posicin del actor
-    SetActorLocation(NuevaPosicion);
+    // Circulo alrededor de la posicion actual; el calculo es el de FEnemyKernel
+    SetActorLocation(GetActorLocation() + FEnemyKernel::OffsetCircular(GetWorld()->TimeSeconds, DeltaTime));
 
 }
 
@@ -67,11 +43,12 @@ void ANaveEnemigaCazaAlfa::Disparar()
     FVector _SpawnDirection = FVector(-1.0f, 0.0f, 0.0f);
     FVector SpawnDirection = _SpawnDirection;
 
-    FacadeDisparo->Launch("Basico", SpawnLocation, SpawnDirection);
+    LanzarDisparo(SpawnLocation, SpawnDirection);
 }
 
 void ANaveEnemigaCazaAlfa::Destruirse()
 {
+	Super::Destruirse();
 }
 
 void ANaveEnemigaCazaAlfa::Escapar()
@@ -17,7 +17,6 @@ class GALAGA_USFX_API ANaveEnemigaCazaAlfa : public ANaveEnemigaCaza
 private:
 	int cantidadlaser;
 
-	class AFacadeTipoDisparo* FacadeDisparo;
 public:
 
 	ANaveEnemigaCazaAlfa();
@@ -19,6 +19,7 @@ ANaveEnemigaCazaBeta::ANaveEnemigaCazaBeta()
 	//CazaMesh->SetRelativeScale3D(FVector(1.5f, 1.5f, 1.5f));
 
 	armasInteligentes = 0;
+	Estrategia = nullptr;
 
 }
 
@@ -27,7 +28,7 @@ void ANaveEnemigaCazaBeta::Mover(float DeltaTime)
 {
 	Super::Mover(DeltaTime);
 	if (Estrategia) {
-		Estrategia->Movement(this);
+		Estrategia->Movement(this, DeltaTime);
 		//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, TEXT("Estrategia Activada"));
 	}
 
@@ -55,12 +56,21 @@ void ANaveEnemigaCazaBeta::Disparar()
 
 void ANaveEnemigaCazaBeta::Destruirse()
 {
+	Super::Destruirse();
 }
 
 void ANaveEnemigaCazaBeta::Escapar()
 {
 }
 
+void ANaveEnemigaCazaBeta::Reiniciar()
+{
+	Super::Reiniciar();
+
+	// La nave reciclada vuelve al movimiento base hasta que le den otra estrategia
+	Estrategia = nullptr;
+}
+
 void ANaveEnemigaCazaBeta::BeginPlay()
 {
 	Super::BeginPlay();
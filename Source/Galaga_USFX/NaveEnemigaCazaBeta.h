@@ -31,6 +31,7 @@ protected:
 	virtual void Disparar() override;
 	virtual void Destruirse() override;
 	virtual void Escapar() override;
+	virtual void Reiniciar() override;
 
 	virtual void BeginPlay() override;
 	virtual void Tick(float DeltaTime) override;
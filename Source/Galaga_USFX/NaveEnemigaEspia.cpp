@@ -2,6 +2,7 @@
 
 
 #include "NaveEnemigaEspia.h"
+#include "EnemyKernel.h"
 #include "Laser.h"
 #include "Bomba.h"
 #include "Foton.h"
@@ -10,13 +11,14 @@
 #include "SubscriptorInterface.h"
 #include "Galaga_USFXPawn.h"
 
-#include "FacadeTipoDisparo.h"
 
 
 ANaveEnemigaEspia::ANaveEnemigaEspia()
 {
     static ConstructorHelpers::FObjectFinder<UStaticMesh> ShipMesh(TEXT("StaticMesh'/Game/TwinStick/Meshes/TwinStickUFO_2.TwinStickUFO_2'"));
     mallaNaveEnemiga->SetStaticMesh(ShipMesh.Object);
+    NombreArquetipo = TEXT("Foton");
+    IntervaloDisparo = 3.0f;
 
     
 
@@ -26,12 +28,7 @@ void ANaveEnemigaEspia::Tick(float DeltaTime)
 {
     Super::Tick(DeltaTime);
     Mover(DeltaTime);
-    FireRate += DeltaTime;
-    if (FireRate > 3.0f)
-    {
-        Disparar();
-        FireRate = 0;
-    }
+    ActualizarDisparo(DeltaTime);
 
    // UpdateNave();
 
@@ -40,7 +37,6 @@ void ANaveEnemigaEspia::Tick(float DeltaTime)
 void ANaveEnemigaEspia::BeginPlay()
 {
     Super::BeginPlay();
-	DisparoFacade = GetWorld()->SpawnActor<AFacadeTipoDisparo>(AFacadeTipoDisparo::StaticClass());
     AGalaga_USFXPawn* PlayerPawn = Cast<AGalaga_USFXPawn>(GetWorld()->GetFirstPlayerController()->GetPawn());
     if (PlayerPawn)
     {
@@ -55,7 +51,7 @@ void ANaveEnemigaEspia::BeginPlay()
 void ANaveEnemigaEspia::SubscribirNave(ISubscriptorInterface* navesubscriptora)
 {
     if (navesubscriptora) {
-    NavesSubscriptoras.Add(navesubscriptora);
+    NavesSubscriptoras.AddUnique(navesubscriptora);
     }
     ANaveEnemigaCaza* NaveCaza = Cast<ANaveEnemigaCaza>(navesubscriptora);
     if (NaveCaza)
@@ -76,8 +72,14 @@ void ANaveEnemigaEspia::DesubscribirNave(ISubscriptorInterface* navesubscriptora
 
 void ANaveEnemigaEspia::NotificarNaves()
 {
+    if (EstaDormida())
+    {
+        return;
+    }
 
-   for (ISubscriptorInterface* nave : NavesSubscriptoras)
+   // Sobre una copia: una nave avisada puede suscribirse o desuscribirse mientras se recorre
+   const TArray<ISubscriptorInterface*> Avisadas = NavesSubscriptoras;
+   for (ISubscriptorInterface* nave : Avisadas)
     {
        if (nave) {
            nave->OnNotify();
@@ -98,26 +100,8 @@ void ANaveEnemigaEspia::NotificarNaves()
 
 void ANaveEnemigaEspia::Mover(float DeltaTime)
 {
-
-
-
-    float LimiteDerecho = 1000.0f;
-    float LimiteIzquierdo = -1000.0f;
-    //    float velocidad = 0.8;
-
-    FVector NuevaPosicion = FVector(GetActorLocation().X, GetActorLocation().Y - velocidad * 100 * DeltaTime, GetActorLocation().Z); //calcula la nueva posicion de la nave
-
-    // Verifica los lmites de la posicin en X
-    if (NuevaPosicion.Y < LimiteIzquierdo)
-    {
-        NuevaPosicion.Y = LimiteDerecho;
-    }
-    else if (NuevaPosicion.Y > LimiteDerecho)
-    {
-        NuevaPosicion.Y = LimiteIzquierdo;
-    }
-
-    SetActorLocation(NuevaPosicion); //establece la nueva p
+    // El mismo paso que usa la formacion (FEnemyKernel), con la nave fuera de ella
+    SetActorLocation(FEnemyKernel::MoverRecto(GetActorLocation(), GetVelocidad() * 100, DeltaTime, GetlimiteY()));
 
 
     
@@ -158,13 +142,14 @@ void ANaveEnemigaEspia::Disparar()
       FVector SpawnDirection = _SpawnDirection;
     //    NewProjectile->FireInDirection(SpawnDirection);
     //}
-      DisparoFacade->Launch("Foton", SpawnLocation, _SpawnDirection);
+      LanzarDisparo(SpawnLocation, _SpawnDirection);
 
 
 }
 
 void ANaveEnemigaEspia::Destruirse()
 {
+    Super::Destruirse();
 }
 
 void ANaveEnemigaEspia::Escapar()
@@ -22,7 +22,6 @@ public:
 	FORCEINLINE int GetCampoVision() const { return campoVision; }
 	FORCEINLINE void SetCampoVision(int _campoVision) { campoVision = _campoVision; }
 	//TSubclassOf<class ABomba> NewProjectileBomba;
-	class AFacadeTipoDisparo* DisparoFacade;
 protected:
 	
 	virtual void Mover(float DeltaTime);
@@ -21,6 +21,7 @@ void ANaveEnemigaEspiaAlfa::Disparar()
 
 void ANaveEnemigaEspiaAlfa::Destruirse()
 {
+    Super::Destruirse();
 }
 
 void ANaveEnemigaEspiaAlfa::Escapar()
@@ -22,6 +22,7 @@ void ANaveEnemigaEspiaBeta::Disparar()
 
 void ANaveEnemigaEspiaBeta::Destruirse()
 {
+    Super::Destruirse();
 }
 
 void ANaveEnemigaEspiaBeta::Escapar()
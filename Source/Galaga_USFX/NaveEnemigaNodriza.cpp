@@ -2,12 +2,16 @@
 
 
 #include "NaveEnemigaNodriza.h"
-#include "FacadeTipoDisparo.h"
+#include "EnemyKernel.h"
+#include "BulletPatternSubsystem.h"
 
 ANaveEnemigaNodriza::ANaveEnemigaNodriza()
 {
     static ConstructorHelpers::FObjectFinder<UStaticMesh> ShipMesh(TEXT("StaticMesh'/Game/StarterContent/Shapes/Shape_WideCapsule.Shape_WideCapsule'"));
     mallaNaveEnemiga->SetStaticMesh(ShipMesh.Object);
+    NombreArquetipo = TEXT("Bomba");
+    PatronDisparo = TEXT("Nodriza");
+    IntervaloDisparo = 1.0f;
 
 }
 
@@ -15,44 +19,21 @@ void ANaveEnemigaNodriza::Tick(float DeltaTime)
 {
     Super::Tick(DeltaTime);
     Mover(DeltaTime);
-    tiempoDisparo += DeltaTime;
-
-    if (tiempoDisparo >= 1.0f)
-	{
-		Disparar();
-		tiempoDisparo = 0.0f;
-	}
+    ActualizarDisparo(DeltaTime);
 }
 
 void ANaveEnemigaNodriza::BeginPlay()
 {
     Super::BeginPlay();
 
-    Disparo = GetWorld()->SpawnActor<AFacadeTipoDisparo>(AFacadeTipoDisparo::StaticClass());
 }
 
 
 
 void ANaveEnemigaNodriza::Mover(float DeltaTime)
 {
-
-    float LimiteDerecho = 1000.0f;
-    float LimiteIzquierdo = -1000.0f;
-    //    float velocidad = 0.8;
-
-    FVector NuevaPosicion = FVector(GetActorLocation().X, GetActorLocation().Y - velocidad * 100 * DeltaTime, GetActorLocation().Z); //calcula la nueva posicion de la nave
-
-    // Verifica los lmites de la posicin en X
-    if (NuevaPosicion.Y < LimiteIzquierdo)
-    {
-        NuevaPosicion.Y = LimiteDerecho;
-    }
-    else if (NuevaPosicion.Y > LimiteDerecho)
-    {
-        NuevaPosicion.Y = LimiteIzquierdo;
-    }
-
-    SetActorLocation(NuevaPosicion); //establece la nueva p
+    // El mismo paso que usa la formacion (FEnemyKernel), con la nave fuera de ella
+    SetActorLocation(FEnemyKernel::MoverRecto(GetActorLocation(), GetVelocidad() * 100, DeltaTime, GetlimiteY()));
 
 
 
@@ -91,16 +72,25 @@ void ANaveEnemigaNodriza::Mover(float DeltaTime)
 
 void ANaveEnemigaNodriza::Disparar()
 {
+    // El patron corre solo en el UBulletPatternSubsystem; aqui solo se relanza si termino
+    UBulletPatternSubsystem* Patrones = GetWorld()->GetSubsystem<UBulletPatternSubsystem>();
+    if (Patrones && (Patrones->TieneEmisor(this)
+        || Patrones->Iniciar(PatronDisparo, this, GetActorForwardVector() * 100.0f, 180.0f, ArquetipoDisparo, EBulletOwner::Enemigo)))
+    {
+        return;
+    }
 
+    // Sin patron, la bomba de siempre
     FVector SpawnLocation = GetActorLocation() + GetActorForwardVector() * +100 + FVector(0.0f, 0.0f, 0.0f);//distancia de disparo
     FVector _SpawnDirection = FVector(-1.0f, 0.0f, 0.0f);
     FVector SpawnDirection = _SpawnDirection;
 
-    Disparo->Launch("Bomba", SpawnLocation, SpawnDirection);
+    LanzarDisparo(SpawnLocation, SpawnDirection);
 }
 
 void ANaveEnemigaNodriza::Destruirse()
 {
+    Super::Destruirse();
 }
 
 void ANaveEnemigaNodriza::Escapar()
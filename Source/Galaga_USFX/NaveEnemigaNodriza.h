@@ -20,6 +20,10 @@ public:
 	FORCEINLINE int GetNivelSpawn() const { return nivelSpawn; }
 	FORCEINLINE void SetNivelSpawn(int _nivelSpawn) { nivelSpawn = _nivelSpawn; }
 
+	// Patron de Content/Data/BulletPatterns.txt que corre mientras la nodriza vive
+	UPROPERTY(EditAnywhere, Category = "Disparo")
+	FName PatronDisparo;
+
 protected:
 	virtual void Mover(float DeltaTime);
 	virtual void Disparar();
@@ -30,6 +34,5 @@ public:
 	virtual void Tick(float DeltaTime) override;
 	virtual void BeginPlay() override;
 
-	class AFacadeTipoDisparo* Disparo;
 	
 };
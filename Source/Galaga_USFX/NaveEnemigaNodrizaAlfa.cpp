@@ -25,6 +25,7 @@ void ANaveEnemigaNodrizaAlfa::Disparar()
 
 void ANaveEnemigaNodrizaAlfa::Destruirse()
 {
+    Super::Destruirse();
 }
 
 void ANaveEnemigaNodrizaAlfa::Escapar()
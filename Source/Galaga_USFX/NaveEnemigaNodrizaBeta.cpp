@@ -20,6 +20,7 @@ void ANaveEnemigaNodrizaBeta::Disparar()
 
 void ANaveEnemigaNodrizaBeta::Destruirse()
 {
+    Super::Destruirse();
 }
 
 void ANaveEnemigaNodrizaBeta::Escapar()
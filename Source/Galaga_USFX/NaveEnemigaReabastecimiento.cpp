@@ -2,6 +2,7 @@
 
 
 #include "NaveEnemigaReabastecimiento.h"
+#include "EnemyKernel.h"
 
 ANaveEnemigaReabastecimiento::ANaveEnemigaReabastecimiento()
 {
@@ -19,24 +20,8 @@ void ANaveEnemigaReabastecimiento::Tick(float DeltaTime)
 
 void ANaveEnemigaReabastecimiento::Mover(float DeltaTime)
 {
-    float LimiteDerecho = 1000.0f;
-    float LimiteIzquierdo = -1000.0f;
-    //    float velocidad = 0.8;
-
-    FVector NuevaPosicion = FVector(GetActorLocation().X, GetActorLocation().Y - velocidad * 100 * DeltaTime, GetActorLocation().Z); //calcula la nueva posicion de la nave
-
-    // Verifica los lmites de la posicin en X
-    if (NuevaPosicion.Y < LimiteIzquierdo)
-    {
-        NuevaPosicion.Y = LimiteDerecho;
-    }
-    else if (NuevaPosicion.Y > LimiteDerecho)
-    {
-        NuevaPosicion.Y = LimiteIzquierdo;
-    }
-
-    SetActorLocation(NuevaPosicion); //establece la nueva p
-
+    // El mismo paso que usa la formacion (FEnemyKernel), con la nave fuera de ella
+    SetActorLocation(FEnemyKernel::MoverRecto(GetActorLocation(), GetVelocidad() * 100, DeltaTime, GetlimiteY()));
 }
 
 
@@ -85,6 +70,7 @@ void ANaveEnemigaReabastecimiento::Disparar()
 
 void ANaveEnemigaReabastecimiento::Destruirse()
 {
+    Super::Destruirse();
 }
 
 void ANaveEnemigaReabastecimiento::Escapar()
@@ -20,6 +20,7 @@ void ANaveEnemigaReabastecimientoAlfa::Disparar()
 
 void ANaveEnemigaReabastecimientoAlfa::Destruirse()
 {
+    Super::Destruirse();
 }
 
 void ANaveEnemigaReabastecimientoAlfa::Escapar()
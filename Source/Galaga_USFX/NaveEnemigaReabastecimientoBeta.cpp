@@ -20,6 +20,7 @@ void ANaveEnemigaReabastecimientoBeta::Disparar()
 
 void ANaveEnemigaReabastecimientoBeta::Destruirse()
 {
+    Super::Destruirse();
 }
 
 void ANaveEnemigaReabastecimientoBeta::Escapar()
@@ -2,8 +2,8 @@
 
 
 #include "NaveEnemigaTransporte.h"
+#include "EnemyKernel.h"
 #include "Foton.h"
-#include "FacadeTipoDisparo.h"
 
 ANaveEnemigaTransporte::ANaveEnemigaTransporte()
 {
@@ -12,6 +12,8 @@ ANaveEnemigaTransporte::ANaveEnemigaTransporte()
 
 	//DisparoFacade = CreateDefaultSubobject<AFacadeTipoDisparo>(TEXT("DisparoFacade"));
 	NewProjectileFoton = nullptr;
+	NombreArquetipo = TEXT("Misil");
+	IntervaloDisparo = 1.0f;
 
 }
 
@@ -19,42 +21,21 @@ void ANaveEnemigaTransporte::Tick(float DeltaTime)
 {
     Super::Tick(DeltaTime);
     Mover(DeltaTime);
-	FireRate += DeltaTime;
-	if (FireRate > 1.0f)
-	{
-		Disparar();
-		FireRate = 0;
-	}
+	ActualizarDisparo(DeltaTime);
 }
 
 
 void ANaveEnemigaTransporte::BeginPlay()
 {
 	Super::BeginPlay();
-	DisparoFacade = GetWorld()->SpawnActor<AFacadeTipoDisparo>(AFacadeTipoDisparo::StaticClass());
 	//DisparoFacade->AsignarDisparo("Foton");
 	//DisparoFacade->Launch(GetActorLocation() + GetActorForwardVector() * +100 + FVector(0.0f, 0.0f, 0.0f));
 }
 
 void ANaveEnemigaTransporte::Mover(float DeltaTime)
 {
-	float LimiteDerecho = 1000.0f;
-	float LimiteIzquierdo = -1000.0f;
-	//    float velocidad = 0.8;
-
-	FVector NuevaPosicion = FVector(GetActorLocation().X, GetActorLocation().Y - velocidad * 100 * DeltaTime, GetActorLocation().Z); //calcula la nueva posicion de la nave
-
-	// Verifica los lmites de la posicin en X
-	if (NuevaPosicion.Y < LimiteIzquierdo)
-	{
-		NuevaPosicion.Y = LimiteDerecho;
-	}
-	else if (NuevaPosicion.Y > LimiteDerecho)
-	{
-		NuevaPosicion.Y = LimiteIzquierdo;
-	}
-
-	SetActorLocation(NuevaPosicion); //establece la nueva p
+	// El mismo paso que usa la formacion (FEnemyKernel), con la nave fuera de ella
+	SetActorLocation(FEnemyKernel::MoverRecto(GetActorLocation(), GetVelocidad() * 100, DeltaTime, GetlimiteY()));
 
 
 	
@@ -149,11 +130,12 @@ void ANaveEnemigaTransporte::Disparar()
 	FVector SpawnDirection = _SpawnDirection;
 	//DisparoFacade->AsignarDisparo("Foton");
 	//DisparoFacade->Launch(SpawnDirection);
-	DisparoFacade->Launch("Misile", SpawnLocation, SpawnDirection);
+	LanzarDisparo(SpawnLocation, SpawnDirection);
 }
 
 void ANaveEnemigaTransporte::Destruirse()
 {
+	Super::Destruirse();
 }
 
 void ANaveEnemigaTransporte::Escapar()
@@ -30,7 +30,6 @@ public:
 	TSubclassOf<class AFoton> NewProjectileFoton;
 
 private:
-	class AFacadeTipoDisparo* DisparoFacade;
 	
 
 protected:
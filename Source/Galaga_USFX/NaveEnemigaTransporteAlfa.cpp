@@ -20,6 +20,7 @@ void ANaveEnemigaTransporteAlfa::Disparar()
 
 void ANaveEnemigaTransporteAlfa::Destruirse()
 {
+	Super::Destruirse();
 }
 
 void ANaveEnemigaTransporteAlfa::Escapar()
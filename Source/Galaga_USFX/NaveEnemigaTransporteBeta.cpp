@@ -20,6 +20,7 @@ void ANaveEnemigaTransporteBeta::Disparar()
 
 void ANaveEnemigaTransporteBeta::Destruirse()
 {
+	Super::Destruirse();
 }
 
 void ANaveEnemigaTransporteBeta::Escapar()
@@ -26,15 +26,15 @@ void AParabolicStrategy::Tick(float DeltaTime)
 
 }
 
-void AParabolicStrategy::Movement(ANaveEnemiga* enemy)
+void AParabolicStrategy::Movement(ANaveEnemiga* enemy, float DeltaTime)
 {
 	if (enemy) {
 		// Incrementa el tiempo transcurrido
-		TimeElapsed += enemy-> GetWorld()->DeltaTimeSeconds;
+		TimeElapsed += DeltaTime;
 
 		// Calcula la nueva posicin de la nave enemiga
 		FVector NewLocation = enemy->GetActorLocation();
-		NewLocation.X -= 100.0f *enemy-> GetWorld()->DeltaTimeSeconds;
+		NewLocation.X -= 100.0f * DeltaTime;
 		NewLocation.Y = 100.0f * TimeElapsed - 0.5f * 100.0f * TimeElapsed * TimeElapsed;
 		//NewLocation.Z = 100.0f * TimeElapsed - 0.5f * 100.0f * TimeElapsed * TimeElapsed;
 
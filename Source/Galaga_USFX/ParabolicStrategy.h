@@ -24,7 +24,7 @@ public:
 	virtual void Tick(float DeltaTime) override;
 
 	protected:
-		virtual void Movement(class ANaveEnemiga* enemy) override;
+		virtual void Movement(class ANaveEnemiga* enemy, float DeltaTime) override;
 
 		private:
 			// El tiempo transcurrido desde que se inici el movimiento parablico
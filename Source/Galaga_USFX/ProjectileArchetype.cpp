@@ -0,0 +1,198 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ProjectileArchetype.h"
+#include "Galaga_USFX.h"
+#include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "Components/StaticMeshComponent.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/Csv/CsvParser.h"
+
+bool UProjectileArchetypeSubsystem::LeerArchivoArquetipos(FString& OutTexto, FString& OutRuta)
+{
+	OutRuta = FPaths::ProjectContentDir() / GetDefault<UProjectileArchetypeSubsystem>()->ArchivoArquetipos;
+	return FFileHelper::LoadFileToString(OutTexto, *OutRuta);
+}
+
+bool UProjectileArchetypeSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World != nullptr && World->IsGameWorld();
+}
+
+void UProjectileArchetypeSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// El archivo es la unica fuente: sin el no hay arquetipos y ningun arma dispara
+	FString Texto;
+	FString Ruta;
+	FString Error;
+	if (!LeerArchivoArquetipos(Texto, Ruta))
+	{
+		UE_LOG(LogGalaga_USFX, Error, TEXT("No se pudo leer el archivo de proyectiles %s"), *Ruta);
+	}
+	else if (Cargar(Texto, Error))
+	{
+		UE_LOG(LogGalaga_USFX, Log, TEXT("Arquetipos de proyectil: %d cargados de %s"), Arquetipos.Num(), *Ruta);
+	}
+	else
+	{
+		UE_LOG(LogGalaga_USFX, Error, TEXT("Error en %s, %s"), *Ruta, *Error);
+	}
+}
+
+void UProjectileArchetypeSubsystem::Deinitialize()
+{
+	Arquetipos.Empty();
+	Indices.Empty();
+
+	Super::Deinitialize();
+}
+
+FProjectileArchetypeHandle UProjectileArchetypeSubsystem::FindHandle(FName Nombre) const
+{
+	FProjectileArchetypeHandle Handle;
+	if (const int32* Indice = Indices.Find(Nombre))
+	{
+		Handle.Indice = *Indice;
+	}
+	else
+	{
+		UE_LOG(LogGalaga_USFX, Warning, TEXT("No existe el arquetipo de proyectil '%s'"), *Nombre.ToString());
+	}
+	return Handle;
+}
+
+FProjectileArchetypeHandle UProjectileArchetypeSubsystem::FindHandleDeClase(UClass* Clase) const
+{
+	FProjectileArchetypeHandle Handle;
+	Handle.Indice = Arquetipos.IndexOfByPredicate([Clase](const FProjectileArchetype& Arquetipo) { return Arquetipo.ClaseActor == Clase; });
+	return Handle;
+}
+
+FVector UProjectileArchetypeSubsystem::GetVelocidad(FProjectileArchetypeHandle Handle, const FVector& Direccion) const
+{
+	return Handle.IsValid() ? Direccion.GetSafeNormal() * Arquetipos[Handle.Indice].Velocidad : FVector::ZeroVector;
+}
+
+void UProjectileArchetypeSubsystem::Aplicar(FProjectileArchetypeHandle Handle, AActor* Proyectil) const
+{
+	if (!Handle.IsValid() || Proyectil == nullptr)
+	{
+		return;
+	}
+
+	const FProjectileArchetype& Arquetipo = Arquetipos[Handle.Indice];
+	if (UStaticMeshComponent* Malla = Cast<UStaticMeshComponent>(Proyectil->GetRootComponent()))
+	{
+		Malla->SetStaticMesh(Arquetipo.Malla);
+		Malla->SetRelativeScale3D(FVector(Arquetipo.Escala));
+		Malla->SetCollisionProfileName(Arquetipo.PerfilColision);
+	}
+
+	if (UProjectileMovementComponent* Movimiento = Proyectil->FindComponentByClass<UProjectileMovementComponent>())
+	{
+		Movimiento->InitialSpeed = Arquetipo.Velocidad;
+		Movimiento->MaxSpeed = Arquetipo.VelocidadMaxima;
+		// InitializeComponent ya lanzo el actor con la velocidad vacia del constructor
+		Movimiento->Velocity = Movimiento->Velocity.GetSafeNormal() * Arquetipo.Velocidad;
+	}
+
+	Proyectil->SetLifeSpan(Arquetipo.VidaUtil);
+}
+
+bool UProjectileArchetypeSubsystem::Cargar(const FString& Texto, FString& OutError)
+{
+	const FCsvParser Parser(Texto);
+	const FCsvParser::FRows& Filas = Parser.GetRows();
+	if (Filas.Num() < 2)
+	{
+		OutError = TEXT("el archivo no tiene arquetipos");
+		return false;
+	}
+
+	// Cada columna se escribe en el campo de la fila con su nombre, como al importar una DataTable
+	const UScriptStruct* Estructura = FProjectileArchetypeRow::StaticStruct();
+	TArray<FProperty*> Columnas;
+	for (int32 Columna = 1; Columna < Filas[0].Num(); ++Columna)
+	{
+		FProperty* Campo = Estructura->FindPropertyByName(Filas[0][Columna]);
+		if (Campo == nullptr)
+		{
+			OutError = FString::Printf(TEXT("la columna '%s' no es un campo de FProjectileArchetypeRow"), Filas[0][Columna]);
+			return false;
+		}
+		Columnas.Add(Campo);
+	}
+
+	for (int32 Linea = 1; Linea < Filas.Num(); ++Linea)
+	{
+		const TArray<const TCHAR*>& Valores = Filas[Linea];
+		if (Valores.Num() == 1 && FCString::Strlen(Valores[0]) == 0)
+		{
+			continue;
+		}
+		if (Valores.Num() != Columnas.Num() + 1)
+		{
+			OutError = FString::Printf(TEXT("linea %d: %d columnas, se esperaban %d"), Linea + 1, Valores.Num(), Columnas.Num() + 1);
+			return false;
+		}
+
+		FProjectileArchetypeRow Fila;
+		for (int32 Columna = 0; Columna < Columnas.Num(); ++Columna)
+		{
+			FProperty* Campo = Columnas[Columna];
+			if (Campo->ImportText(Valores[Columna + 1], Campo->ContainerPtrToValuePtr<void>(&Fila), PPF_None, nullptr) == nullptr)
+			{
+				OutError = FString::Printf(TEXT("linea %d: valor '%s' invalido para %s"), Linea + 1, Valores[Columna + 1], *Campo->GetName());
+				return false;
+			}
+		}
+		Agregar(Valores[0], Fila);
+	}
+	return true;
+}
+
+void UProjectileArchetypeSubsystem::Agregar(FName Nombre, const FProjectileArchetypeRow& Fila)
+{
+	// El campo de balas guarda el tipo en un uint8
+	if (Arquetipos.Num() > MAX_uint8)
+	{
+		UE_LOG(LogGalaga_USFX, Warning, TEXT("Demasiados arquetipos de proyectil, se ignora '%s'"), *Nombre.ToString());
+		return;
+	}
+
+	FProjectileArchetype Arquetipo;
+	Arquetipo.Nombre = Nombre;
+	Arquetipo.Velocidad = Fila.Velocidad;
+	Arquetipo.VelocidadMaxima = Fila.VelocidadMaxima;
+	Arquetipo.VidaUtil = Fila.VidaUtil;
+	Arquetipo.Escala = Fila.Escala;
+	Arquetipo.Dano = Fila.Dano;
+	Arquetipo.Teledirigido = Fila.Teledirigido;
+	Arquetipo.GiroMaximo = Fila.GiroMaximo;
+	Arquetipo.Aceleracion = Fila.Aceleracion;
+	Arquetipo.RadioExplosion = Fila.RadioExplosion;
+	Arquetipo.RadioProximidad = Fila.RadioProximidad;
+	Arquetipo.Espoleta = Fila.Espoleta;
+	Arquetipo.CancelaBalas = Fila.CancelaBalas;
+	Arquetipo.DuracionRayo = Fila.DuracionRayo;
+	Arquetipo.AnchoRayo = Fila.AnchoRayo;
+	Arquetipo.LargoRayo = Fila.LargoRayo;
+	Arquetipo.DanoPorSegundo = Fila.DanoPorSegundo;
+	Arquetipo.PerfilColision = Fila.PerfilColision;
+	Arquetipo.ClaseActor = Fila.ClaseActor.Get();
+
+	// La malla se carga aqui una sola vez, nunca al disparar
+	Arquetipo.Malla = Fila.Malla.LoadSynchronous();
+	if (Arquetipo.Malla)
+	{
+		Arquetipo.Radio = Arquetipo.Malla->GetBounds().SphereRadius * Arquetipo.Escala;
+	}
+
+	Indices.Add(Nombre, Arquetipos.Add(Arquetipo));
+}
@@ -0,0 +1,187 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataTable.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ProjectileArchetype.generated.h"
+
+class UStaticMesh;
+
+// Fila de Content/Data/ProjectileArchetypes.csv; reemplaza los valores fijos de los constructores de ALaser, AFoton, etc.
+// Las columnas del archivo tienen los nombres de estos campos
+USTRUCT(BlueprintType)
+struct FProjectileArchetypeRow : public FTableRowBase
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Proyectil")
+	float Velocidad = 2000.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Proyectil")
+	float VelocidadMaxima = 2000.0f;
+
+	// Segundos antes de que el proyectil desaparezca
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Proyectil")
+	float VidaUtil = 3.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Proyectil")
+	float Escala = 1.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Proyectil")
+	float Dano = 10.0f;
+
+	// Gira hacia el objetivo mas cercano del equipo contrario (solo en el campo de balas)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Proyectil")
+	bool Teledirigido = false;
+
+	// Grados por segundo que puede girar un proyectil teledirigido
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Proyectil")
+	float GiroMaximo = 0.0f;
+
+	// Cuanto sube la velocidad por segundo hasta VelocidadMaxima
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Proyectil")
+	float Aceleracion = 0.0f;
+
+	// Mayor que cero: el proyectil explota y hace dano con caida lineal hasta este radio
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Proyectil")
+	float RadioExplosion = 0.0f;
+
+	// Explota solo si un objetivo del equipo contrario queda a esta distancia (0: nunca)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Proyectil")
+	float RadioProximidad = 0.0f;
+
+	// Segundos hasta que explota por tiempo (0: al terminar VidaUtil)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Proyectil")
+	float Espoleta = 0.0f;
+
+	// Las balas del jugador de este arquetipo destruyen las balas enemigas que tocan (solo en el campo de balas)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Proyectil")
+	bool CancelaBalas = false;
+
+	// Mayor que cero: en lugar de una bala sale un rayo continuo que dura estos segundos
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Rayo")
+	float DuracionRayo = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Rayo")
+	float AnchoRayo = 20.0f;
+
+	// Alcance maximo del rayo si nada lo bloquea
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Rayo")
+	float LargoRayo = 2400.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Rayo")
+	float DanoPorSegundo = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Proyectil")
+	TSoftObjectPtr<UStaticMesh> Malla;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Proyectil")
+	FName PerfilColision = TEXT("Projectile");
+
+	// Actor que se usa cuando el campo de balas esta apagado
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Proyectil")
+	TSubclassOf<AActor> ClaseActor;
+};
+
+// Indice de un arquetipo dentro del UProjectileArchetypeSubsystem; se resuelve una vez y se usa en cada disparo
+USTRUCT(BlueprintType)
+struct FProjectileArchetypeHandle
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 Indice = INDEX_NONE;
+
+	FORCEINLINE bool IsValid() const { return Indice != INDEX_NONE; }
+};
+
+// Arquetipo ya resuelto: la malla cargada y el radio calculado, listos para usar sin buscar assets
+USTRUCT()
+struct FProjectileArchetype
+{
+	GENERATED_BODY()
+
+	FName Nombre;
+	float Velocidad = 0.0f;
+	float VelocidadMaxima = 0.0f;
+	float VidaUtil = 0.0f;
+	float Escala = 1.0f;
+	float Dano = 0.0f;
+	bool Teledirigido = false;
+	float GiroMaximo = 0.0f;
+	float Aceleracion = 0.0f;
+	float RadioExplosion = 0.0f;
+	float RadioProximidad = 0.0f;
+	float Espoleta = 0.0f;
+	bool CancelaBalas = false;
+	float DuracionRayo = 0.0f;
+	float AnchoRayo = 20.0f;
+	float LargoRayo = 2400.0f;
+	float DanoPorSegundo = 0.0f;
+	FName PerfilColision;
+
+	// Radio de colision: bounds de la malla por la escala
+	float Radio = 10.0f;
+
+	UPROPERTY()
+	UStaticMesh* Malla = nullptr;
+
+	UPROPERTY()
+	UClass* ClaseActor = nullptr;
+
+	FORCEINLINE bool EsRayo() const { return DuracionRayo > 0.0f; }
+};
+
+/**
+ * Registro de arquetipos de proyectil. Lee el CSV configurado en ArchivoArquetipos al crear el
+ * mundo. Es la unica fuente de esos valores: los actores y el pool los leen de aqui, y sin el
+ * archivo no hay proyectiles.
+ */
+UCLASS(config = Game)
+class GALAGA_USFX_API UProjectileArchetypeSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+public:
+	// Busca por nombre de fila ("Laser", "Foton", ...). Hacerlo en BeginPlay, no por disparo
+	FProjectileArchetypeHandle FindHandle(FName Nombre) const;
+
+	FORCEINLINE const FProjectileArchetype& Get(FProjectileArchetypeHandle Handle) const { return Arquetipos[Handle.Indice]; }
+	FORCEINLINE const FProjectileArchetype& Get(int32 Indice) const { return Arquetipos[Indice]; }
+	FORCEINLINE int32 Num() const { return Arquetipos.Num(); }
+
+	// El arquetipo cuyo ClaseActor es Clase; lo usa el pool de actores
+	FProjectileArchetypeHandle FindHandleDeClase(UClass* Clase) const;
+
+	// Velocidad de lanzamiento del arquetipo en la direccion dada
+	FVector GetVelocidad(FProjectileArchetypeHandle Handle, const FVector& Direccion) const;
+
+	// Pone en el actor la malla, escala, perfil de colision, velocidades y vida util del
+	// arquetipo. Los proyectiles lo llaman en su BeginPlay, sus constructores no traen valores
+	void Aplicar(FProjectileArchetypeHandle Handle, AActor* Proyectil) const;
+
+	// Lee el ArchivoArquetipos configurado; OutRuta queda con la ruta completa aunque falle
+	static bool LeerArchivoArquetipos(FString& OutTexto, FString& OutRuta);
+
+protected:
+	// Relativo a Content/
+	UPROPERTY(Config)
+	FString ArchivoArquetipos = TEXT("Data/ProjectileArchetypes.csv");
+
+private:
+	// Una fila por arquetipo; la primera fila son los nombres de los campos de FProjectileArchetypeRow
+	bool Cargar(const FString& Texto, FString& OutError);
+	void Agregar(FName Nombre, const FProjectileArchetypeRow& Fila);
+
+	UPROPERTY()
+	TArray<FProjectileArchetype> Arquetipos;
+
+	TMap<FName, int32> Indices;
+};
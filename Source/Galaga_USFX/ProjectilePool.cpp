@@ -0,0 +1,295 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ProjectilePool.h"
+#include "ProjectileArchetype.h"
+#include "Galaga_USFX.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "Laser.h"
+#include "Foton.h"
+#include "Bomba.h"
+#include "DisparoMisil.h"
+#include "DisparoBasic.h"
+#include "Galaga_USFXProjectile.h"
+
+static FAutoConsoleCommandWithWorld CmdPoolStats(
+	TEXT("Galaga.Pool.Stats"),
+	TEXT("Muestra los contadores (live, pooled, high-water) de los pools de proyectiles"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (UProjectilePoolSubsystem* Pool = World ? World->GetSubsystem<UProjectilePoolSubsystem>() : nullptr)
+		{
+			Pool->LogStats();
+		}
+	}));
+
+bool UProjectilePoolSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World != nullptr && World->IsGameWorld();
+}
+
+void UProjectilePoolSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Arquetipos = Collection.InitializeDependency<UProjectileArchetypeSubsystem>();
+}
+
+void UProjectilePoolSubsystem::Deinitialize()
+{
+	// Deja en el log los maximos de la partida para poder ajustar TamanoInicial
+	LogStats();
+	Pools.Empty();
+	Vivos.Empty();
+	Arquetipos = nullptr;
+
+	Super::Deinitialize();
+}
+
+void UProjectilePoolSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	Prewarm(ALaser::StaticClass(), TamanoInicial);
+	Prewarm(AFoton::StaticClass(), TamanoInicial);
+	Prewarm(ABomba::StaticClass(), TamanoInicial);
+	Prewarm(ADisparoMisil::StaticClass(), TamanoInicial);
+	Prewarm(ADisparoBasic::StaticClass(), TamanoInicial);
+	Prewarm(AGalaga_USFXProjectile::StaticClass(), TamanoInicial);
+}
+
+void UProjectilePoolSubsystem::Tick(float DeltaTime)
+{
+	const float Ahora = GetWorld()->GetTimeSeconds();
+
+	// Devuelve al pool los proyectiles que cumplieron su vida util
+	TArray<AActor*, TInlineAllocator<64>> Expirados;
+	for (const TPair<AActor*, float>& Vivo : Vivos)
+	{
+		if (Vivo.Value <= Ahora)
+		{
+			Expirados.Add(Vivo.Key);
+		}
+	}
+	for (AActor* Proyectil : Expirados)
+	{
+		Release(Proyectil);
+	}
+}
+
+ETickableTickType UProjectilePoolSubsystem::GetTickableTickType() const
+{
+	return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UProjectilePoolSubsystem::IsTickable() const
+{
+	return Vivos.Num() > 0;
+}
+
+TStatId UProjectilePoolSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UProjectilePoolSubsystem, STATGROUP_Tickables);
+}
+
+void UProjectilePoolSubsystem::Prewarm(TSubclassOf<AActor> Clase, int32 Cantidad)
+{
+	if (!Clase)
+	{
+		return;
+	}
+
+	FProjectilePoolEntry& Entrada = Pools.FindOrAdd(Clase);
+	if (Entrada.VidaUtil <= 0.0f)
+	{
+		const FProjectileArchetypeHandle Arquetipo = Arquetipos ? Arquetipos->FindHandleDeClase(Clase) : FProjectileArchetypeHandle();
+		if (Arquetipo.IsValid())
+		{
+			Entrada.VidaUtil = Arquetipos->Get(Arquetipo).VidaUtil;
+		}
+		else
+		{
+			UE_LOG(LogGalaga_USFX, Warning, TEXT("Ningun arquetipo de proyectil usa la clase %s, se usa la vida util por defecto"), *GetNameSafe(Clase));
+			Entrada.VidaUtil = FProjectileArchetypeRow().VidaUtil;
+		}
+	}
+	Entrada.Libres.Reserve(Entrada.Libres.Num() + Cantidad);
+
+	for (int32 i = 0; i < Cantidad; ++i)
+	{
+		if (AActor* Proyectil = SpawnDormido(Clase, Entrada))
+		{
+			Entrada.Libres.Add(Proyectil);
+			++Entrada.Stats.Pooled;
+		}
+	}
+}
+
+AActor* UProjectilePoolSubsystem::Acquire(TSubclassOf<AActor> Clase, const FVector& Location, const FRotator& Rotation)
+{
+	if (!Clase)
+	{
+		return nullptr;
+	}
+
+	FProjectilePoolEntry* Entrada = Pools.Find(Clase);
+	if (Entrada == nullptr)
+	{
+		Prewarm(Clase, 0);
+		Entrada = Pools.Find(Clase);
+	}
+
+	AActor* Proyectil = nullptr;
+	while (Proyectil == nullptr && Entrada->Libres.Num() > 0)
+	{
+		// Los que se destruyeron desde fuera quedan en nullptr despues del GC
+		Proyectil = Entrada->Libres.Pop(false);
+		--Entrada->Stats.Pooled;
+		if (Proyectil && Proyectil->IsPendingKill())
+		{
+			Proyectil = nullptr;
+		}
+	}
+	if (Proyectil == nullptr)
+	{
+		// El pool se quedo corto: crece en uno, el high-water mark dira cuanto subir TamanoInicial
+		Proyectil = SpawnDormido(Clase, *Entrada);
+		if (Proyectil == nullptr)
+		{
+			return nullptr;
+		}
+	}
+
+	++Entrada->Stats.Acquired;
+	++Entrada->Stats.Live;
+	Entrada->Stats.HighWaterMark = FMath::Max(Entrada->Stats.HighWaterMark, Entrada->Stats.Live);
+
+	Vivos.Add(Proyectil, GetWorld()->GetTimeSeconds() + Entrada->VidaUtil);
+	Activar(Proyectil, Location, Rotation);
+	return Proyectil;
+}
+
+AActor* UProjectilePoolSubsystem::Acquire(TSubclassOf<AActor> Clase, const FVector& Location, const FVector& Velocity)
+{
+	AActor* Proyectil = Acquire(Clase, Location, Velocity.Rotation());
+	UProjectileMovementComponent* Movimiento = Proyectil ? Proyectil->FindComponentByClass<UProjectileMovementComponent>() : nullptr;
+	if (Movimiento)
+	{
+		Movimiento->Velocity = Velocity;
+		Movimiento->UpdateComponentVelocity();
+	}
+	return Proyectil;
+}
+
+void UProjectilePoolSubsystem::Release(AActor* Proyectil)
+{
+	if (Proyectil == nullptr || Vivos.Remove(Proyectil) == 0)
+	{
+		return;
+	}
+
+	Desactivar(Proyectil);
+
+	FProjectilePoolEntry& Entrada = Pools.FindChecked(Proyectil->GetClass());
+	Entrada.Libres.Add(Proyectil);
+	--Entrada.Stats.Live;
+	++Entrada.Stats.Pooled;
+}
+
+void UProjectilePoolSubsystem::ReleaseOrDestroy(AActor* Proyectil)
+{
+	if (Proyectil == nullptr)
+	{
+		return;
+	}
+
+	UWorld* World = Proyectil->GetWorld();
+	UProjectilePoolSubsystem* Pool = World ? World->GetSubsystem<UProjectilePoolSubsystem>() : nullptr;
+	if (Pool && Pool->Vivos.Contains(Proyectil))
+	{
+		Pool->Release(Proyectil);
+	}
+	else if (Pool && Pool->EstaDormido(Proyectil))
+	{
+		// Un segundo NotifyHit en el mismo cuadro: ya volvio al pool, destruirlo dejaria un
+		// puntero colgando en Libres
+		return;
+	}
+	else
+	{
+		Proyectil->Destroy();
+	}
+}
+
+bool UProjectilePoolSubsystem::EstaDormido(const AActor* Proyectil) const
+{
+	const FProjectilePoolEntry* Entrada = Pools.Find(Proyectil->GetClass());
+	return Entrada && Entrada->Libres.Contains(Proyectil);
+}
+
+FProjectilePoolStats UProjectilePoolSubsystem::GetStats(TSubclassOf<AActor> Clase) const
+{
+	const FProjectilePoolEntry* Entrada = Pools.Find(Clase);
+	return Entrada ? Entrada->Stats : FProjectilePoolStats();
+}
+
+void UProjectilePoolSubsystem::LogStats() const
+{
+	for (const TPair<UClass*, FProjectilePoolEntry>& Pool : Pools)
+	{
+		const FProjectilePoolStats& Stats = Pool.Value.Stats;
+		UE_LOG(LogGalaga_USFX, Log, TEXT("Pool %s: live=%d pooled=%d high-water=%d spawned=%d acquired=%d"),
+			*GetNameSafe(Pool.Key), Stats.Live, Stats.Pooled, Stats.HighWaterMark, Stats.Spawned, Stats.Acquired);
+	}
+}
+
+AActor* UProjectilePoolSubsystem::SpawnDormido(UClass* Clase, FProjectilePoolEntry& Entrada)
+{
+	FActorSpawnParameters Parametros;
+	Parametros.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	AActor* Proyectil = GetWorld()->SpawnActor<AActor>(Clase, FVector::ZeroVector, FRotator::ZeroRotator, Parametros);
+	if (Proyectil == nullptr)
+	{
+		return nullptr;
+	}
+
+	// La vida util la controla el pool, el actor no debe destruirse solo
+	Proyectil->SetLifeSpan(0.0f);
+	Desactivar(Proyectil);
+	++Entrada.Stats.Spawned;
+	return Proyectil;
+}
+
+void UProjectilePoolSubsystem::Activar(AActor* Proyectil, const FVector& Location, const FRotator& Rotation)
+{
+	Proyectil->SetActorLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::ResetPhysics);
+	Proyectil->SetActorHiddenInGame(false);
+	Proyectil->SetActorEnableCollision(true);
+	Proyectil->SetActorTickEnabled(true);
+
+	if (UProjectileMovementComponent* Movimiento = Proyectil->FindComponentByClass<UProjectileMovementComponent>())
+	{
+		// Al chocar el componente puede haber soltado su UpdatedComponent (StopSimulating)
+		Movimiento->SetUpdatedComponent(Proyectil->GetRootComponent());
+		Movimiento->Velocity = Rotation.Vector() * Movimiento->InitialSpeed;
+		Movimiento->UpdateComponentVelocity();
+		Movimiento->SetComponentTickEnabled(true);
+	}
+}
+
+void UProjectilePoolSubsystem::Desactivar(AActor* Proyectil)
+{
+	if (UProjectileMovementComponent* Movimiento = Proyectil->FindComponentByClass<UProjectileMovementComponent>())
+	{
+		Movimiento->StopMovementImmediately();
+		Movimiento->SetComponentTickEnabled(false);
+	}
+
+	Proyectil->SetActorHiddenInGame(true);
+	Proyectil->SetActorEnableCollision(false);
+	Proyectil->SetActorTickEnabled(false);
+}
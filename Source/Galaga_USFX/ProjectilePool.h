@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ProjectilePool.generated.h"
+
+// Contadores de un pool, sirven para dimensionar los pools con datos de partidas reales
+USTRUCT(BlueprintType)
+struct FProjectilePoolStats
+{
+	GENERATED_BODY()
+
+	// Proyectiles activos en este momento
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Pool")
+	int32 Live = 0;
+
+	// Proyectiles dormidos esperando ser reutilizados
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Pool")
+	int32 Pooled = 0;
+
+	// Maximo de proyectiles activos a la vez desde que empezo el nivel
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Pool")
+	int32 HighWaterMark = 0;
+
+	// Actores creados con SpawnActor (precalentado + crecimiento)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Pool")
+	int32 Spawned = 0;
+
+	// Veces que se pidio un proyectil al pool
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Pool")
+	int32 Acquired = 0;
+};
+
+USTRUCT()
+struct FProjectilePoolEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<AActor*> Libres;
+
+	// VidaUtil del arquetipo de la clase, el pool se encarga de devolver el proyectil cuando se cumple
+	float VidaUtil = 0.0f;
+
+	FProjectilePoolStats Stats;
+};
+
+/**
+ * Pool de proyectiles por tipo. Precalienta instancias al empezar el nivel y las
+ * reutiliza en lugar de hacer SpawnActor/Destroy en cada disparo.
+ */
+UCLASS(config = Game)
+class GALAGA_USFX_API UProjectilePoolSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+public:
+	// Crea Cantidad instancias dormidas de la clase
+	void Prewarm(TSubclassOf<AActor> Clase, int32 Cantidad);
+
+	// Saca un proyectil del pool (o crea uno si esta vacio) y lo lanza desde Location
+	AActor* Acquire(TSubclassOf<AActor> Clase, const FVector& Location, const FRotator& Rotation);
+
+	// Igual, pero lanza con esta velocidad en lugar de InitialSpeed en la direccion de la rotacion
+	AActor* Acquire(TSubclassOf<AActor> Clase, const FVector& Location, const FVector& Velocity);
+
+	// Duerme el proyectil y lo devuelve a su pool
+	void Release(AActor* Proyectil);
+
+	// Para los NotifyHit: devuelve el proyectil al pool si es del pool, si no lo destruye
+	static void ReleaseOrDestroy(AActor* Proyectil);
+
+	FProjectilePoolStats GetStats(TSubclassOf<AActor> Clase) const;
+	void LogStats() const;
+
+protected:
+	// Instancias que se crean por tipo al empezar el nivel
+	UPROPERTY(Config)
+	int32 TamanoInicial = 32;
+
+private:
+	AActor* SpawnDormido(UClass* Clase, FProjectilePoolEntry& Entrada);
+	bool EstaDormido(const AActor* Proyectil) const;
+	void Activar(AActor* Proyectil, const FVector& Location, const FRotator& Rotation);
+	void Desactivar(AActor* Proyectil);
+
+	UPROPERTY()
+	TMap<UClass*, FProjectilePoolEntry> Pools;
+
+	UPROPERTY()
+	class UProjectileArchetypeSubsystem* Arquetipos;
+
+	// Proyectiles activos y el tiempo del mundo en que expiran
+	UPROPERTY()
+	TMap<AActor*, float> Vivos;
+};
@@ -0,0 +1,215 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ReinforcementSubsystem.h"
+#include "NaveEnemiga.h"
+#include "ShipRegistrySubsystem.h"
+#include "ShipSpawnSubsystem.h"
+#include "Galaga_USFX.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+
+DECLARE_CYCLE_STAT(TEXT("Refuerzos"), STAT_Refuerzos_Tick, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Refuerzos en curso"), STAT_Refuerzos_EnCurso, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Refuerzos rechazados"), STAT_Refuerzos_Rechazados, STATGROUP_Game);
+
+// Galaga.Reinforcements.Burst [Avisos]: simula en un cuadro los pedidos de Avisos naves caza
+// y comprueba que se respetan los topes por oleada y global
+static void PruebaRafaga(const TArray<FString>& Args, UWorld* World)
+{
+	UReinforcementSubsystem* Director = World ? World->GetSubsystem<UReinforcementSubsystem>() : nullptr;
+	if (Director == nullptr)
+	{
+		return;
+	}
+
+	const int32 Avisos = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 10;
+	const APawn* Jugador = UGameplayStatics::GetPlayerPawn(World, 0);
+	const FVector Origen = Jugador ? Jugador->GetActorLocation() + FVector(1500.0f, 0.0f, 0.0f) : FVector::ZeroVector;
+
+	const int32 Antes = Director->GetEnCurso();
+	int32 Aceptados = 0;
+	for (int32 i = 0; i < Avisos; ++i)
+	{
+		Aceptados += Director->Pedir(Origen);
+	}
+
+	const bool bCumple = Aceptados <= Director->GetMaxPorOleada() && Director->GetEnCurso() <= Director->GetMaxRefuerzos();
+	UE_LOG(LogGalaga_USFX, Display, TEXT("Reinforcement burst: %s, %d avisos, %d aceptados, en curso %d -> %d (tope oleada %d, global %d)"),
+		bCumple ? TEXT("OK") : TEXT("FALLA"), Avisos, Aceptados, Antes, Director->GetEnCurso(),
+		Director->GetMaxPorOleada(), Director->GetMaxRefuerzos());
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CmdPruebaRafaga(
+	TEXT("Galaga.Reinforcements.Burst"),
+	TEXT("Galaga.Reinforcements.Burst [Avisos=10]: pide refuerzos como si Avisos naves caza recibieran el aviso del espia en el mismo cuadro"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&PruebaRafaga));
+
+bool UReinforcementSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World != nullptr && World->IsGameWorld();
+}
+
+void UReinforcementSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Registro = Collection.InitializeDependency<UShipRegistrySubsystem>();
+	Creador = Collection.InitializeDependency<UShipSpawnSubsystem>();
+}
+
+void UReinforcementSubsystem::Deinitialize()
+{
+	Refuerzos.Reset();
+	FaltanPorOleada.Reset();
+	Pendientes = 0;
+	Registro = nullptr;
+	Creador = nullptr;
+
+	Super::Deinitialize();
+}
+
+int32 UReinforcementSubsystem::Pedir(const FVector& Origen)
+{
+	if (Creador == nullptr || Registro == nullptr || !Registro->Existe(TipoRefuerzo))
+	{
+		return 0;
+	}
+
+	AbrirOleada();
+
+	int32 Aceptados = 0;
+	for (int32 i = 0; i < NavesPorPedido; ++i)
+	{
+		if (PedidosOleada >= MaxPorOleada || GetEnCurso() >= MaxRefuerzos)
+		{
+			break;
+		}
+
+		// La misma fila que armaba SpawnNaveEnemigaCaza, detras de la nave avisada
+		const FVector Posicion = Origen + FVector(-800.0f + i * 200.0f, 0.0f, 0.0f);
+		if (!Creador->Encolar(Oleada, TipoRefuerzo, FTransform(Posicion)))
+		{
+			break;
+		}
+
+		++PedidosOleada;
+		++Pendientes;
+		++FaltanPorOleada.FindOrAdd(Oleada);
+		++Aceptados;
+	}
+
+	INC_DWORD_STAT_BY(STAT_Refuerzos_Rechazados, NavesPorPedido - Aceptados);
+	SET_DWORD_STAT(STAT_Refuerzos_EnCurso, GetEnCurso());
+	return Aceptados;
+}
+
+void UReinforcementSubsystem::AbrirOleada()
+{
+	// Todos los pedidos de un aviso llegan en el mismo cuadro y comparten la oleada
+	if (Oleada != INDEX_NONE && CuadroOleada == GFrameCounter)
+	{
+		return;
+	}
+
+	TWeakObjectPtr<UReinforcementSubsystem> Director = this;
+	TSharedRef<int32> Numero = MakeShared<int32>(INDEX_NONE);
+	Oleada = Creador->IniciarOleada(
+		[Director, Numero](ANaveEnemiga* Nave)
+		{
+			if (Director.IsValid())
+			{
+				Director->AlCrearRefuerzo(*Numero, Nave);
+			}
+		},
+		[Director](int32 Terminada)
+		{
+			if (Director.IsValid())
+			{
+				Director->AlTerminarOleada(Terminada);
+			}
+		});
+	*Numero = Oleada;
+
+	CuadroOleada = GFrameCounter;
+	PedidosOleada = 0;
+}
+
+void UReinforcementSubsystem::AlCrearRefuerzo(int32 Numero, ANaveEnemiga* Nave)
+{
+	if (int32* Faltan = FaltanPorOleada.Find(Numero))
+	{
+		--*Faltan;
+		Pendientes = FMath::Max(Pendientes - 1, 0);
+	}
+
+	Refuerzos.Add({ Nave, Duracion });
+	Nave->AlDestruirse.AddUObject(this, &UReinforcementSubsystem::AlDestruirseRefuerzo);
+}
+
+void UReinforcementSubsystem::AlTerminarOleada(int32 Numero)
+{
+	// Lo que no se llego a crear deja de contar para el tope
+	int32 Faltan = 0;
+	if (FaltanPorOleada.RemoveAndCopyValue(Numero, Faltan))
+	{
+		Pendientes = FMath::Max(Pendientes - Faltan, 0);
+	}
+}
+
+void UReinforcementSubsystem::AlDestruirseRefuerzo(ANaveEnemiga* Nave)
+{
+	Refuerzos.RemoveAllSwap([Nave](const FRefuerzo& Refuerzo) { return Refuerzo.Nave.Get() == Nave; });
+}
+
+void UReinforcementSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_Refuerzos_Tick);
+
+	// Los que cumplieron su tiempo vuelven al registro sin contar como muertos
+	Refuerzos.RemoveAllSwap([this, DeltaTime](FRefuerzo& Refuerzo)
+	{
+		ANaveEnemiga* Nave = Refuerzo.Nave.Get();
+		if (Nave == nullptr || Nave->EstaDormida())
+		{
+			return true;
+		}
+
+		Refuerzo.Restante -= DeltaTime;
+		if (Refuerzo.Restante > 0.0f)
+		{
+			return false;
+		}
+
+		Nave->AlDestruirse.RemoveAll(this);
+		if (Registro)
+		{
+			Registro->Guardar(Nave);
+		}
+		else
+		{
+			Nave->Destroy();
+		}
+		return true;
+	});
+
+	SET_DWORD_STAT(STAT_Refuerzos_EnCurso, GetEnCurso());
+}
+
+ETickableTickType UReinforcementSubsystem::GetTickableTickType() const
+{
+	return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UReinforcementSubsystem::IsTickable() const
+{
+	return Refuerzos.Num() > 0;
+}
+
+TStatId UReinforcementSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UReinforcementSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ReinforcementSubsystem.generated.h"
+
+class ANaveEnemiga;
+class UShipRegistrySubsystem;
+class UShipSpawnSubsystem;
+
+/**
+ * Director de refuerzos. Cuando la NaveEnemigaEspia avisa, cada NaveEnemigaCaza pide
+ * refuerzos aqui en lugar de crearlos ella misma. Los pedidos de un mismo cuadro forman una
+ * oleada con tope propio (MaxPorOleada) y ademas hay un tope global de refuerzos en juego
+ * (MaxRefuerzos), asi avisos repetidos no hacen crecer la cantidad de naves.
+ *
+ * Las naves no se crean dentro del aviso: se encolan en el UShipSpawnSubsystem, que las
+ * despierta desde las dormidas del UShipRegistrySubsystem en los cuadros siguientes. Pasada
+ * su Duracion cada refuerzo vuelve dormido al registro.
+ */
+UCLASS(config = Game)
+class GALAGA_USFX_API UReinforcementSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+public:
+	// Pide NavesPorPedido refuerzos alrededor de Origen. Devuelve cuantos se aceptaron; el
+	// resto se descarta por los topes
+	int32 Pedir(const FVector& Origen);
+
+	// Refuerzos en juego mas los que esperan en la cola de creacion
+	FORCEINLINE int32 GetEnCurso() const { return Refuerzos.Num() + Pendientes; }
+	FORCEINLINE int32 GetMaxRefuerzos() const { return MaxRefuerzos; }
+	FORCEINLINE int32 GetMaxPorOleada() const { return MaxPorOleada; }
+
+protected:
+	// Tipo del UShipRegistrySubsystem que se usa como refuerzo
+	UPROPERTY(Config)
+	FName TipoRefuerzo = TEXT("EnemigaCaza");
+
+	// Naves por cada NaveEnemigaCaza avisada
+	UPROPERTY(Config)
+	int32 NavesPorPedido = 2;
+
+	// Tope de refuerzos pedidos en un mismo aviso (un cuadro)
+	UPROPERTY(Config)
+	int32 MaxPorOleada = 6;
+
+	// Tope de refuerzos en juego o por crear, sumando todas las oleadas
+	UPROPERTY(Config)
+	int32 MaxRefuerzos = 12;
+
+	// Segundos que dura un refuerzo antes de volver al registro
+	UPROPERTY(Config)
+	float Duracion = 5.0f;
+
+private:
+	struct FRefuerzo
+	{
+		TWeakObjectPtr<ANaveEnemiga> Nave;
+		float Restante;
+	};
+
+	// Abre la oleada del cuadro en el UShipSpawnSubsystem si todavia no hay una
+	void AbrirOleada();
+
+	void AlCrearRefuerzo(int32 Numero, ANaveEnemiga* Nave);
+	void AlTerminarOleada(int32 Numero);
+	void AlDestruirseRefuerzo(ANaveEnemiga* Nave);
+
+	TArray<FRefuerzo> Refuerzos;
+
+	// Pedidos aceptados que el UShipSpawnSubsystem todavia no creo, por oleada
+	TMap<int32, int32> FaltanPorOleada;
+	int32 Pendientes = 0;
+
+	int32 Oleada = INDEX_NONE;
+	uint64 CuadroOleada = 0;
+	int32 PedidosOleada = 0;
+
+	UPROPERTY()
+	UShipRegistrySubsystem* Registro;
+
+	UPROPERTY()
+	UShipSpawnSubsystem* Creador;
+};
@@ -3,7 +3,7 @@
 
 #include "ShieldedState.h"
 #include "Galaga_USFXPawn.h"
-#include "EscudoPawn.h"
+#include "EscudoComponent.h"
 
 // Sets default values
 AShieldedState::AShieldedState()
@@ -37,25 +37,13 @@ void AShieldedState::SetupPlayerInputComponent(UInputComponent* PlayerInputCompo
 void AShieldedState::EstadoProtegido()
 {
 	GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Purple, TEXT("Se activo el estado protegido"));
-	//en este codigo crearemos un escudo para la nave
-
-	FVector PosicionEscudo = NavePawn->GetActorLocation();
-	AEscudoPawn* Escudo = GetWorld()->SpawnActor<AEscudoPawn>(AEscudoPawn::StaticClass(), PosicionEscudo, FRotator::ZeroRotator);
-
+	//el escudo vive en la nave, aqui solo se prende por 5 segundos
+	UEscudoComponent* Escudo = NavePawn ? NavePawn->GetEscudo() : nullptr;
 	if (Escudo != nullptr) {
-		Escudo->AttachToActor(NavePawn, FAttachmentTransformRules::SnapToTargetIncludingScale);
-		Escudo->SetActorRelativeLocation(FVector(0.0f, 10.0f, 180.0f));
-		Escudo->SetActorScale3D(FVector(2.0f, 0.6f, 1.0f));
-		//Escudo->SetActorRotation(FRotator(0.0f, 90.0f, -100.0f));
-
-		FTimerHandle TimerHandle;
-		GetWorld()->GetTimerManager().SetTimer(TimerHandle, [Escudo]()
-			{
-				Escudo->Destroy();
-			}, 5.0f, false);
+		Escudo->Activar(5.0f);
 	}
 	else {
-		GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, TEXT("No se pudo crear el escudo"));
+		GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, TEXT("No se pudo activar el escudo"));
 	}
 }
 
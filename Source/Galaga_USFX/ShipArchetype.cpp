@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShipArchetype.h"
+#include "NaveEnemiga.h"
+#include "Galaga_USFX.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+
+// Los campos que cada ANaveEnemiga guardaba antes de UShipArchetype, con el mismo orden y tipos
+struct FCamposNaveAnteriores
+{
+	float resistencia;
+	float velocidad;
+	float danoProducido;
+	FString nombre;
+	float tiempoDisparo;
+	FVector posicion;
+	int trayectoria;
+	int capacidadPasajeros;
+	int capacidadMunicion;
+	int tipoNave;
+	float experencia;
+	float energia;
+	float peso;
+	float volumen;
+	float limiteY;
+	float limiteX;
+	FString ShipName;
+};
+
+// Galaga.Ships.Memory: memoria por nave de las naves vivas y lo que ahorra compartir el arquetipo
+static void ReportarMemoriaNaves(const TArray<FString>& Args, UWorld* World)
+{
+	if (World == nullptr)
+	{
+		return;
+	}
+
+	TMap<UClass*, int32> PorClase;
+	TSet<const UShipArchetype*> Arquetipos;
+	int32 Naves = 0;
+	int64 BytesNaves = 0;
+	for (TActorIterator<ANaveEnemiga> It(World); It; ++It)
+	{
+		++Naves;
+		++PorClase.FindOrAdd(It->GetClass());
+		BytesNaves += It->GetClass()->GetPropertiesSize();
+		Arquetipos.Add(It->GetArquetipo());
+	}
+
+	for (const TPair<UClass*, int32>& Clase : PorClase)
+	{
+		UE_LOG(LogGalaga_USFX, Display, TEXT("  %s: %d naves, %d bytes por actor"), *Clase.Key->GetName(), Clase.Value, Clase.Key->GetPropertiesSize());
+	}
+
+	// Lo que queda en cada nave es el puntero al arquetipo y la vida
+	const int64 PorNaveAntes = sizeof(FCamposNaveAnteriores);
+	const int64 PorNaveAhora = sizeof(UShipArchetype*) + sizeof(float);
+	const int64 Compartido = Arquetipos.Num() * (int64)UShipArchetype::StaticClass()->GetPropertiesSize();
+	UE_LOG(LogGalaga_USFX, Display, TEXT("Ships memory: %d naves, %lld KB en actores; datos de tipo %lld bytes por nave antes, %lld ahora; %d arquetipos compartidos (%lld bytes); ahorro %lld KB"),
+		Naves, BytesNaves / 1024, PorNaveAntes, PorNaveAhora, Arquetipos.Num(), Compartido,
+		(Naves * (PorNaveAntes - PorNaveAhora) - Compartido) / 1024);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CmdReportarMemoriaNaves(
+	TEXT("Galaga.Ships.Memory"),
+	TEXT("Galaga.Ships.Memory: bytes por nave enemiga viva y ahorro de los datos compartidos en UShipArchetype"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&ReportarMemoriaNaves));
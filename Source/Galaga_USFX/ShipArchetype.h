@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ShipArchetype.generated.h"
+
+/**
+ * Datos compartidos de un tipo de nave enemiga (flyweight). Antes cada ANaveEnemiga tenia su
+ * copia de todos estos valores aunque eran iguales para todas las naves del tipo; ahora la
+ * nave solo guarda un puntero al arquetipo y su estado propio (vida, disparo, formacion).
+ *
+ * Se crea un asset por tipo en Content/Data y se asigna en el Arquetipo de la nave. Una nave
+ * sin asset usa el objeto por defecto de esta clase, con los valores que ponia el constructor
+ * de ANaveEnemiga.
+ */
+UCLASS(BlueprintType)
+class GALAGA_USFX_API UShipArchetype : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	// Puntos de vida iniciales de cada nave. Cada impacto resta el Dano de su proyectil: con 10,
+	// lo que hace un disparo del jugador, muere de un disparo
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Nave")
+	float Resistencia = 10.0f;
+
+	// Por 100 son unidades por segundo
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Nave")
+	float Velocidad = 4.0f;
+
+	// Potencia de cada proyectil que dispara la nave
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Nave")
+	float DanoProducido = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Nave")
+	FString Nombre;
+
+	// Tiempo que debe transcurrir entre cada disparo
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Nave")
+	float TiempoDisparo = 0.0f;
+
+	// Representa a una funcion que la nave debe asumir para moverse
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Nave")
+	int32 Trayectoria = 0;
+
+	// Numero de naves que puede transportar
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Nave")
+	int32 CapacidadPasajeros = 0;
+
+	// Numero de disparos que puede realizar antes de recargar
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Nave")
+	int32 CapacidadMunicion = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Nave")
+	int32 TipoNave = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Nave")
+	float Experiencia = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Nave")
+	float Energia = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Nave")
+	float Peso = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Nave")
+	float Volumen = 0.0f;
+
+	// Al pasar de -LimiteY la nave reaparece en +LimiteY
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Movimiento")
+	float LimiteY = 1000.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Movimiento")
+	float LimiteX = -1600.0f;
+};
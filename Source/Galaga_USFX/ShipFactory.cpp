@@ -3,12 +3,8 @@
 
 #include "ShipFactory.h"
 
-#include "NaveEnemigaCaza.h"
-
-#include "NaveEnemigaEspia.h"
-#include "NaveEnemigaNodriza.h"
-#include "NaveEnemigaReabastecimiento.h"
-#include "NaveEnemigaTransporte.h"
+#include "ShipRegistrySubsystem.h"
+#include "ShipSpawnSubsystem.h"
 
 // Sets default values
 AShipFactory::AShipFactory()
@@ -34,39 +30,18 @@ void AShipFactory::Tick(float DeltaTime)
 
 ANaveEnemiga* AShipFactory::CrearNaveEnemiga(FString TipoNave, UWorld* World, FVector SpawnLocation, FRotator SpawnRotation)
 {
-	if (!World)
+	UShipRegistrySubsystem* Registro = World ? World->GetSubsystem<UShipRegistrySubsystem>() : nullptr;
+	if (!Registro)
 	{
 		return nullptr;
 	}
-	FVector NuevaSpawnLocation = SpawnLocation;
-	if (TipoNave == "EnemigaCaza")
-	{
-		ANaveEnemigaCaza* NewShip = World->SpawnActor<ANaveEnemigaCaza>(NuevaSpawnLocation, SpawnRotation);
-		return NewShip;
-	}
-	else if (TipoNave == "EnemigaEspia")
-	{
-		ANaveEnemigaEspia* NewShip = World->SpawnActor<ANaveEnemigaEspia>(NuevaSpawnLocation, SpawnRotation);
-		return NewShip;
-	}
-	else if (TipoNave == "EnemigaNodriza")
-	{
-		ANaveEnemigaNodriza* NewShip = World->SpawnActor<ANaveEnemigaNodriza>(NuevaSpawnLocation, SpawnRotation);
-		return NewShip;
-	}
-	else if (TipoNave == "EnemigaReabastecimiento")
-	{
-		ANaveEnemigaReabastecimiento* NewShip = World->SpawnActor<ANaveEnemigaReabastecimiento>(NuevaSpawnLocation, SpawnRotation);
-		return NewShip;
-	}
-	else if (TipoNave == "EnemigaTransporte")
-	{
-		ANaveEnemigaTransporte* NewShip = World->SpawnActor<ANaveEnemigaTransporte>(NuevaSpawnLocation, SpawnRotation);
-		return NewShip;
-	}
-
+	return Registro->Crear(FName(*TipoNave), FTransform(SpawnRotation, SpawnLocation));
+}
 
-	return nullptr;
+bool AShipFactory::EncolarNaveEnemiga(FString TipoNave, UWorld* World, int32 Oleada, FVector SpawnLocation, FRotator SpawnRotation)
+{
+	UShipSpawnSubsystem* Creador = World ? World->GetSubsystem<UShipSpawnSubsystem>() : nullptr;
+	return Creador && Creador->Encolar(Oleada, FName(*TipoNave), FTransform(SpawnRotation, SpawnLocation));
 }
 
 
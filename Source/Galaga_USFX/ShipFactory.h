@@ -23,7 +23,13 @@ protected:
 public:	
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
+	// TipoNave es un nombre del UShipRegistrySubsystem ("EnemigaCaza", "EnemigaCazaAlfa", ...); si
+	// hay una nave precalentada de ese tipo solo se despierta
 	static ANaveEnemiga* CrearNaveEnemiga(FString TipoNave, UWorld* World, FVector SpawnLocation, FRotator SpawnRotation);
+
+	// Igual que CrearNaveEnemiga pero sin crearla ya: la pide al UShipSpawnSubsystem para la
+	// oleada dada, que la crea cuando le alcanza el presupuesto del cuadro
+	static bool EncolarNaveEnemiga(FString TipoNave, UWorld* World, int32 Oleada, FVector SpawnLocation, FRotator SpawnRotation);
 	
 
 };
@@ -0,0 +1,325 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShipRegistrySubsystem.h"
+#include "NaveEnemiga.h"
+#include "NaveEnemigaCaza.h"
+#include "NaveEnemigaCazaAlfa.h"
+#include "NaveEnemigaCazaBeta.h"
+#include "NaveEnemigaEspia.h"
+#include "NaveEnemigaEspiaAlfa.h"
+#include "NaveEnemigaEspiaBeta.h"
+#include "NaveEnemigaNodriza.h"
+#include "NaveEnemigaNodrizaAlfa.h"
+#include "NaveEnemigaNodrizaBeta.h"
+#include "NaveEnemigaReabastecimiento.h"
+#include "NaveEnemigaReabastecimientoAlfa.h"
+#include "NaveEnemigaReabastecimientoBeta.h"
+#include "NaveEnemigaTransporte.h"
+#include "NaveEnemigaTransporteAlfa.h"
+#include "NaveEnemigaTransporteBeta.h"
+#include "ShipArchetype.h"
+#include "Galaga_USFX.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectArray.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Naves despertadas"), STAT_ShipRegistry_Despertadas, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Naves creadas sin precalentar"), STAT_ShipRegistry_Construidas, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Naves guardadas"), STAT_ShipRegistry_Guardadas, STATGROUP_Game);
+
+// Las precalentadas esperan aqui, lejos de la camara, hasta que se despiertan
+static const FVector PosicionDormidas(0.0f, 0.0f, -10000.0f);
+
+// Galaga.Ships.Types: una linea por tipo registrado, "Tipo Nombre Clase Arquetipo Dormidas",
+// para que los scripts de prueba sepan que tipos pueden pedir
+static void ListarTipos(const TArray<FString>& Args, UWorld* World)
+{
+	UShipRegistrySubsystem* Registro = World ? World->GetSubsystem<UShipRegistrySubsystem>() : nullptr;
+	if (Registro == nullptr)
+	{
+		return;
+	}
+
+	TArray<FName> Nombres;
+	Registro->GetTipos(Nombres);
+	for (const FName& Nombre : Nombres)
+	{
+		UE_LOG(LogGalaga_USFX, Display, TEXT("Tipo %s %s %s %d"), *Nombre.ToString(), *GetNameSafe(Registro->GetClase(Nombre)),
+			*GetNameSafe(Registro->GetArquetipo(Nombre)), Registro->GetNumDormidas(Nombre));
+	}
+	UE_LOG(LogGalaga_USFX, Display, TEXT("%d tipos de nave registrados"), Nombres.Num());
+
+	// En una prueba larga estos numeros no deben crecer con las oleadas despejadas
+	UE_LOG(LogGalaga_USFX, Display, TEXT("Naves creadas %d, despertadas %d, guardadas %d; UObjects vivos %d"),
+		Registro->GetTotalCreadas(), Registro->GetTotalDespertadas(), Registro->GetTotalGuardadas(),
+		GUObjectArray.GetObjectArrayNumMinusAvailable());
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CmdListarTipos(
+	TEXT("Galaga.Ships.Types"),
+	TEXT("Galaga.Ships.Types: lista los tipos de nave enemiga registrados, con su clase, arquetipo y naves precalentadas"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&ListarTipos));
+
+// Galaga.Ships.KillAll: mata todas las naves enemigas en juego por el camino normal de dano,
+// para que una prueba larga despeje oleadas sin jugar
+static FAutoConsoleCommandWithWorld CmdMatarTodas(
+	TEXT("Galaga.Ships.KillAll"),
+	TEXT("Galaga.Ships.KillAll: destruye todas las naves enemigas en juego; vuelven dormidas al registro"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (World == nullptr)
+		{
+			return;
+		}
+
+		TArray<ANaveEnemiga*> Naves;
+		for (TActorIterator<ANaveEnemiga> It(World); It; ++It)
+		{
+			if (!It->EstaDormida())
+			{
+				Naves.Add(*It);
+			}
+		}
+		for (ANaveEnemiga* Nave : Naves)
+		{
+			Nave->TakeDamage(FMath::Max(Nave->GetResistencia(), 1.0f), FDamageEvent(), nullptr, nullptr);
+		}
+		UE_LOG(LogGalaga_USFX, Display, TEXT("%d naves destruidas"), Naves.Num());
+	}));
+
+bool UShipRegistrySubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World != nullptr && World->IsGameWorld();
+}
+
+void UShipRegistrySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	RegistrarPorDefecto();
+
+	for (const FShipTypeConfig& Fila : Tipos)
+	{
+		if (Fila.Nombre.IsNone())
+		{
+			continue;
+		}
+
+		UClass* Clase = Fila.Clase.IsValid() ? Fila.Clase.TryLoadClass<ANaveEnemiga>() : nullptr;
+		UShipArchetype* Arquetipo = Fila.Arquetipo.IsValid() ? Cast<UShipArchetype>(Fila.Arquetipo.TryLoad()) : nullptr;
+		if (Fila.Clase.IsValid() && Clase == nullptr)
+		{
+			UE_LOG(LogGalaga_USFX, Warning, TEXT("No se encontro la clase '%s' del tipo de nave '%s'"), *Fila.Clase.ToString(), *Fila.Nombre.ToString());
+		}
+
+		const int32* Indice = Indices.Find(Fila.Nombre);
+		if (Clase || Arquetipo)
+		{
+			Registrar(Fila.Nombre, Clase ? Clase : (Indice ? *Registro[*Indice].Clase : nullptr), Arquetipo);
+			Indice = Indices.Find(Fila.Nombre);
+		}
+		if (Indice)
+		{
+			Registro[*Indice].PorPrecalentar = FMath::Max(Fila.Precalentar, 0);
+		}
+	}
+}
+
+void UShipRegistrySubsystem::Deinitialize()
+{
+	Registro.Empty();
+	Indices.Empty();
+	Arquetipos.Empty();
+
+	Super::Deinitialize();
+}
+
+void UShipRegistrySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Todavia en la pantalla de carga: lo que cueste crear las naves no se ve en el juego
+	const double Inicio = FPlatformTime::Seconds();
+	int32 Creadas = 0;
+	for (const FTipo& Tipo : Registro)
+	{
+		Creadas += Precalentar(Tipo.Nombre, Tipo.PorPrecalentar);
+	}
+	if (Creadas > 0)
+	{
+		UE_LOG(LogGalaga_USFX, Log, TEXT("Registro de naves: %d precalentadas en %.2f ms"), Creadas, (FPlatformTime::Seconds() - Inicio) * 1000.0);
+	}
+}
+
+void UShipRegistrySubsystem::Registrar(FName Nombre, TSubclassOf<ANaveEnemiga> Clase, UShipArchetype* Arquetipo)
+{
+	if (Nombre.IsNone() || Clase == nullptr || Clase->HasAnyClassFlags(CLASS_Abstract))
+	{
+		return;
+	}
+
+	if (Arquetipo)
+	{
+		Arquetipos.AddUnique(Arquetipo);
+	}
+
+	if (const int32* Indice = Indices.Find(Nombre))
+	{
+		FTipo& Tipo = Registro[*Indice];
+		Tipo.Clase = Clase;
+		Tipo.Arquetipo = Arquetipo;
+		return;
+	}
+
+	Indices.Add(Nombre, Registro.Num());
+	Registro.Add({ Nombre, Clase, Arquetipo, 0, {} });
+}
+
+void UShipRegistrySubsystem::RegistrarPorDefecto()
+{
+	// Los nombres que ya usaba AShipFactory, mas las variantes que antes no se podian pedir
+	Registrar(TEXT("EnemigaCaza"), ANaveEnemigaCaza::StaticClass());
+	Registrar(TEXT("EnemigaCazaAlfa"), ANaveEnemigaCazaAlfa::StaticClass());
+	Registrar(TEXT("EnemigaCazaBeta"), ANaveEnemigaCazaBeta::StaticClass());
+	Registrar(TEXT("EnemigaEspia"), ANaveEnemigaEspia::StaticClass());
+	Registrar(TEXT("EnemigaEspiaAlfa"), ANaveEnemigaEspiaAlfa::StaticClass());
+	Registrar(TEXT("EnemigaEspiaBeta"), ANaveEnemigaEspiaBeta::StaticClass());
+	Registrar(TEXT("EnemigaNodriza"), ANaveEnemigaNodriza::StaticClass());
+	Registrar(TEXT("EnemigaNodrizaAlfa"), ANaveEnemigaNodrizaAlfa::StaticClass());
+	Registrar(TEXT("EnemigaNodrizaBeta"), ANaveEnemigaNodrizaBeta::StaticClass());
+	Registrar(TEXT("EnemigaReabastecimiento"), ANaveEnemigaReabastecimiento::StaticClass());
+	Registrar(TEXT("EnemigaReabastecimientoAlfa"), ANaveEnemigaReabastecimientoAlfa::StaticClass());
+	Registrar(TEXT("EnemigaReabastecimientoBeta"), ANaveEnemigaReabastecimientoBeta::StaticClass());
+	Registrar(TEXT("EnemigaTransporte"), ANaveEnemigaTransporte::StaticClass());
+	Registrar(TEXT("EnemigaTransporteAlfa"), ANaveEnemigaTransporteAlfa::StaticClass());
+	Registrar(TEXT("EnemigaTransporteBeta"), ANaveEnemigaTransporteBeta::StaticClass());
+}
+
+int32 UShipRegistrySubsystem::Precalentar(FName Nombre, int32 Cantidad)
+{
+	const int32* Indice = Indices.Find(Nombre);
+	if (Indice == nullptr || Cantidad <= 0)
+	{
+		return 0;
+	}
+
+	FTipo& Tipo = Registro[*Indice];
+	int32 Creadas = 0;
+	for (int32 i = 0; i < Cantidad; ++i)
+	{
+		if (ANaveEnemiga* Nave = Construir(Tipo, FTransform(PosicionDormidas), true))
+		{
+			Tipo.Dormidas.Add(Nave);
+			++Creadas;
+		}
+	}
+	return Creadas;
+}
+
+ANaveEnemiga* UShipRegistrySubsystem::Crear(FName Nombre, const FTransform& Transform)
+{
+	const int32* Indice = Indices.Find(Nombre);
+	if (Indice == nullptr)
+	{
+		UE_LOG(LogGalaga_USFX, Warning, TEXT("No existe el tipo de nave '%s'"), *Nombre.ToString());
+		return nullptr;
+	}
+
+	FTipo& Tipo = Registro[*Indice];
+	while (Tipo.Dormidas.Num() > 0)
+	{
+		ANaveEnemiga* Nave = Tipo.Dormidas.Pop(false).Get();
+		if (Nave && !Nave->IsPendingKill() && Nave->EstaDormida())
+		{
+			Nave->Despertar(Transform);
+			++TotalDespertadas;
+			INC_DWORD_STAT(STAT_ShipRegistry_Despertadas);
+			return Nave;
+		}
+	}
+
+	INC_DWORD_STAT(STAT_ShipRegistry_Construidas);
+	return Construir(Tipo, Transform, false);
+}
+
+void UShipRegistrySubsystem::Guardar(ANaveEnemiga* Nave)
+{
+	if (Nave == nullptr)
+	{
+		return;
+	}
+
+	const int32* Indice = Indices.Find(Nave->GetTipo());
+	FTipo* Tipo = Indice ? &Registro[*Indice] : nullptr;
+	if (Tipo == nullptr || Tipo->Clase != Nave->GetClass() || Tipo->Dormidas.Num() >= MaxDormidasPorTipo)
+	{
+		Nave->Destroy();
+		return;
+	}
+
+	Nave->Dormir();
+	Nave->SetActorLocation(PosicionDormidas);
+	Tipo->Dormidas.Add(Nave);
+	++TotalGuardadas;
+	INC_DWORD_STAT(STAT_ShipRegistry_Guardadas);
+}
+
+ANaveEnemiga* UShipRegistrySubsystem::Construir(const FTipo& Tipo, const FTransform& Transform, bool bDormida)
+{
+	// Diferido: el arquetipo y el tipo quedan puestos antes de BeginPlay
+	ANaveEnemiga* Nave = GetWorld()->SpawnActorDeferred<ANaveEnemiga>(Tipo.Clase, Transform, nullptr, nullptr,
+		ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (Nave == nullptr)
+	{
+		return nullptr;
+	}
+
+	if (Tipo.Arquetipo)
+	{
+		Nave->SetArquetipo(Tipo.Arquetipo);
+	}
+	Nave->SetTipo(Tipo.Nombre);
+	if (bDormida)
+	{
+		Nave->Dormir();
+	}
+	Nave->FinishSpawning(Transform);
+	++TotalCreadas;
+	return Nave;
+}
+
+TSubclassOf<ANaveEnemiga> UShipRegistrySubsystem::GetClase(FName Nombre) const
+{
+	const int32* Indice = Indices.Find(Nombre);
+	return Indice ? Registro[*Indice].Clase : nullptr;
+}
+
+const UShipArchetype* UShipRegistrySubsystem::GetArquetipo(FName Nombre) const
+{
+	const int32* Indice = Indices.Find(Nombre);
+	if (Indice == nullptr)
+	{
+		return nullptr;
+	}
+
+	const FTipo& Tipo = Registro[*Indice];
+	return Tipo.Arquetipo ? Tipo.Arquetipo : Tipo.Clase->GetDefaultObject<ANaveEnemiga>()->GetArquetipo();
+}
+
+int32 UShipRegistrySubsystem::GetNumDormidas(FName Nombre) const
+{
+	const int32* Indice = Indices.Find(Nombre);
+	return Indice ? Registro[*Indice].Dormidas.Num() : 0;
+}
+
+void UShipRegistrySubsystem::GetTipos(TArray<FName>& OutNombres) const
+{
+	OutNombres.Reset(Registro.Num());
+	for (const FTipo& Tipo : Registro)
+	{
+		OutNombres.Add(Tipo.Nombre);
+	}
+}
@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShipRegistrySubsystem.generated.h"
+
+class ANaveEnemiga;
+class UShipArchetype;
+
+// Fila de configuracion: registra un tipo nuevo, cambia la clase o el arquetipo de uno
+// existente, o solo dice cuantas instancias precalentar. Los campos vacios no cambian nada
+USTRUCT()
+struct FShipTypeConfig
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FName Nombre;
+
+	UPROPERTY()
+	FSoftClassPath Clase;
+
+	UPROPERTY()
+	FSoftObjectPath Arquetipo;
+
+	UPROPERTY()
+	int32 Precalentar = 0;
+};
+
+/**
+ * Registro de tipos de nave enemiga: nombre -> clase + arquetipo (UShipArchetype). Incluye
+ * los cinco tipos base y sus variantes Alfa y Beta, mas los que agregue la configuracion.
+ *
+ * Al empezar el mundo crea de antemano las instancias pedidas en Precalentar y las deja
+ * dormidas (ANaveEnemiga::Dormir). Crear busca el tipo en un mapa y, si hay una dormida, solo
+ * la despierta; si no, la crea con el arquetipo ya puesto antes de su BeginPlay. Las naves
+ * que mueren vuelven dormidas con Guardar, asi despejar oleadas no crea ni destruye actores.
+ */
+UCLASS(config = Game)
+class GALAGA_USFX_API UShipRegistrySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+public:
+	// Agrega el tipo o reemplaza su clase y arquetipo. Arquetipo nulo: el de la clase
+	void Registrar(FName Nombre, TSubclassOf<ANaveEnemiga> Clase, UShipArchetype* Arquetipo = nullptr);
+
+	// Deja Cantidad instancias dormidas mas del tipo. Devuelve cuantas se crearon
+	int32 Precalentar(FName Nombre, int32 Cantidad);
+
+	// Nave del tipo en juego en Transform, despertando una precalentada si la hay; nullptr si
+	// el tipo no existe
+	ANaveEnemiga* Crear(FName Nombre, const FTransform& Transform);
+
+	// Duerme la nave y la deja para el proximo Crear de su tipo; si el tipo ya tiene
+	// MaxDormidasPorTipo, o la nave no es del registro, la destruye
+	void Guardar(ANaveEnemiga* Nave);
+
+	FORCEINLINE bool Existe(FName Nombre) const { return Indices.Contains(Nombre); }
+	TSubclassOf<ANaveEnemiga> GetClase(FName Nombre) const;
+
+	// El del registro o, si no tiene, el que trae la clase
+	const UShipArchetype* GetArquetipo(FName Nombre) const;
+	int32 GetNumDormidas(FName Nombre) const;
+
+	// Todos los tipos en el orden en que se registraron, para los comandos de prueba
+	void GetTipos(TArray<FName>& OutNombres) const;
+
+	// Desde que empezo el mundo: naves creadas (precalentadas o no), despertadas y guardadas
+	FORCEINLINE int32 GetTotalCreadas() const { return TotalCreadas; }
+	FORCEINLINE int32 GetTotalDespertadas() const { return TotalDespertadas; }
+	FORCEINLINE int32 GetTotalGuardadas() const { return TotalGuardadas; }
+
+protected:
+	UPROPERTY(Config)
+	TArray<FShipTypeConfig> Tipos;
+
+	// Tope de naves dormidas por tipo; las que mueren de mas se destruyen
+	UPROPERTY(Config)
+	int32 MaxDormidasPorTipo = 64;
+
+private:
+	struct FTipo
+	{
+		FName Nombre;
+		TSubclassOf<ANaveEnemiga> Clase;
+		UShipArchetype* Arquetipo;
+		int32 PorPrecalentar;
+		TArray<TWeakObjectPtr<ANaveEnemiga>> Dormidas;
+	};
+
+	void RegistrarPorDefecto();
+
+	// Crea la nave con su tipo y arquetipo; bDormida la duerme antes de que entre al juego
+	ANaveEnemiga* Construir(const FTipo& Tipo, const FTransform& Transform, bool bDormida);
+
+	TArray<FTipo> Registro;
+	TMap<FName, int32> Indices;
+
+	int32 TotalCreadas = 0;
+	int32 TotalDespertadas = 0;
+	int32 TotalGuardadas = 0;
+
+	// Los arquetipos del registro no se pueden recolectar mientras exista el mundo
+	UPROPERTY()
+	TArray<UShipArchetype*> Arquetipos;
+};
@@ -0,0 +1,259 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShipSpawnSubsystem.h"
+#include "NaveEnemiga.h"
+#include "ShipRegistrySubsystem.h"
+#include "Galaga_USFX.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Creacion de naves"), STAT_ShipSpawn_Tick, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Naves por crear"), STAT_ShipSpawn_Pendientes, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Naves creadas"), STAT_ShipSpawn_Creadas, STATGROUP_Game);
+
+// Galaga.Spawn.BudgetTest [Naves] [PresupuestoUs] [ToleranciaUs]: crea una oleada con presupuesto y revisa
+// que ningun cuadro pase del presupuesto mas una tolerancia fija
+static void PruebaPresupuesto(const TArray<FString>& Args, UWorld* World)
+{
+	UShipSpawnSubsystem* Creador = World ? World->GetSubsystem<UShipSpawnSubsystem>() : nullptr;
+	if (Creador == nullptr)
+	{
+		return;
+	}
+
+	const int32 Naves = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 200;
+	const int32 Presupuesto = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : Creador->GetPresupuestoMicrosegundos();
+	// Lo que puede pasarse la ultima nave de un cuadro; no depende de lo que se midio
+	const int32 Tolerancia = Args.Num() > 2 ? FCString::Atoi(*Args[2]) : 500;
+	const int32 PresupuestoAnterior = Creador->GetPresupuestoMicrosegundos();
+	Creador->SetPresupuestoMicrosegundos(Presupuesto);
+
+	TSharedRef<TArray<TWeakObjectPtr<ANaveEnemiga>>> Creadas = MakeShared<TArray<TWeakObjectPtr<ANaveEnemiga>>>();
+	TWeakObjectPtr<UShipSpawnSubsystem> CreadorDebil = Creador;
+	const int32 Oleada = Creador->IniciarOleada(
+		[Creadas](ANaveEnemiga* Nave) { Creadas->Add(Nave); },
+		[Creadas, CreadorDebil, Presupuesto, Tolerancia, PresupuestoAnterior, Naves](int32 Numero)
+		{
+			UShipSpawnSubsystem* Sub = CreadorDebil.Get();
+			if (Sub == nullptr)
+			{
+				return;
+			}
+
+			const double PeorCuadro = Sub->GetPeorCuadroOleadaMicrosegundos();
+			const double PeorNave = Sub->GetPeorNaveOleadaMicrosegundos();
+			const bool bCumple = PeorCuadro <= Presupuesto + Tolerancia;
+			UE_LOG(LogGalaga_USFX, Display, TEXT("Spawn budget test: %s, %d/%d naves, peor cuadro %.0f us, presupuesto %d + %d us, nave mas lenta %.0f us"),
+				bCumple ? TEXT("OK") : TEXT("FALLA"), Creadas->Num(), Naves, PeorCuadro, Presupuesto, Tolerancia, PeorNave);
+
+			for (const TWeakObjectPtr<ANaveEnemiga>& Nave : *Creadas)
+			{
+				if (Nave.IsValid())
+				{
+					Nave->Destroy();
+				}
+			}
+			Sub->SetPresupuestoMicrosegundos(PresupuestoAnterior);
+		});
+
+	// Lejos del juego, para no chocar con la oleada real
+	for (int32 i = 0; i < Naves; ++i)
+	{
+		const FVector Posicion(5000.0f + (i / 50) * 150.0f, -1000.0f + (i % 50) * 40.0f, 200.0f);
+		Creador->Encolar(Oleada, TEXT("EnemigaTransporte"), FTransform(Posicion));
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CmdPruebaPresupuesto(
+	TEXT("Galaga.Spawn.BudgetTest"),
+	TEXT("Galaga.Spawn.BudgetTest [Naves=200] [PresupuestoUs] [ToleranciaUs=500]: crea una oleada de prueba con presupuesto y comprueba que ningun cuadro pase del presupuesto mas la tolerancia"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&PruebaPresupuesto));
+
+bool UShipSpawnSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World != nullptr && World->IsGameWorld();
+}
+
+void UShipSpawnSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Registro = Collection.InitializeDependency<UShipRegistrySubsystem>();
+}
+
+void UShipSpawnSubsystem::Deinitialize()
+{
+	Pedidos.Reset();
+	Cabeza = 0;
+	Oleadas.Reset();
+	Registro = nullptr;
+
+	Super::Deinitialize();
+}
+
+int32 UShipSpawnSubsystem::IniciarOleada(TFunction<void(ANaveEnemiga*)> AlCrearNave, TFunction<void(int32)> AlTerminar)
+{
+	TUniquePtr<FOleada> Oleada = MakeUnique<FOleada>();
+	Oleada->Numero = SiguienteOleada++;
+	Oleada->Pendientes = 0;
+	Oleada->Creadas = 0;
+	Oleada->PrimerCuadro = GFrameCounter;
+	Oleada->Inicio = FPlatformTime::Seconds();
+	Oleada->PeorCuadro = 0.0;
+	Oleada->PeorNave = 0.0;
+	Oleada->AlCrearNave = MoveTemp(AlCrearNave);
+	Oleada->AlTerminar = MoveTemp(AlTerminar);
+
+	const int32 Numero = Oleada->Numero;
+	Oleadas.Add(MoveTemp(Oleada));
+	return Numero;
+}
+
+bool UShipSpawnSubsystem::Encolar(int32 Oleada, FName Tipo, const FTransform& Transform)
+{
+	FOleada* Grupo = BuscarOleada(Oleada);
+	if (Grupo == nullptr || Registro == nullptr || !Registro->Existe(Tipo))
+	{
+		return false;
+	}
+
+	++Grupo->Pendientes;
+	Pedidos.Add({ Oleada, Tipo, Transform });
+	return true;
+}
+
+UShipSpawnSubsystem::FOleada* UShipSpawnSubsystem::BuscarOleada(int32 Numero)
+{
+	for (const TUniquePtr<FOleada>& Oleada : Oleadas)
+	{
+		if (Oleada->Numero == Numero)
+		{
+			return Oleada.Get();
+		}
+	}
+	return nullptr;
+}
+
+void UShipSpawnSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShipSpawn_Tick);
+
+	const double Inicio = FPlatformTime::Seconds();
+	const int32 Creadas = GastarPresupuesto(Inicio + PresupuestoMicrosegundos * 1e-6,
+		[]() { return FPlatformTime::Seconds(); },
+		[this]()
+		{
+			if (Cabeza >= Pedidos.Num())
+			{
+				return false;
+			}
+
+			// Copia: los avisos pueden encolar mas pedidos y mover el arreglo
+			const FPedido Pedido = Pedidos[Cabeza++];
+			Crear(Pedido);
+			return true;
+		});
+	if (Cabeza > 0)
+	{
+		Pedidos.RemoveAt(0, Cabeza, false);
+		Cabeza = 0;
+	}
+
+	const double Cuadro = (FPlatformTime::Seconds() - Inicio) * 1e6;
+	if (Creadas > 0)
+	{
+		UltimoCuadroMicrosegundos = Cuadro;
+	}
+	TerminarOleadas(Cuadro);
+
+	INC_DWORD_STAT_BY(STAT_ShipSpawn_Creadas, Creadas);
+	SET_DWORD_STAT(STAT_ShipSpawn_Pendientes, Pedidos.Num());
+}
+
+int32 UShipSpawnSubsystem::GastarPresupuesto(double Limite, TFunctionRef<double()> Reloj, TFunctionRef<bool()> CrearSiguiente)
+{
+	int32 Creadas = 0;
+	// Al menos una por cuadro, aunque la nave sola pase del presupuesto
+	while (Creadas == 0 || Reloj() < Limite)
+	{
+		if (!CrearSiguiente())
+		{
+			break;
+		}
+		++Creadas;
+	}
+	return Creadas;
+}
+
+void UShipSpawnSubsystem::Crear(const FPedido& Pedido)
+{
+	const double Inicio = FPlatformTime::Seconds();
+
+	// El registro despierta una precalentada o la crea diferida, con el arquetipo antes de BeginPlay
+	ANaveEnemiga* Nave = Registro ? Registro->Crear(Pedido.Tipo, Pedido.Transform) : nullptr;
+
+	FOleada* Oleada = BuscarOleada(Pedido.Oleada);
+	if (Oleada)
+	{
+		--Oleada->Pendientes;
+		if (Nave)
+		{
+			++Oleada->Creadas;
+			if (Oleada->AlCrearNave)
+			{
+				Oleada->AlCrearNave(Nave);
+			}
+		}
+	}
+
+	const double Microsegundos = (FPlatformTime::Seconds() - Inicio) * 1e6;
+	PeorNaveMicrosegundos = FMath::Max(PeorNaveMicrosegundos, Microsegundos);
+	if (Oleada)
+	{
+		Oleada->PeorNave = FMath::Max(Oleada->PeorNave, Microsegundos);
+	}
+}
+
+void UShipSpawnSubsystem::TerminarOleadas(double CuadroMicrosegundos)
+{
+	for (int32 i = 0; i < Oleadas.Num(); ++i)
+	{
+		FOleada& Oleada = *Oleadas[i];
+		Oleada.PeorCuadro = FMath::Max(Oleada.PeorCuadro, CuadroMicrosegundos);
+		if (Oleada.Pendientes > 0)
+		{
+			continue;
+		}
+
+		// Se saca antes de avisar, asi el aviso puede iniciar otra oleada sin problema
+		TUniquePtr<FOleada> Terminada = MoveTemp(Oleadas[i]);
+		Oleadas.RemoveAt(i--);
+
+		PeorCuadroOleada = Terminada->PeorCuadro;
+		PeorNaveOleada = Terminada->PeorNave;
+		UE_LOG(LogGalaga_USFX, Log, TEXT("Oleada %d lista: %d naves en %llu cuadros, %.1f ms; peor cuadro %.0f us (presupuesto %d us)"),
+			Terminada->Numero, Terminada->Creadas, GFrameCounter - Terminada->PrimerCuadro + 1,
+			(FPlatformTime::Seconds() - Terminada->Inicio) * 1000.0, Terminada->PeorCuadro, PresupuestoMicrosegundos);
+		if (Terminada->AlTerminar)
+		{
+			Terminada->AlTerminar(Terminada->Numero);
+		}
+	}
+}
+
+ETickableTickType UShipSpawnSubsystem::GetTickableTickType() const
+{
+	return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UShipSpawnSubsystem::IsTickable() const
+{
+	return Pedidos.Num() > 0 || Oleadas.Num() > 0;
+}
+
+TStatId UShipSpawnSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShipSpawnSubsystem, STATGROUP_Tickables);
+}
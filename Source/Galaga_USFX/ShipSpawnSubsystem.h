@@ -0,0 +1,113 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "Templates/Function.h"
+#include "ShipSpawnSubsystem.generated.h"
+
+class ANaveEnemiga;
+class UShipRegistrySubsystem;
+
+/**
+ * Cola de creacion de naves enemigas. AShipFactory::EncolarNaveEnemiga guarda el pedido y
+ * cada cuadro se piden naves al UShipRegistrySubsystem hasta gastar
+ * PresupuestoMicrosegundos, asi una oleada de 30 naves se reparte en varios cuadros en lugar
+ * de trabar uno. Los pedidos se agrupan en oleadas que avisan cuando estan completas.
+ */
+UCLASS(config = Game)
+class GALAGA_USFX_API UShipSpawnSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+public:
+	// Empieza una oleada. AlCrearNave corre por cada nave recien creada (despues de su BeginPlay)
+	// y AlTerminar una vez cuando ya no quedan pedidos de la oleada. Devuelve su numero
+	int32 IniciarOleada(TFunction<void(ANaveEnemiga*)> AlCrearNave = nullptr, TFunction<void(int32)> AlTerminar = nullptr);
+
+	// Pide una nave de este tipo del UShipRegistrySubsystem para la oleada; se crea (o se despierta
+	// una precalentada) en este cuadro o en los siguientes. Falso si el tipo no existe
+	bool Encolar(int32 Oleada, FName Tipo, const FTransform& Transform);
+
+	FORCEINLINE int32 GetPendientes() const { return Pedidos.Num() - Cabeza; }
+	FORCEINLINE int32 GetPresupuestoMicrosegundos() const { return PresupuestoMicrosegundos; }
+	FORCEINLINE void SetPresupuestoMicrosegundos(int32 Microsegundos) { PresupuestoMicrosegundos = FMath::Max(Microsegundos, 0); }
+
+	// Lo que tardo el ultimo cuadro que creo naves y la nave mas lenta desde que empezo el nivel
+	FORCEINLINE double GetUltimoCuadroMicrosegundos() const { return UltimoCuadroMicrosegundos; }
+	FORCEINLINE double GetPeorNaveMicrosegundos() const { return PeorNaveMicrosegundos; }
+
+	// De la ultima oleada terminada: el cuadro mas largo mientras se creaba y su nave mas lenta.
+	// Con presupuesto, el cuadro no pasa del presupuesto mas una nave
+	FORCEINLINE double GetPeorCuadroOleadaMicrosegundos() const { return PeorCuadroOleada; }
+	FORCEINLINE double GetPeorNaveOleadaMicrosegundos() const { return PeorNaveOleada; }
+
+	// Reparto de un cuadro: llama a CrearSiguiente hasta que devuelva falso (no queda nada) o
+	// Reloj pase de Limite, siempre al menos una vez. Devuelve cuantas creo. Tick lo usa con
+	// FPlatformTime::Seconds; aparte para poder probarlo con un reloj falso
+	static int32 GastarPresupuesto(double Limite, TFunctionRef<double()> Reloj, TFunctionRef<bool()> CrearSiguiente);
+
+protected:
+	// Tiempo por cuadro para crear naves. Siempre se crea al menos una por cuadro para avanzar
+	UPROPERTY(Config)
+	int32 PresupuestoMicrosegundos = 1000;
+
+private:
+	struct FPedido
+	{
+		int32 Oleada;
+		FName Tipo;
+		FTransform Transform;
+	};
+
+	struct FOleada
+	{
+		int32 Numero;
+		int32 Pendientes;
+		int32 Creadas;
+		uint64 PrimerCuadro;
+		double Inicio;
+		double PeorCuadro;
+		double PeorNave;
+		TFunction<void(ANaveEnemiga*)> AlCrearNave;
+		TFunction<void(int32)> AlTerminar;
+	};
+
+	// Crea la nave del pedido y avisa a su oleada
+	void Crear(const FPedido& Pedido);
+
+	// Avisa y quita las oleadas sin pedidos; CuadroMicrosegundos es lo que tardo este cuadro
+	void TerminarOleadas(double CuadroMicrosegundos);
+
+	FOleada* BuscarOleada(int32 Numero);
+
+	// Los pedidos sin atender van de Cabeza al final
+	TArray<FPedido> Pedidos;
+	int32 Cabeza = 0;
+
+	// Por puntero: los avisos de una oleada pueden iniciar otra
+	TArray<TUniquePtr<FOleada>> Oleadas;
+	int32 SiguienteOleada = 1;
+
+	double UltimoCuadroMicrosegundos = 0.0;
+	double PeorNaveMicrosegundos = 0.0;
+	double PeorCuadroOleada = 0.0;
+	double PeorNaveOleada = 0.0;
+
+	UPROPERTY()
+	UShipRegistrySubsystem* Registro;
+};
@@ -0,0 +1,220 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SpatialGrid.h"
+
+void FSpatialGrid::Configurar(float InLimite, float InTamanoCelda)
+{
+	Limite = InLimite;
+	TamanoCelda = FMath::Max(InTamanoCelda, 1.0f);
+	InvTamanoCelda = 1.0f / TamanoCelda;
+	Lado = FMath::Max(FMath::CeilToInt(2.0f * Limite * InvTamanoCelda), 1);
+}
+
+void FSpatialGrid::Construir(const TArray<FVector>& InPosiciones)
+{
+	// Reset + Append conserva la memoria reservada de cuadros anteriores
+	Posiciones.Reset();
+	Posiciones.Append(InPosiciones);
+
+	const int32 Num = Posiciones.Num();
+	const int32 NumCeldas = Lado * Lado;
+
+	Inicio.Reset();
+	Inicio.SetNumZeroed(NumCeldas + 1);
+	CeldaDe.SetNumUninitialized(Num, false);
+	Orden.SetNumUninitialized(Num, false);
+
+	// Cuenta por celda en Inicio[c + 1] y suma prefija: Inicio[c] queda en el comienzo de c
+	for (int32 i = 0; i < Num; ++i)
+	{
+		const int32 C = Celda(Posiciones[i].X) + Celda(Posiciones[i].Y) * Lado;
+		CeldaDe[i] = C;
+		++Inicio[C + 1];
+	}
+	for (int32 C = 1; C <= NumCeldas; ++C)
+	{
+		Inicio[C] += Inicio[C - 1];
+	}
+
+	// Inicio[c] sirve de cursor; al terminar apunta al comienzo de c + 1 y se corre uno
+	for (int32 i = 0; i < Num; ++i)
+	{
+		Orden[Inicio[CeldaDe[i]]++] = i;
+	}
+	for (int32 C = NumCeldas - 1; C > 0; --C)
+	{
+		Inicio[C] = Inicio[C - 1];
+	}
+	Inicio[0] = 0;
+}
+
+int32 FSpatialGrid::BuscarMasCercano(const FVector& P, float RadioMax, const TArray<uint8>& Equipos, uint8 EquipoExcluido) const
+{
+	if (Posiciones.Num() == 0)
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 CX = Celda(P.X);
+	const int32 CY = Celda(P.Y);
+	const int32 MaxAnillo = FMath::Min(FMath::CeilToInt(RadioMax * InvTamanoCelda) + 1, Lado);
+
+	int32 Mejor = INDEX_NONE;
+	float MejorDistancia = RadioMax * RadioMax;
+
+	for (int32 Anillo = 0; Anillo <= MaxAnillo; ++Anillo)
+	{
+		// Nada en este anillo puede estar mas cerca que (Anillo - 1) celdas
+		if (Anillo > 0)
+		{
+			const float Minima = (Anillo - 1) * TamanoCelda;
+			if (Minima * Minima > MejorDistancia)
+			{
+				break;
+			}
+		}
+
+		for (int32 Y = CY - Anillo; Y <= CY + Anillo; ++Y)
+		{
+			if (Y < 0 || Y >= Lado)
+			{
+				continue;
+			}
+
+			// En las filas del medio solo cuentan las dos celdas del borde del anillo
+			const bool bFilaBorde = Y == CY - Anillo || Y == CY + Anillo;
+			const int32 Paso = (bFilaBorde || Anillo == 0) ? 1 : 2 * Anillo;
+			for (int32 X = CX - Anillo; X <= CX + Anillo; X += Paso)
+			{
+				if (X < 0 || X >= Lado)
+				{
+					continue;
+				}
+
+				const int32 C = X + Y * Lado;
+				for (int32 k = Inicio[C]; k < Inicio[C + 1]; ++k)
+				{
+					const int32 Indice = Orden[k];
+					if (Equipos[Indice] == EquipoExcluido)
+					{
+						continue;
+					}
+
+					const float Distancia = FVector::DistSquared(P, Posiciones[Indice]);
+					if (Distancia < MejorDistancia)
+					{
+						MejorDistancia = Distancia;
+						Mejor = Indice;
+					}
+				}
+			}
+		}
+	}
+	return Mejor;
+}
+
+void FSpatialGrid::BuscarMasCercanos(const TArray<FVector>& Consultas, const TArray<uint8>& EquiposConsulta, float RadioMax,
+	const TArray<uint8>& Equipos, TArray<int32>& OutIndices) const
+{
+	OutIndices.SetNumUninitialized(Consultas.Num(), false);
+	for (int32 i = 0; i < Consultas.Num(); ++i)
+	{
+		// El equipo de la consulta se excluye: una bala busca al equipo contrario
+		OutIndices[i] = BuscarMasCercano(Consultas[i], RadioMax, Equipos, EquiposConsulta[i]);
+	}
+}
+
+void FSpatialGrid::BuscarEnRadio(const FVector& P, float Radio, TArray<int32>& OutIndices) const
+{
+	if (Posiciones.Num() == 0)
+	{
+		return;
+	}
+
+	const float Radio2 = Radio * Radio;
+	const int32 X0 = Celda(P.X - Radio);
+	const int32 X1 = Celda(P.X + Radio);
+	const int32 Y0 = Celda(P.Y - Radio);
+	const int32 Y1 = Celda(P.Y + Radio);
+
+	for (int32 Y = Y0; Y <= Y1; ++Y)
+	{
+		for (int32 X = X0; X <= X1; ++X)
+		{
+			const int32 C = X + Y * Lado;
+			for (int32 k = Inicio[C]; k < Inicio[C + 1]; ++k)
+			{
+				const int32 Indice = Orden[k];
+				if (FVector::DistSquared(P, Posiciones[Indice]) <= Radio2)
+				{
+					OutIndices.Add(Indice);
+				}
+			}
+		}
+	}
+}
+
+void FSpatialGrid::BuscarEnSegmento(const FVector& A, const FVector& B, float Margen, TArray<int32>& OutIndices) const
+{
+	if (Posiciones.Num() == 0)
+	{
+		return;
+	}
+
+	const FVector2D Inicio2D(A.X, A.Y);
+	const FVector2D Delta(B.X - A.X, B.Y - A.Y);
+	const float Largo2 = Delta.SizeSquared();
+	const float Margen2 = Margen * Margen;
+
+	const int32 Y0 = Celda(FMath::Min(A.Y, B.Y) - Margen);
+	const int32 Y1 = Celda(FMath::Max(A.Y, B.Y) + Margen);
+	for (int32 Y = Y0; Y <= Y1; ++Y)
+	{
+		// Franja de la fila ensanchada por el margen; las filas del borde tambien tienen los puntos de afuera
+		const float FranjaMin = Y == 0 ? -BIG_NUMBER : -Limite + Y * TamanoCelda - Margen;
+		const float FranjaMax = Y == Lado - 1 ? BIG_NUMBER : -Limite + (Y + 1) * TamanoCelda + Margen;
+
+		// Tramo del segmento dentro de la franja
+		float T0 = 0.0f;
+		float T1 = 1.0f;
+		if (FMath::Abs(Delta.Y) > KINDA_SMALL_NUMBER)
+		{
+			T0 = (FranjaMin - A.Y) / Delta.Y;
+			T1 = (FranjaMax - A.Y) / Delta.Y;
+			if (T0 > T1)
+			{
+				Swap(T0, T1);
+			}
+			T0 = FMath::Max(T0, 0.0f);
+			T1 = FMath::Min(T1, 1.0f);
+			if (T0 > T1)
+			{
+				continue;
+			}
+		}
+		else if (A.Y < FranjaMin || A.Y > FranjaMax)
+		{
+			continue;
+		}
+
+		const float XA = A.X + Delta.X * T0;
+		const float XB = A.X + Delta.X * T1;
+		const int32 X0 = Celda(FMath::Min(XA, XB) - Margen);
+		const int32 X1 = Celda(FMath::Max(XA, XB) + Margen);
+		for (int32 X = X0; X <= X1; ++X)
+		{
+			const int32 C = X + Y * Lado;
+			for (int32 k = Inicio[C]; k < Inicio[C + 1]; ++k)
+			{
+				const int32 Indice = Orden[k];
+				const FVector2D Relativa = FVector2D(Posiciones[Indice].X, Posiciones[Indice].Y) - Inicio2D;
+				const float T = Largo2 > 0.0f ? FMath::Clamp((Relativa | Delta) / Largo2, 0.0f, 1.0f) : 0.0f;
+				if ((Relativa - Delta * T).SizeSquared() <= Margen2)
+				{
+					OutIndices.Add(Indice);
+				}
+			}
+		}
+	}
+}
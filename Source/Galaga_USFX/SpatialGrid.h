@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Rejilla uniforme en XY sobre el area de juego para buscar objetivos cerca de muchas
+ * balas a la vez. Se reconstruye cada cuadro con un counting sort: los puntos quedan
+ * ordenados por celda en Orden y Inicio[c]..Inicio[c+1] es el rango de la celda c.
+ * Despues del primer cuadro no reserva memoria.
+ */
+struct GALAGA_USFX_API FSpatialGrid
+{
+	// Los puntos fuera de [-Limite, Limite] caen en las celdas del borde
+	void Configurar(float InLimite, float InTamanoCelda);
+
+	void Construir(const TArray<FVector>& InPosiciones);
+
+	// Indice del punto mas cercano a P dentro de RadioMax cuyo equipo no sea EquipoExcluido, o INDEX_NONE
+	int32 BuscarMasCercano(const FVector& P, float RadioMax, const TArray<uint8>& Equipos, uint8 EquipoExcluido) const;
+
+	// Una consulta por elemento de Consultas; OutIndices queda del mismo largo
+	void BuscarMasCercanos(const TArray<FVector>& Consultas, const TArray<uint8>& EquiposConsulta, float RadioMax,
+		const TArray<uint8>& Equipos, TArray<int32>& OutIndices) const;
+
+	// Agrega a OutIndices los puntos a distancia <= Radio de P (no vacia OutIndices)
+	void BuscarEnRadio(const FVector& P, float Radio, TArray<int32>& OutIndices) const;
+
+	// Agrega a OutIndices los puntos a distancia <= Margen (en XY) del segmento A-B, recorriendo
+	// solo las celdas que toca el segmento fila por fila (no vacia OutIndices)
+	void BuscarEnSegmento(const FVector& A, const FVector& B, float Margen, TArray<int32>& OutIndices) const;
+
+	FORCEINLINE int32 Num() const { return Posiciones.Num(); }
+	FORCEINLINE const FVector& GetPosicion(int32 Indice) const { return Posiciones[Indice]; }
+	FORCEINLINE const TArray<FVector>& GetPosiciones() const { return Posiciones; }
+
+private:
+	FORCEINLINE int32 Celda(float Valor) const
+	{
+		return FMath::Clamp(FMath::FloorToInt((Valor + Limite) * InvTamanoCelda), 0, Lado - 1);
+	}
+
+	float Limite = 1600.0f;
+	float TamanoCelda = 200.0f;
+	float InvTamanoCelda = 1.0f / 200.0f;
+	int32 Lado = 16;
+
+	TArray<FVector> Posiciones;
+	TArray<int32> Orden;
+	TArray<int32> Inicio;
+	TArray<int32> CeldaDe;
+};
@@ -3,6 +3,7 @@
 
 #include "StatePotenciado.h"
 #include "Galaga_USFXPawn.h"
+#include "BulletFieldSubsystem.h"
 
 // Sets default values
 AStatePotenciado::AStatePotenciado()
@@ -43,6 +44,12 @@ void AStatePotenciado::EstadoPotenciado()
 	NavePawn->SetVelocity(4000.0f);
 	NavePawn->FireRate *= -2;
 
+	// Mientras dura el potenciador los disparos del jugador tambien destruyen balas enemigas
+	if (UBulletFieldSubsystem* Campo = GetWorld()->GetSubsystem<UBulletFieldSubsystem>())
+	{
+		Campo->ActivarCancelacion(Duracion);
+	}
+
 }
 
 
@@ -6,7 +6,7 @@
 #include "StateInterface.h"
 #include "StatePotenciado.generated.h"
 
-UCLASS()
+UCLASS(config = Game)
 class GALAGA_USFX_API AStatePotenciado : public APawn, public IStateInterface
 {
 	GENERATED_BODY()
@@ -30,6 +30,10 @@ public:
 	//UPROPERTY(VisibleAnywhere, Category = "Estado Energia llena")
 	class AGalaga_USFXPawn* NavePawn;
 
+	// Segundos que dura el estado; mientras tanto las balas del jugador cancelan balas enemigas
+	UPROPERTY(EditAnywhere, Config, Category = "Estado Potenciado")
+	float Duracion = 10.0f;
+
 private:
 	virtual void EstadoSigiloso() override;
 	virtual void EstadoProtegido() override {};
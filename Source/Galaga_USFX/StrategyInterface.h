@@ -23,5 +23,6 @@ class GALAGA_USFX_API IStrategyInterface
 	// Add interface functions to this class. This is the class that will be inherited to implement this interface.
 public:
 
-	virtual void Movement(class ANaveEnemiga* enemy)=0;
+	// DeltaTime es el de la nave: si se actualiza cada 2 o 4 cuadros trae el tiempo de todos ellos
+	virtual void Movement(class ANaveEnemiga* enemy, float DeltaTime)=0;
 };
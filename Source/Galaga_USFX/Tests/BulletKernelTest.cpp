@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BulletKernel.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Balas dentro del area, otras que vencen en el cuadro y otras que salen por un borde. El largo
+// no es multiplo de 4 ni de 8 para que los kernels anchos pasen tambien por el resto escalar
+static void LlenarBalas(FBulletSoA& Balas, int32 Cantidad)
+{
+	FRandomStream Azar(4321);
+	const float Limite = FBulletKernel::LimiteCampo;
+	for (int32 i = 0; i < Cantidad; ++i)
+	{
+		FVector Posicion(Azar.FRandRange(-Limite + 100.0f, Limite - 100.0f), Azar.FRandRange(-Limite + 100.0f, Limite - 100.0f), 200.0f);
+		FVector Velocidad(Azar.FRandRange(-1000.0f, 1000.0f), Azar.FRandRange(-1000.0f, 1000.0f), 0.0f);
+		float Vida = Azar.FRandRange(0.5f, 3.0f);
+		if (i % 5 == 0)
+		{
+			Vida = 0.001f;
+		}
+		else if (i % 7 == 0)
+		{
+			Posicion.X = Limite - 1.0f;
+			Velocidad.X = 3000.0f;
+		}
+		Balas.Add(Posicion, Velocidad, Vida, (uint8)(i % 3), (uint8)(i % 2));
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBulletKernelIntegrarTest, "Galaga.BulletKernel.IntegrarCompactar",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FBulletKernelIntegrarTest::RunTest(const FString& Parameters)
+{
+	const float DeltaTime = 1.0f / 60.0f;
+	FBulletSoA Original;
+	LlenarBalas(Original, 203);
+
+	// Resultado esperado, bala por bala y en el mismo orden
+	TArray<int32> Vivas;
+	for (int32 i = 0; i < Original.Num(); ++i)
+	{
+		const FVector Posicion = Original.GetPosicion(i) + Original.GetVelocidad(i) * DeltaTime;
+		const bool bDentro = FMath::Abs(Posicion.X) <= FBulletKernel::LimiteCampo && FMath::Abs(Posicion.Y) <= FBulletKernel::LimiteCampo;
+		if (Original.Vida[i] - DeltaTime > 0.0f && bDentro)
+		{
+			Vivas.Add(i);
+		}
+	}
+
+	for (int32 Ruta = 0; Ruta < (int32)EBulletKernelPath::MAX; ++Ruta)
+	{
+		const EBulletKernelPath Camino = (EBulletKernelPath)Ruta;
+		if (!FBulletKernel::EsRutaSoportada(Camino))
+		{
+			continue;
+		}
+
+		FBulletSoA Balas = Original;
+		const int32 Quitadas = FBulletKernel::Integrar(Balas, DeltaTime, Camino);
+		const FString Nombre = FBulletKernel::GetNombreRuta(Camino);
+
+		TestEqual(Nombre + TEXT(": quitadas"), Quitadas, Original.Num() - Vivas.Num());
+		if (!TestEqual(Nombre + TEXT(": vivas"), Balas.Num(), Vivas.Num()))
+		{
+			continue;
+		}
+
+		for (int32 i = 0; i < Vivas.Num(); ++i)
+		{
+			const int32 Antes = Vivas[i];
+			const FVector Esperada = Original.GetPosicion(Antes) + Original.GetVelocidad(Antes) * DeltaTime;
+			TestTrue(FString::Printf(TEXT("%s: posicion de la bala %d"), *Nombre, Antes), Balas.GetPosicion(i).Equals(Esperada, 0.01f));
+			TestTrue(FString::Printf(TEXT("%s: velocidad de la bala %d"), *Nombre, Antes), Balas.GetVelocidad(i).Equals(Original.GetVelocidad(Antes), 0.0f));
+			TestEqual(FString::Printf(TEXT("%s: vida de la bala %d"), *Nombre, Antes), Balas.Vida[i], Original.Vida[Antes] - DeltaTime, 1e-5f);
+			TestEqual(FString::Printf(TEXT("%s: tipo de la bala %d"), *Nombre, Antes), Balas.Tipo[i], Original.Tipo[Antes]);
+			TestEqual(FString::Printf(TEXT("%s: dueno de la bala %d"), *Nombre, Antes), Balas.Dueno[i], Original.Dueno[Antes]);
+		}
+	}
+	return true;
+}
+
+#endif
@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BulletFieldSubsystem.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBulletTiempoDeImpactoTest, "Galaga.BulletField.TiempoDeImpacto",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FBulletTiempoDeImpactoTest::RunTest(const FString& Parameters)
+{
+	// De frente: entra al radio 10 a los 90 de 200 uu
+	TestEqual(TEXT("de frente"), UBulletFieldSubsystem::TiempoDeImpacto(FVector(-100.0f, 0.0f, 0.0f), FVector(100.0f, 0.0f, 0.0f), 10.0f), 0.45f, 1e-4f);
+
+	// Cruza en diagonal: |(-100 + 200t, -100 + 200t)| = 10
+	const float Diagonal = (100.0f - 10.0f / FMath::Sqrt(2.0f)) / 200.0f;
+	TestEqual(TEXT("en diagonal"), UBulletFieldSubsystem::TiempoDeImpacto(FVector(-100.0f, -100.0f, 0.0f), FVector(100.0f, 100.0f, 0.0f), 10.0f), Diagonal, 1e-4f);
+
+	TestEqual(TEXT("empieza adentro"), UBulletFieldSubsystem::TiempoDeImpacto(FVector(5.0f, 0.0f, 0.0f), FVector(100.0f, 0.0f, 0.0f), 10.0f), 0.0f);
+	TestEqual(TEXT("pasa de lado"), UBulletFieldSubsystem::TiempoDeImpacto(FVector(-100.0f, 50.0f, 0.0f), FVector(100.0f, 50.0f, 0.0f), 10.0f), -1.0f);
+	TestEqual(TEXT("se aleja"), UBulletFieldSubsystem::TiempoDeImpacto(FVector(20.0f, 0.0f, 0.0f), FVector(100.0f, 0.0f, 0.0f), 10.0f), -1.0f);
+	TestEqual(TEXT("no llega"), UBulletFieldSubsystem::TiempoDeImpacto(FVector(-100.0f, 0.0f, 0.0f), FVector(-50.0f, 0.0f, 0.0f), 10.0f), -1.0f);
+	TestEqual(TEXT("quieto afuera"), UBulletFieldSubsystem::TiempoDeImpacto(FVector(-100.0f, 0.0f, 0.0f), FVector(-100.0f, 0.0f, 0.0f), 10.0f), -1.0f);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBulletBarridoTest, "Galaga.BulletField.Barrido",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FBulletBarridoTest::RunTest(const FString& Parameters)
+{
+	// Una bala del jugador a 3000 uu/s en un cuadro de 10 FPS: avanza 300 uu, de X=1000 a X=700
+	const float DeltaTime = 0.1f;
+	const float RadioBala = 10.0f;
+	FBulletSoA Bala;
+	Bala.Add(FVector(700.0f, 0.0f, 200.0f), FVector(-3000.0f, 0.0f, 0.0f), 2.0f, 0, (uint8)EBulletOwner::Jugador);
+
+	// Un objetivo quieto a mitad de camino: el final del cuadro ya lo paso
+	TArray<FVector> Posiciones = { FVector(850.0f, 0.0f, 200.0f) };
+	TArray<FVector> Anteriores = Posiciones;
+	TArray<float> Radios = { 60.0f };
+	TArray<uint8> Equipos = { (uint8)EBulletOwner::Enemigo };
+	TArray<FIntPoint> Impactos;
+
+	UBulletFieldSubsystem::BuscarImpactos(Bala, &RadioBala, Posiciones, Anteriores, Radios, Equipos, DeltaTime, BIG_NUMBER, Impactos);
+	TestEqual(TEXT("sin barrido la bala atraviesa"), Impactos.Num(), 0);
+
+	UBulletFieldSubsystem::BuscarImpactos(Bala, &RadioBala, Posiciones, Anteriores, Radios, Equipos, DeltaTime, 0.0f, Impactos);
+	if (TestEqual(TEXT("con barrido hay impacto"), Impactos.Num(), 1))
+	{
+		TestTrue(TEXT("impacto de la bala 0 contra el objetivo 0"), Impactos[0] == FIntPoint(0, 0));
+	}
+
+	// El objetivo cruza el camino dentro del cuadro: al principio y al final queda lejos de la bala
+	Anteriores[0] = FVector(850.0f, -400.0f, 200.0f);
+	Posiciones[0] = FVector(850.0f, 400.0f, 200.0f);
+	UBulletFieldSubsystem::BuscarImpactos(Bala, &RadioBala, Posiciones, Anteriores, Radios, Equipos, DeltaTime, 0.0f, Impactos);
+	TestEqual(TEXT("objetivo que cruza"), Impactos.Num(), 1);
+
+	// Con dos objetivos en el camino gana el primero que se toca, no el primero de la lista
+	Posiciones = { FVector(760.0f, 0.0f, 200.0f), FVector(920.0f, 0.0f, 200.0f) };
+	Anteriores = Posiciones;
+	Radios = { 60.0f, 60.0f };
+	Equipos = { (uint8)EBulletOwner::Enemigo, (uint8)EBulletOwner::Enemigo };
+	UBulletFieldSubsystem::BuscarImpactos(Bala, &RadioBala, Posiciones, Anteriores, Radios, Equipos, DeltaTime, 0.0f, Impactos);
+	if (TestEqual(TEXT("un solo impacto por bala"), Impactos.Num(), 1))
+	{
+		TestEqual(TEXT("el objetivo mas cercano al origen"), Impactos[0].Y, 1);
+	}
+
+	// Las balas no chocan con su propio equipo
+	Equipos = { (uint8)EBulletOwner::Jugador, (uint8)EBulletOwner::Jugador };
+	UBulletFieldSubsystem::BuscarImpactos(Bala, &RadioBala, Posiciones, Anteriores, Radios, Equipos, DeltaTime, 0.0f, Impactos);
+	TestEqual(TEXT("mismo equipo"), Impactos.Num(), 0);
+	return true;
+}
+
+#endif
@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "EnemyKernel.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// El paso de la formacion (AvanzarFormacion + Calcular) serial contra ParallelFor, que deben dar
+// los mismos bits, y contra el Tick de cada nave (MoverRecto + AvanzarDisparo), que debe dar los
+// mismos disparos y la posicion dentro de Tolerancia porque suma el desplazamiento en otro orden
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEnemyKernelDeterminismoTest, "Galaga.EnemyKernel.Determinismo",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FEnemyKernelDeterminismoTest::RunTest(const FString& Parameters)
+{
+	// Varios lotes de ParallelFor y el ultimo incompleto
+	const int32 Naves = 1000;
+	const int32 Cuadros = 300;
+	const float LimiteY = 1000.0f;
+	const float VelocidadY = 400.0f;
+	const float Tolerancia = 0.1f;
+
+	FRandomStream Azar(1234);
+	TArray<FEnemyEstado> Estados;
+	TArray<FVector> Posiciones;
+	TArray<float> Temporizadores;
+	for (int32 i = 0; i < Naves; ++i)
+	{
+		FEnemyEstado& Estado = Estados.AddDefaulted_GetRef();
+		Estado.Offset = FVector(Azar.FRandRange(-400.0f, 600.0f), Azar.FRandRange(-1000.0f, 1000.0f), 200.0f);
+		Estado.Temporizador = Azar.FRandRange(0.0f, 1.0f);
+		Estado.Intervalo = (float)Azar.RandRange(0, 3);
+
+		// Cada nave por su cuenta empieza en su lugar de la formacion, con el origen en cero
+		Posiciones.Add(Estado.Offset);
+		Temporizadores.Add(Estado.Temporizador);
+	}
+	TArray<FEnemyEstado> EstadosParalelo = Estados;
+
+	TArray<FEnemyResultado> ResultadoSerial;
+	TArray<FEnemyResultado> ResultadoParalelo;
+	FVector Desplazamiento = FVector::ZeroVector;
+	int32 Diferencias = 0;
+	int32 DisparosDistintos = 0;
+	int32 Disparos = 0;
+	float MaxError = 0.0f;
+	for (int32 Cuadro = 0; Cuadro < Cuadros; ++Cuadro)
+	{
+		// Cuadros irregulares como en juego
+		const float DeltaTime = Azar.FRandRange(1.0f / 120.0f, 1.0f / 20.0f);
+
+		FEnemyKernel::AvanzarFormacion(Desplazamiento, VelocidadY, DeltaTime, LimiteY);
+		FEnemyKernel::Calcular(Estados, Desplazamiento, LimiteY, DeltaTime, ResultadoSerial, false);
+		FEnemyKernel::Calcular(EstadosParalelo, Desplazamiento, LimiteY, DeltaTime, ResultadoParalelo, true);
+
+		for (int32 i = 0; i < Naves; ++i)
+		{
+			const FEnemyResultado& A = ResultadoSerial[i];
+			const FEnemyResultado& B = ResultadoParalelo[i];
+			if (FMemory::Memcmp(&A.Posicion, &B.Posicion, sizeof(FVector)) != 0
+				|| FMemory::Memcmp(&A.Temporizador, &B.Temporizador, sizeof(float)) != 0
+				|| A.bDispara != B.bDispara)
+			{
+				++Diferencias;
+			}
+			Disparos += A.bDispara;
+
+			// Cada lado sigue con su propio resultado, asi una diferencia se arrastra y se nota
+			Estados[i].Temporizador = A.Temporizador;
+			EstadosParalelo[i].Temporizador = B.Temporizador;
+
+			Posiciones[i] = FEnemyKernel::MoverRecto(Posiciones[i], VelocidadY, DeltaTime, LimiteY);
+			DisparosDistintos += FEnemyKernel::AvanzarDisparo(Temporizadores[i], Estados[i].Intervalo, DeltaTime) != A.bDispara;
+
+			// Una nave justo en el limite puede estar en +LimiteY en un lado y en -LimiteY en el otro
+			const float ErrorY = FMath::Abs(FEnemyKernel::Envolver(A.Posicion.Y - Posiciones[i].Y, LimiteY));
+			MaxError = FMath::Max(MaxError, FMath::Max3(ErrorY, FMath::Abs(A.Posicion.X - Posiciones[i].X), FMath::Abs(A.Posicion.Z - Posiciones[i].Z)));
+		}
+	}
+
+	TestTrue(TEXT("hubo disparos"), Disparos > 0);
+	TestEqual(TEXT("serial y paralelo dan los mismos bits"), Diferencias, 0);
+	TestEqual(TEXT("formacion y Tick por nave disparan igual"), DisparosDistintos, 0);
+	TestTrue(FString::Printf(TEXT("formacion y Tick por nave dentro de %.2f uu (error maximo %.4f)"), Tolerancia, MaxError), MaxError <= Tolerancia);
+	return true;
+}
+
+#endif
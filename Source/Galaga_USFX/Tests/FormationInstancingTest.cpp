@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FormationManager.h"
+#include "NaveEnemigaTransporte.h"
+#include "Misc/AutomationTest.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFormationPrimitivasTest, "Galaga.Formation.Primitivas",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FFormationPrimitivasTest::RunTest(const FString& Parameters)
+{
+	IConsoleVariable* Instancias = IConsoleManager::Get().FindConsoleVariable(TEXT("Galaga.Formation.Instancias"));
+	if (!TestNotNull(TEXT("variable Galaga.Formation.Instancias"), Instancias))
+	{
+		return false;
+	}
+	const int32 Anterior = Instancias->GetInt();
+
+	// Un mundo de juego vacio, solo con la formacion y sus naves
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& Contexto = GEngine->CreateNewWorldContext(EWorldType::Game);
+	Contexto.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+
+	AFormationManager* Formacion = World->SpawnActor<AFormationManager>();
+	Formacion->IntervaloPicadas = 0.0f;
+
+	// Todas con la misma malla: con instancias alcanza un solo componente
+	const int32 NumNaves = 24;
+	TArray<ANaveEnemiga*> Naves;
+	for (int32 i = 0; i < NumNaves; ++i)
+	{
+		ANaveEnemiga* Nave = World->SpawnActor<ANaveEnemigaTransporte>(FVector(1000.0f, -960.0f + i * 80.0f, 200.0f), FRotator::ZeroRotator);
+		Formacion->AgregarNave(Nave);
+		Naves.Add(Nave);
+	}
+
+	const float DeltaTime = 1.0f / 60.0f;
+	Instancias->Set(0, ECVF_SetByCode);
+	Formacion->Tick(DeltaTime);
+	const int32 SinInstancias = Formacion->ContarPrimitivas();
+
+	Instancias->Set(1, ECVF_SetByCode);
+	Formacion->Tick(DeltaTime);
+	const int32 ConInstancias = Formacion->ContarPrimitivas();
+
+	TestEqual(TEXT("sin instancias una primitiva por nave"), SinInstancias, NumNaves);
+	TestEqual(TEXT("con instancias una primitiva por malla"), ConInstancias, 1);
+	TestTrue(TEXT("las instancias bajan las primitivas"), ConInstancias < SinInstancias);
+
+	// Un golpe que no la mata saca a la nave de la instancia y la dibuja con su malla
+	Naves[0]->TakeDamage(Naves[0]->GetResistencia() * 0.5f, FDamageEvent(), nullptr, nullptr);
+	Formacion->Tick(DeltaTime);
+	TestEqual(TEXT("nave golpeada con su propia malla"), Formacion->ContarPrimitivas(), 2);
+	TestEqual(TEXT("las demas siguen instanciadas"), Formacion->GetNumInstancias(), NumNaves - 1);
+
+	Instancias->Set(Anterior, ECVF_SetByCode);
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif
@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShipSpawnSubsystem.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Reparte Costos (microsegundos por nave) en cuadros con un reloj falso. Falla si un cuadro pasa
+// del presupuesto mas la tolerancia, si no crea ninguna, o si corta antes de gastar el presupuesto
+static bool RepartirOleada(FAutomationTestBase& Prueba, const FString& Caso, const TArray<double>& Costos, double PresupuestoUs,
+	double ToleranciaUs, int32& OutCuadros)
+{
+	double Ahora = 0.0;
+	int32 Siguiente = 0;
+	OutCuadros = 0;
+	while (Siguiente < Costos.Num())
+	{
+		const double Inicio = Ahora;
+		const int32 Creadas = UShipSpawnSubsystem::GastarPresupuesto(Inicio + PresupuestoUs * 1e-6,
+			[&Ahora]() { return Ahora; },
+			[&Ahora, &Siguiente, &Costos]()
+			{
+				if (Siguiente >= Costos.Num())
+				{
+					return false;
+				}
+				Ahora += Costos[Siguiente++] * 1e-6;
+				return true;
+			});
+		++OutCuadros;
+
+		const double CuadroUs = (Ahora - Inicio) * 1e6;
+		if (!Prueba.TestTrue(FString::Printf(TEXT("%s: cuadro %d crea al menos una"), *Caso, OutCuadros), Creadas > 0)
+			|| !Prueba.TestTrue(FString::Printf(TEXT("%s: cuadro %d de %.0f us dentro de %.0f + %.0f us"), *Caso, OutCuadros, CuadroUs, PresupuestoUs, ToleranciaUs),
+				CuadroUs <= PresupuestoUs + ToleranciaUs + 1e-3)
+			|| !Prueba.TestTrue(FString::Printf(TEXT("%s: cuadro %d no corta antes del presupuesto"), *Caso, OutCuadros),
+				Siguiente == Costos.Num() || CuadroUs >= PresupuestoUs - 1e-3))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShipSpawnPresupuestoTest, "Galaga.Spawn.Presupuesto",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShipSpawnPresupuestoTest::RunTest(const FString& Parameters)
+{
+	int32 Cuadros = 0;
+
+	// Naves de 300 us con 1000 us de presupuesto: 4 por cuadro, la ultima empieza antes del limite
+	TArray<double> Costos;
+	Costos.Init(300.0, 100);
+	if (RepartirOleada(*this, TEXT("naves iguales"), Costos, 1000.0, 300.0, Cuadros))
+	{
+		TestEqual(TEXT("naves iguales: cuadros"), Cuadros, 25);
+	}
+
+	// Una nave mas cara que el presupuesto igual avanza, de a una por cuadro
+	Costos.Init(5000.0, 10);
+	if (RepartirOleada(*this, TEXT("naves caras"), Costos, 1000.0, 5000.0, Cuadros))
+	{
+		TestEqual(TEXT("naves caras: cuadros"), Cuadros, 10);
+	}
+
+	// Sin presupuesto tambien una por cuadro
+	Costos.Init(100.0, 10);
+	if (RepartirOleada(*this, TEXT("presupuesto cero"), Costos, 0.0, 100.0, Cuadros))
+	{
+		TestEqual(TEXT("presupuesto cero: cuadros"), Cuadros, 10);
+	}
+
+	// Costos al azar: el cuadro nunca pasa del presupuesto mas la nave mas cara posible
+	FRandomStream Azar(1234);
+	Costos.Reset();
+	for (int32 i = 0; i < 500; ++i)
+	{
+		Costos.Add(Azar.FRandRange(50.0f, 400.0f));
+	}
+	RepartirOleada(*this, TEXT("costos al azar"), Costos, 1000.0, 400.0, Cuadros);
+
+	// Sin pedidos no crea nada
+	const int32 Vacio = UShipSpawnSubsystem::GastarPresupuesto(1.0, []() { return 0.0; }, []() { return false; });
+	TestEqual(TEXT("sin pedidos"), Vacio, 0);
+	return true;
+}
+
+#endif
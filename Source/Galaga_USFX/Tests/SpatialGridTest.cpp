@@ -0,0 +1,147 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SpatialGrid.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Puntos en todo el area y algunos afuera (caen en las celdas del borde), de dos equipos
+static void LlenarPuntos(TArray<FVector>& Puntos, TArray<uint8>& Equipos, int32 Cantidad, FRandomStream& Azar)
+{
+	for (int32 i = 0; i < Cantidad; ++i)
+	{
+		Puntos.Add(FVector(Azar.FRandRange(-2000.0f, 2000.0f), Azar.FRandRange(-2000.0f, 2000.0f), 200.0f));
+		Equipos.Add((uint8)Azar.RandHelper(2));
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpatialGridMasCercanoTest, "Galaga.SpatialGrid.MasCercano",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FSpatialGridMasCercanoTest::RunTest(const FString& Parameters)
+{
+	FRandomStream Azar(1234);
+	TArray<FVector> Puntos;
+	TArray<uint8> Equipos;
+	LlenarPuntos(Puntos, Equipos, 300, Azar);
+
+	FSpatialGrid Rejilla;
+	Rejilla.Configurar(1600.0f, 200.0f);
+	Rejilla.Construir(Puntos);
+
+	TArray<FVector> Consultas;
+	TArray<uint8> EquiposConsulta;
+	for (int32 i = 0; i < 200; ++i)
+	{
+		Consultas.Add(FVector(Azar.FRandRange(-1600.0f, 1600.0f), Azar.FRandRange(-1600.0f, 1600.0f), 200.0f));
+		EquiposConsulta.Add((uint8)Azar.RandHelper(2));
+	}
+
+	const float RadioMax = 800.0f;
+	TArray<int32> Resultados;
+	Rejilla.BuscarMasCercanos(Consultas, EquiposConsulta, RadioMax, Equipos, Resultados);
+	if (!TestEqual(TEXT("un resultado por consulta"), Resultados.Num(), Consultas.Num()))
+	{
+		return false;
+	}
+
+	// Contra recorrer todos los puntos; con distancias iguales puede elegir otro indice
+	for (int32 i = 0; i < Consultas.Num(); ++i)
+	{
+		int32 Esperado = INDEX_NONE;
+		float MejorDistancia = RadioMax * RadioMax;
+		for (int32 Punto = 0; Punto < Puntos.Num(); ++Punto)
+		{
+			const float Distancia = FVector::DistSquared(Consultas[i], Puntos[Punto]);
+			if (Equipos[Punto] != EquiposConsulta[i] && Distancia < MejorDistancia)
+			{
+				MejorDistancia = Distancia;
+				Esperado = Punto;
+			}
+		}
+
+		const int32 Obtenido = Resultados[i];
+		if (Esperado == INDEX_NONE)
+		{
+			TestEqual(FString::Printf(TEXT("consulta %d sin objetivo"), i), Obtenido, (int32)INDEX_NONE);
+			continue;
+		}
+		if (TestNotEqual(FString::Printf(TEXT("consulta %d con objetivo"), i), Obtenido, (int32)INDEX_NONE))
+		{
+			TestNotEqual(FString::Printf(TEXT("consulta %d de otro equipo"), i), Equipos[Obtenido], EquiposConsulta[i]);
+			TestEqual(FString::Printf(TEXT("consulta %d distancia"), i), FVector::DistSquared(Consultas[i], Puntos[Obtenido]), MejorDistancia, 1e-2f);
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpatialGridRadioSegmentoTest, "Galaga.SpatialGrid.RadioYSegmento",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FSpatialGridRadioSegmentoTest::RunTest(const FString& Parameters)
+{
+	FRandomStream Azar(5678);
+	TArray<FVector> Puntos;
+	TArray<uint8> Equipos;
+	LlenarPuntos(Puntos, Equipos, 400, Azar);
+
+	FSpatialGrid Rejilla;
+	Rejilla.Configurar(1600.0f, 200.0f);
+	Rejilla.Construir(Puntos);
+
+	for (int32 i = 0; i < 100; ++i)
+	{
+		const FVector P(Azar.FRandRange(-1600.0f, 1600.0f), Azar.FRandRange(-1600.0f, 1600.0f), 200.0f);
+		const float Radio = Azar.FRandRange(50.0f, 600.0f);
+
+		TArray<int32> Obtenidos;
+		Rejilla.BuscarEnRadio(P, Radio, Obtenidos);
+		TArray<int32> Esperados;
+		for (int32 Punto = 0; Punto < Puntos.Num(); ++Punto)
+		{
+			if (FVector::DistSquared(P, Puntos[Punto]) <= Radio * Radio)
+			{
+				Esperados.Add(Punto);
+			}
+		}
+		Obtenidos.Sort();
+		TestTrue(FString::Printf(TEXT("radio %d"), i), Obtenidos == Esperados);
+	}
+
+	// Segmentos de todo tipo, tambien horizontales y verticales, que es donde cambia el recorrido por filas
+	for (int32 i = 0; i < 100; ++i)
+	{
+		const FVector A(Azar.FRandRange(-1600.0f, 1600.0f), Azar.FRandRange(-1600.0f, 1600.0f), 200.0f);
+		FVector B(Azar.FRandRange(-1600.0f, 1600.0f), Azar.FRandRange(-1600.0f, 1600.0f), 200.0f);
+		if (i % 10 == 0)
+		{
+			B.Y = A.Y;
+		}
+		else if (i % 10 == 1)
+		{
+			B.X = A.X;
+		}
+		const float Margen = Azar.FRandRange(10.0f, 150.0f);
+
+		TArray<int32> Obtenidos;
+		Rejilla.BuscarEnSegmento(A, B, Margen, Obtenidos);
+		TArray<int32> Esperados;
+		const FVector2D Delta(B.X - A.X, B.Y - A.Y);
+		for (int32 Punto = 0; Punto < Puntos.Num(); ++Punto)
+		{
+			const FVector2D Relativa(Puntos[Punto].X - A.X, Puntos[Punto].Y - A.Y);
+			const float T = Delta.SizeSquared() > 0.0f ? FMath::Clamp((Relativa | Delta) / Delta.SizeSquared(), 0.0f, 1.0f) : 0.0f;
+			if ((Relativa - Delta * T).SizeSquared() <= Margen * Margen)
+			{
+				Esperados.Add(Punto);
+			}
+		}
+		Obtenidos.Sort();
+		TestTrue(FString::Printf(TEXT("segmento %d"), i), Obtenidos == Esperados);
+	}
+	return true;
+}
+
+#endif
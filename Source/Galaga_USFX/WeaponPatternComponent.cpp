@@ -0,0 +1,160 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WeaponPatternComponent.h"
+#include "Engine/World.h"
+#include "WeaponsSubsystem.h"
+
+// Intervalo minimo entre andanadas, igual al tope de FireRate que pone DropItem
+static const float IntervaloMinimo = 0.01f;
+
+static TArray<FWeaponVolley> CrearPatron(FName Nombre)
+{
+	TArray<FWeaponVolley> Patron;
+	if (Nombre == TEXT("Simple"))
+	{
+		Patron.AddDefaulted_GetRef().Angulos = { 0.0f };
+	}
+	else if (Nombre == TEXT("Abanico3"))
+	{
+		Patron.AddDefaulted_GetRef().Angulos = { -20.0f, 0.0f, 20.0f };
+	}
+	else if (Nombre == TEXT("Abanico5"))
+	{
+		Patron.AddDefaulted_GetRef().Angulos = { -30.0f, -15.0f, 0.0f, 15.0f, 30.0f };
+	}
+	else if (Nombre == TEXT("Rafaga3"))
+	{
+		// Tres andanadas seguidas y despues la espera normal
+		for (int32 i = 0; i < 3; ++i)
+		{
+			FWeaponVolley& Andanada = Patron.AddDefaulted_GetRef();
+			Andanada.Angulos = { 0.0f };
+			Andanada.Intervalo = i == 0 ? 1.0f : 0.25f;
+		}
+	}
+	return Patron;
+}
+
+UWeaponPatternComponent::UWeaponPatternComponent()
+{
+	// Lo actualiza el pawn desde su Tick, despues de moverse
+	PrimaryComponentTick.bCanEverTick = false;
+
+	// El abanico de 3 que tenia FireShot
+	Secuencia = CrearPatron(TEXT("Abanico3"));
+	OffsetCanon = FVector(90.f, 0.f, 0.f);
+	NombreArquetipo = TEXT("Jugador");
+	MaxAndanadasPorCuadro = 16;
+	Acumulador = 0.0f;
+	Siguiente = 0;
+}
+
+void UWeaponPatternComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	Armas = GetWorld()->GetSubsystem<UWeaponsSubsystem>();
+	if (Armas)
+	{
+		Arquetipo = Armas->FindArchetype(NombreArquetipo);
+	}
+	Precalcular();
+}
+
+bool UWeaponPatternComponent::SetPatron(FName Nombre)
+{
+	TArray<FWeaponVolley> Patron = CrearPatron(Nombre);
+	if (Patron.Num() == 0)
+	{
+		return false;
+	}
+
+	Secuencia = MoveTemp(Patron);
+	Precalcular();
+	return true;
+}
+
+void UWeaponPatternComponent::SetOffsetCanon(const FVector& NuevoOffset)
+{
+	OffsetCanon = NuevoOffset;
+	Precalcular();
+}
+
+void UWeaponPatternComponent::Precalcular()
+{
+	Tabla.Reset(Secuencia.Num());
+	TablaDireccion.Reset();
+	TablaOffset.Reset();
+
+	for (const FWeaponVolley& Andanada : Secuencia)
+	{
+		FVolleyTabla& Entrada = Tabla.AddDefaulted_GetRef();
+		Entrada.Inicio = TablaDireccion.Num();
+		Entrada.Num = Andanada.Angulos.Num();
+		Entrada.Intervalo = Andanada.Intervalo;
+
+		for (float Angulo : Andanada.Angulos)
+		{
+			const FQuat Giro = FRotator(0.0f, Angulo, 0.0f).Quaternion();
+			TablaDireccion.Add(Giro.GetForwardVector());
+			TablaOffset.Add(Giro.RotateVector(OffsetCanon));
+		}
+	}
+
+	Siguiente = 0;
+}
+
+int32 UWeaponPatternComponent::Disparar(float DeltaTime, const FVector& Direccion, const FVector& OrigenAnterior, const FVector& Origen, float FireRate, int32 MaxAndanadas)
+{
+	if (Tabla.Num() == 0 || DeltaTime <= 0.0f)
+	{
+		return 0;
+	}
+
+	const float Periodo = FMath::Max(FireRate * Tabla[Siguiente].Intervalo, IntervaloMinimo);
+	if (Direccion.SizeSquared() <= 0.0f || Armas == nullptr)
+	{
+		// Sin gatillo solo se recarga hasta quedar listo; el primer disparo sale apenas se apriete
+		Acumulador = FMath::Min(Acumulador + DeltaTime, Periodo);
+		return 0;
+	}
+
+	Acumulador += DeltaTime;
+
+	const FQuat Rotacion = Direccion.Rotation().Quaternion();
+	const int32 Tope = FMath::Min(MaxAndanadas, MaxAndanadasPorCuadro);
+	int32 Andanadas = 0;
+	while (Andanadas < Tope)
+	{
+		const FVolleyTabla& Andanada = Tabla[Siguiente];
+		const float Espera = FMath::Max(FireRate * Andanada.Intervalo, IntervaloMinimo);
+		if (Acumulador < Espera)
+		{
+			break;
+		}
+		Acumulador -= Espera;
+
+		// Lo que sobra del acumulador es cuanto hace que salio esta andanada dentro del cuadro
+		const float Edad = FMath::Min(Acumulador, DeltaTime);
+		const FVector OrigenAndanada = FMath::Lerp(Origen, OrigenAnterior, Edad / DeltaTime);
+
+		for (int32 i = Andanada.Inicio; i < Andanada.Inicio + Andanada.Num; ++i)
+		{
+			const FVector Velocidad = Armas->GetVelocidad(Arquetipo, Rotacion.RotateVector(TablaDireccion[i]));
+			// Se adelanta lo que ya hubiera recorrido desde que salio
+			const FVector Posicion = OrigenAndanada + Rotacion.RotateVector(TablaOffset[i]) + Velocidad * Edad;
+			Armas->Launch(Arquetipo, Posicion, Velocidad, EBulletOwner::Jugador);
+		}
+
+		Siguiente = (Siguiente + 1) % Tabla.Num();
+		++Andanadas;
+	}
+
+	// Sin municion o en el tope no se guardan disparos para despues
+	if (Andanadas == Tope)
+	{
+		Acumulador = FMath::Min(Acumulador, FMath::Max(FireRate * Tabla[Siguiente].Intervalo, IntervaloMinimo));
+	}
+	return Andanadas;
+}
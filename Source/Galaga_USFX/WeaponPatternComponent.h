@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "ProjectileArchetype.h"
+#include "WeaponPatternComponent.generated.h"
+
+// Una andanada del patron: los angulos que salen juntos y cuanto esperar antes de ella
+USTRUCT(BlueprintType)
+struct FWeaponVolley
+{
+	GENERATED_BODY()
+
+	// Yaw en grados relativo a la direccion de disparo, uno por proyectil
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Patron")
+	TArray<float> Angulos;
+
+	// Espera antes de esta andanada, en multiplos de FireRate (rafagas: menor que 1)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Patron")
+	float Intervalo = 1.0f;
+};
+
+/**
+ * Motor de patrones de disparo del jugador. Las andanadas se precalculan en tablas
+ * (direccion y offset del canon por proyectil) y un acumulador de tiempo emite todas
+ * las que tocan en el cuadro, cada una desde donde estaba la nave en ese instante.
+ * Asi no se pierden disparos con FireRate chico o pocos FPS.
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class GALAGA_USFX_API UWeaponPatternComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UWeaponPatternComponent();
+
+	// Emite las andanadas que tocan en este cuadro y devuelve cuantas salieron.
+	// OrigenAnterior/Origen: posicion de la nave al empezar y al terminar el cuadro
+	int32 Disparar(float DeltaTime, const FVector& Direccion, const FVector& OrigenAnterior, const FVector& Origen, float FireRate, int32 MaxAndanadas);
+
+	// Cambia a uno de los patrones incluidos: Simple, Abanico3, Abanico5, Rafaga3
+	UFUNCTION(BlueprintCallable, Category = "Patron")
+	bool SetPatron(FName Nombre);
+
+	UFUNCTION(BlueprintCallable, Category = "Patron")
+	void SetOffsetCanon(const FVector& NuevoOffset);
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Patron")
+	TArray<FWeaponVolley> Secuencia;
+
+	// Distancia desde la nave a la que nacen los proyectiles (GunOffset del pawn)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Patron")
+	FVector OffsetCanon;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Patron")
+	FName NombreArquetipo;
+
+	// Tope por cuadro para que un tiron de varios segundos no vacie el cargador de golpe
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Patron")
+	int32 MaxAndanadasPorCuadro;
+
+protected:
+	virtual void BeginPlay() override;
+
+private:
+	void Precalcular();
+
+	struct FVolleyTabla
+	{
+		int32 Inicio;
+		int32 Num;
+		float Intervalo;
+	};
+
+	TArray<FVolleyTabla> Tabla;
+
+	// Por proyectil, en el espacio de la direccion de disparo
+	TArray<FVector> TablaDireccion;
+	TArray<FVector> TablaOffset;
+
+	// Tiempo desde la ultima andanada
+	float Acumulador;
+	int32 Siguiente;
+
+	FProjectileArchetypeHandle Arquetipo;
+
+	UPROPERTY()
+	class UWeaponsSubsystem* Armas;
+};
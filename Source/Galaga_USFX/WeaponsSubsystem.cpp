@@ -0,0 +1,114 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WeaponsSubsystem.h"
+#include "Galaga_USFX.h"
+#include "Engine/World.h"
+#include "ProjectilePool.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Disparos por cuadro"), STAT_Weapons_Disparos, STATGROUP_BulletField);
+
+bool UWeaponsSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World != nullptr && World->IsGameWorld();
+}
+
+void UWeaponsSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Arquetipos = Collection.InitializeDependency<UProjectileArchetypeSubsystem>();
+	Campo = Collection.InitializeDependency<UBulletFieldSubsystem>();
+	Pool = Collection.InitializeDependency<UProjectilePoolSubsystem>();
+}
+
+void UWeaponsSubsystem::Deinitialize()
+{
+	UE_LOG(LogGalaga_USFX, Log, TEXT("Disparos del nivel: %d"), Disparos);
+	Arquetipos = nullptr;
+	Campo = nullptr;
+	Pool = nullptr;
+
+	Super::Deinitialize();
+}
+
+FProjectileArchetypeHandle UWeaponsSubsystem::FindArchetype(FName Nombre) const
+{
+	return Arquetipos ? Arquetipos->FindHandle(Nombre) : FProjectileArchetypeHandle();
+}
+
+const FProjectileArchetype& UWeaponsSubsystem::GetArchetype(FProjectileArchetypeHandle Arquetipo) const
+{
+	return Arquetipos->Get(Arquetipo);
+}
+
+FVector UWeaponsSubsystem::GetVelocidad(FProjectileArchetypeHandle Arquetipo, const FVector& Direccion) const
+{
+	return Arquetipos ? Arquetipos->GetVelocidad(Arquetipo, Direccion) : FVector::ZeroVector;
+}
+
+void UWeaponsSubsystem::Launch(FProjectileArchetypeHandle Arquetipo, const FVector& Location, const FVector& Velocity, EBulletOwner Dueno)
+{
+	if (!Arquetipo.IsValid() || Arquetipos == nullptr)
+	{
+		return;
+	}
+
+	++Disparos;
+	INC_DWORD_STAT(STAT_Weapons_Disparos);
+
+	// Con el campo de balas activo el disparo es solo una entrada en sus arreglos, sin actor
+	if (Campo && UBulletFieldSubsystem::IsEnabled())
+	{
+		Campo->Spawn(Arquetipo, Location, Velocity, Dueno);
+		return;
+	}
+
+	// Si no, el actor del arquetipo sale del pool en lugar de hacer SpawnActor en cada disparo
+	if (Pool)
+	{
+		Pool->Acquire(Arquetipos->Get(Arquetipo).ClaseActor, Location, Velocity);
+	}
+}
+
+void UWeaponsSubsystem::LaunchBatch(const TArray<FVector>& Locations, const TArray<FVector>& Velocities, const TArray<uint8>& Tipos, const TArray<uint8>& Duenos)
+{
+	const int32 Cantidad = Locations.Num();
+	if (Cantidad == 0 || Arquetipos == nullptr)
+	{
+		return;
+	}
+
+	Disparos += Cantidad;
+	INC_DWORD_STAT_BY(STAT_Weapons_Disparos, Cantidad);
+
+	// El lote entra de una vez en los arreglos del campo de balas
+	if (Campo && UBulletFieldSubsystem::IsEnabled())
+	{
+		Campo->SpawnBatch(Locations, Velocities, Tipos, Duenos);
+		return;
+	}
+
+	for (int32 i = 0; Pool && i < Cantidad; ++i)
+	{
+		if (Tipos[i] < Arquetipos->Num())
+		{
+			Pool->Acquire(Arquetipos->Get(Tipos[i]).ClaseActor, Locations[i], Velocities[i]);
+		}
+	}
+}
+
+void UWeaponsSubsystem::LaunchBeam(FProjectileArchetypeHandle Arquetipo, AActor* Fuente, const FVector& Location, const FVector& Direccion, EBulletOwner Dueno)
+{
+	if (!Arquetipo.IsValid() || Fuente == nullptr || Campo == nullptr)
+	{
+		return;
+	}
+
+	++Disparos;
+	INC_DWORD_STAT(STAT_Weapons_Disparos);
+
+	// Los rayos siempre van al campo: un rayo reemplaza a la fila de balas que dispararia la nave
+	Campo->SpawnBeam(Arquetipo, Fuente, Location - Fuente->GetActorLocation(), Direccion, Dueno);
+}
@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ProjectileArchetype.h"
+#include "BulletFieldSubsystem.h"
+#include "WeaponsSubsystem.generated.h"
+
+class UProjectilePoolSubsystem;
+
+/**
+ * Servicio de disparos del nivel. Todas las naves y el jugador disparan por aqui en lugar
+ * de tener cada una su AFacadeTipoDisparo: resuelve los arquetipos y manda cada disparo al
+ * campo de balas o, si esta apagado, al pool de actores.
+ */
+UCLASS()
+class GALAGA_USFX_API UWeaponsSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+public:
+	// Resolver en BeginPlay y guardar el handle, no por disparo
+	FProjectileArchetypeHandle FindArchetype(FName Nombre) const;
+	const FProjectileArchetype& GetArchetype(FProjectileArchetypeHandle Arquetipo) const;
+
+	// Velocidad del arquetipo en la direccion dada
+	FVector GetVelocidad(FProjectileArchetypeHandle Arquetipo, const FVector& Direccion) const;
+
+	void Launch(FProjectileArchetypeHandle Arquetipo, const FVector& Location, const FVector& Velocity, EBulletOwner Dueno);
+
+	// Un lote de disparos de un cuadro (patrones de jefes); Tipos y Duenos son el indice de arquetipo y el EBulletOwner
+	void LaunchBatch(const TArray<FVector>& Locations, const TArray<FVector>& Velocities, const TArray<uint8>& Tipos, const TArray<uint8>& Duenos);
+
+	// Para arquetipos con DuracionRayo: un rayo que sale de Fuente en lugar de una bala
+	void LaunchBeam(FProjectileArchetypeHandle Arquetipo, AActor* Fuente, const FVector& Location, const FVector& Direccion, EBulletOwner Dueno);
+
+	FORCEINLINE int32 GetDisparos() const { return Disparos; }
+
+private:
+	UPROPERTY()
+	UProjectileArchetypeSubsystem* Arquetipos;
+
+	UPROPERTY()
+	UBulletFieldSubsystem* Campo;
+
+	UPROPERTY()
+	UProjectilePoolSubsystem* Pool;
+
+	// Disparos desde que empezo el nivel
+	int32 Disparos = 0;
+};
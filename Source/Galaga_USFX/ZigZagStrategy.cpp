@@ -43,12 +43,12 @@ void AZigZagStrategy::Tick(float DeltaTime)
 
 }
 
-void AZigZagStrategy::Movement(ANaveEnemiga* enemy)
+void AZigZagStrategy::Movement(ANaveEnemiga* enemy, float DeltaTime)
 {
 
 	if (enemy) {
 		//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, TEXT("ZigZagStrategy::ExecuteMovement"));
-		FVector NewLocation = enemy->GetActorLocation() + CurrentDirection * Speed * enemy->GetWorld()->DeltaTimeSeconds;
+		FVector NewLocation = enemy->GetActorLocation() + CurrentDirection * Speed * DeltaTime;
 
 		// Si la nave llega al lmite en el eje X, cambia la direccin
 		if (NewLocation.X <= -1500.0f || NewLocation.X >= 1500.0f) {
@@ -60,7 +60,7 @@ void AZigZagStrategy::Movement(ANaveEnemiga* enemy)
 		}
 
 		// Calcula la nueva ubicacin despus de cambiar la direccin
-		NewLocation = enemy->GetActorLocation() + CurrentDirection * Speed * enemy->GetWorld()->DeltaTimeSeconds;
+		NewLocation = enemy->GetActorLocation() + CurrentDirection * Speed * DeltaTime;
 
 		enemy->SetActorLocation(NewLocation);
 	}
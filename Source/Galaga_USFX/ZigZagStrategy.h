@@ -25,7 +25,7 @@ public:
 
 protected: 
 	//void ExecuteMovement(class ANameEnemiga*enemy,float DeltaTime) override;
-	virtual void Movement(class ANaveEnemiga* enemy) override;
+	virtual void Movement(class ANaveEnemiga* enemy, float DeltaTime) override;
 	virtual void ExecuteMovementPawn(class AGalaga_USFXPawn* Pawn) override;
 
 private: